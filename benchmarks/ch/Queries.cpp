@@ -0,0 +1,217 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Queries.hpp"
+
+#include <telldb/ScanQuery.hpp>
+
+#include <tellstore/Record.hpp>
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace ch {
+namespace {
+
+using PredicateType = tell::store::PredicateType;
+using TupleFunction = std::function<void(uint64_t key, const char* data)>;
+
+/**
+ * @brief Reads a fixed size field from a tuple in the storage format
+ */
+template <typename T>
+T fieldValue(const tell::store::Record& record, const char* data, Tuple::id_t id) {
+    bool isNull = false;
+    tell::store::FieldType type;
+    auto field = record.data(data, id, isNull, &type);
+    T value;
+    memcpy(&value, field, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief Scans the table with the given selection and passes every tuple to fun
+ */
+void scanTable(Transaction& tx, store::ScanMemoryManager& memoryManager, uint32_t partitions, table_t table,
+        const std::vector<Conjunct>& conjuncts, ScanResult& result, const TupleFunction& fun) {
+    std::vector<std::shared_ptr<store::ScanIterator>> scans;
+    for (uint32_t partition = 0; partition < partitions; ++partition) {
+        FullScan query(table);
+        if (partitions > 1) {
+            query.setPartition(0, partitions, partition);
+        }
+        for (auto& conjunct : conjuncts) {
+            query && conjunct;
+        }
+        scans.emplace_back(tx.scan(query, memoryManager));
+    }
+
+    for (auto& scan : scans) {
+        while (scan->hasNext()) {
+            uint64_t key;
+            const char* data;
+            size_t size;
+            std::tie(key, data, size) = scan->next();
+            ++result.tuples;
+            result.bytes += size;
+            fun(key, data);
+        }
+        if (scan->error()) {
+            throw std::system_error(scan->error());
+        }
+    }
+}
+
+/**
+ * @brief Q1: Pricing summary of all delivered order lines grouped by line number
+ */
+void query1(Transaction& tx, store::ScanMemoryManager& memoryManager, uint32_t partitions, ScanResult& result) {
+    struct Group {
+        int64_t quantity = 0;
+        double amount = 0.0;
+        uint64_t count = 0;
+    };
+
+    auto table = tx.openTable("order_line").get();
+    const auto& schema = tx.getSchema(table);
+    tell::store::Record record(schema);
+    auto numberId = schema.idOf("ol_number");
+    auto quantityId = schema.idOf("ol_quantity");
+    auto amountId = schema.idOf("ol_amount");
+    auto deliveryId = schema.idOf("ol_delivery_d");
+
+    std::map<int32_t, Group> groups;
+    scanTable(tx, memoryManager, partitions, table, {
+        Conjunct(Conjunct::Predicate(PredicateType::GREATER, deliveryId, Field(int64_t(0))))
+    }, result, [&](uint64_t, const char* data) {
+        auto& group = groups[fieldValue<int32_t>(record, data, numberId)];
+        group.quantity += fieldValue<int32_t>(record, data, quantityId);
+        group.amount += fieldValue<double>(record, data, amountId);
+        ++group.count;
+    });
+
+    for (auto& group : groups) {
+        result.checksum += double(group.second.quantity) + group.second.amount + double(group.second.count);
+    }
+}
+
+/**
+ * @brief Q6: Revenue of all order lines with a quantity between 1 and 100000
+ */
+void query6(Transaction& tx, store::ScanMemoryManager& memoryManager, uint32_t partitions, ScanResult& result) {
+    auto table = tx.openTable("order_line").get();
+    const auto& schema = tx.getSchema(table);
+    tell::store::Record record(schema);
+    auto quantityId = schema.idOf("ol_quantity");
+    auto amountId = schema.idOf("ol_amount");
+
+    double revenue = 0.0;
+    scanTable(tx, memoryManager, partitions, table, {
+        Conjunct(Conjunct::Predicate(PredicateType::GREATER_EQUAL, quantityId, Field(int32_t(1)))),
+        Conjunct(Conjunct::Predicate(PredicateType::LESS_EQUAL, quantityId, Field(int32_t(100000))))
+    }, result, [&](uint64_t, const char* data) {
+        revenue += fieldValue<double>(record, data, amountId);
+    });
+    result.checksum += revenue;
+}
+
+/**
+ * @brief Revenue of all undelivered orders per warehouse
+ *
+ * Hash join of new_order (build side) and order_line (probe side) on the order key.
+ */
+void undeliveredRevenue(Transaction& tx, store::ScanMemoryManager& memoryManager, uint32_t partitions,
+        ScanResult& result) {
+    auto newOrderTable = tx.openTable("new_order").get();
+    auto orderLineTable = tx.openTable("order_line").get();
+    const auto& schema = tx.getSchema(orderLineTable);
+    tell::store::Record record(schema);
+    auto warehouseId = schema.idOf("ol_w_id");
+    auto amountId = schema.idOf("ol_amount");
+
+    // new_order and order_line are keyed by the packed order key (order_line additionally by the line number)
+    std::unordered_set<uint64_t> newOrders;
+    scanTable(tx, memoryManager, partitions, newOrderTable, {}, result, [&newOrders](uint64_t key, const char*) {
+        newOrders.insert(key);
+    });
+
+    std::unordered_map<int32_t, double> revenue;
+    scanTable(tx, memoryManager, partitions, orderLineTable, {}, result, [&](uint64_t key, const char* data) {
+        if (newOrders.count(key >> 4) == 0) {
+            return;
+        }
+        revenue[fieldValue<int32_t>(record, data, warehouseId)] += fieldValue<double>(record, data, amountId);
+    });
+
+    for (auto& warehouse : revenue) {
+        result.checksum += warehouse.second;
+    }
+}
+
+/**
+ * @brief Number of items with a low stock per warehouse
+ */
+void lowStock(Transaction& tx, store::ScanMemoryManager& memoryManager, uint32_t partitions, ScanResult& result) {
+    auto table = tx.openTable("stock").get();
+    const auto& schema = tx.getSchema(table);
+    tell::store::Record record(schema);
+    auto warehouseId = schema.idOf("s_w_id");
+    auto quantityId = schema.idOf("s_quantity");
+
+    std::unordered_map<int32_t, uint64_t> counts;
+    scanTable(tx, memoryManager, partitions, table, {
+        Conjunct(Conjunct::Predicate(PredicateType::LESS, quantityId, Field(int32_t(15))))
+    }, result, [&](uint64_t, const char* data) {
+        ++counts[fieldValue<int32_t>(record, data, warehouseId)];
+    });
+
+    for (auto& warehouse : counts) {
+        result.checksum += double(warehouse.second);
+    }
+}
+
+} // anonymous namespace
+
+const std::vector<QueryDefinition>& queries() {
+    static const std::vector<QueryDefinition> gQueries = {
+        {"Q1", &query1},
+        {"Q6", &query6},
+        {"UndeliveredRevenue", &undeliveredRevenue},
+        {"LowStock", &lowStock},
+    };
+    return gQueries;
+}
+
+} // namespace ch
+} // namespace bench
+} // namespace db
+} // namespace tell
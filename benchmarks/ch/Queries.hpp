@@ -0,0 +1,71 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <telldb/Transaction.hpp>
+
+#include <tellstore/ScanMemory.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace ch {
+
+/**
+ * @brief Data returned by the scans of a query
+ */
+struct ScanResult {
+    /// Number of tuples received from the storage
+    uint64_t tuples = 0x0u;
+
+    /// Number of bytes received from the storage
+    uint64_t bytes = 0x0u;
+
+    /// Combination of all computed aggregates so the work of the client-side operators can not be optimized away
+    double checksum = 0.0;
+};
+
+using QueryFunction = void (*)(Transaction& tx, store::ScanMemoryManager& memoryManager, uint32_t partitions,
+        ScanResult& result);
+
+/**
+ * @brief An analytical query on the TPC-C schema in the style of the CH-benCHmark
+ *
+ * Selections are pushed down to the storage as part of a full table scan, all other operators (grouping, aggregation
+ * and joins) are executed on the client. A query with more than one partition issues one scan per partition and
+ * consumes them concurrently.
+ */
+struct QueryDefinition {
+    const char* name;
+    QueryFunction execute;
+};
+
+const std::vector<QueryDefinition>& queries();
+
+} // namespace ch
+} // namespace bench
+} // namespace db
+} // namespace tell
@@ -0,0 +1,296 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Queries.hpp"
+#include "../common/BenchConfig.hpp"
+#include "../tpcc/Populate.hpp"
+#include "../tpcc/Transactions.hpp"
+
+#include <telldb/TellDB.hpp>
+#include <telldb/Transaction.hpp>
+
+#include <crossbow/allocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace tell::db::bench;
+
+namespace {
+
+struct OltpStats {
+    uint64_t newOrders = 0x0u;
+    uint64_t committed = 0x0u;
+    uint64_t aborted = 0x0u;
+};
+
+struct QueryStats {
+    void merge(const QueryStats& other) {
+        executed += other.executed;
+        failed += other.failed;
+        tuples += other.tuples;
+        bytes += other.bytes;
+        latency.merge(other.latency);
+    }
+
+    uint64_t executed = 0x0u;
+    uint64_t failed = 0x0u;
+    uint64_t tuples = 0x0u;
+    uint64_t bytes = 0x0u;
+    LatencyRecorder latency;
+};
+
+/**
+ * @brief Utilization of the scan memory sampled during the run
+ */
+struct MemoryStats {
+    uint64_t samples = 0x0u;
+    uint64_t chunksInUse = 0x0u;
+    size_t maxChunksInUse = 0x0u;
+};
+
+struct RunOptions {
+    int32_t warehouses;
+    size_t numThreads;
+    size_t numTerminals;
+    size_t numAnalytical;
+    uint32_t partitions;
+    uint64_t duration;
+    uint64_t seed;
+};
+
+struct RunResult {
+    double elapsed = 0.0;
+    OltpStats oltp;
+    std::vector<QueryStats> queries;
+    MemoryStats memory;
+};
+
+RunResult run(tell::db::ClientManager<void>& clientManager, tell::store::ScanMemoryManager& memoryManager,
+        const RunOptions& options, size_t numAnalytical) {
+    auto& queries = ch::queries();
+    auto numTerminals = options.numThreads * options.numTerminals;
+    std::vector<OltpStats> oltpStats(numTerminals);
+    std::vector<std::vector<QueryStats>> queryStats(numAnalytical, std::vector<QueryStats>(queries.size()));
+
+    std::vector<std::thread> clients;
+    auto begin = Clock::now();
+    auto end = begin + std::chrono::seconds(options.duration);
+    for (size_t i = 0; i < numTerminals; ++i) {
+        clients.emplace_back([&clientManager, &oltpStats, &options, end, i]() {
+            tpcc::Terminal terminal(options.warehouses, static_cast<int32_t>(i % options.warehouses) + 1,
+                    options.seed + i);
+            auto& stats = oltpStats[i];
+            while (Clock::now() < end) {
+                auto kind = terminal.chooseTransaction();
+                auto result = tpcc::TransactionResult::Aborted;
+                auto fiber = clientManager.startTransaction([&terminal, &result, kind](tell::db::Transaction& tx) {
+                    result = terminal.execute(kind, tx);
+                }, tpcc::transactionType(kind), static_cast<int>(i % options.numThreads));
+                fiber.wait();
+
+                if (result == tpcc::TransactionResult::Aborted) {
+                    ++stats.aborted;
+                } else if (result == tpcc::TransactionResult::Committed) {
+                    ++stats.committed;
+                    if (kind == tpcc::TransactionKind::NewOrder) {
+                        ++stats.newOrders;
+                    }
+                }
+            }
+        });
+    }
+
+    // Every analytical client runs the queries one after the other, starting at a different query
+    for (size_t i = 0; i < numAnalytical; ++i) {
+        clients.emplace_back([&clientManager, &memoryManager, &queries, &queryStats, &options, end, i]() {
+            auto& stats = queryStats[i];
+            for (auto q = i % queries.size(); Clock::now() < end; q = (q + 1) % queries.size()) {
+                ch::ScanResult result;
+                bool failed = false;
+                auto queryBegin = Clock::now();
+                auto fiber = clientManager.startTransaction([&](tell::db::Transaction& tx) {
+                    try {
+                        queries[q].execute(tx, memoryManager, options.partitions, result);
+                        tx.commit();
+                    } catch (std::exception& e) {
+                        std::cerr << queries[q].name << " failed: " << e.what() << std::endl;
+                        failed = true;
+                        tx.rollback();
+                    }
+                }, tell::store::TransactionType::ANALYTICAL, static_cast<int>(i % options.numThreads));
+                fiber.wait();
+
+                auto& query = stats[q];
+                if (failed) {
+                    ++query.failed;
+                    continue;
+                }
+                ++query.executed;
+                query.tuples += result.tuples;
+                query.bytes += result.bytes;
+                query.latency.record(Clock::now() - queryBegin);
+            }
+        });
+    }
+
+    RunResult result;
+#ifdef TELLDB_LOCAL_STORE
+    // Sample the utilization of the scan memory until all clients are done
+    while (Clock::now() < end) {
+        auto chunks = memoryManager.chunksInUse();
+        ++result.memory.samples;
+        result.memory.chunksInUse += chunks;
+        result.memory.maxChunksInUse = std::max(result.memory.maxChunksInUse, chunks);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+#endif
+
+    for (auto& client : clients) {
+        client.join();
+    }
+    result.elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    for (auto& stats : oltpStats) {
+        result.oltp.newOrders += stats.newOrders;
+        result.oltp.committed += stats.committed;
+        result.oltp.aborted += stats.aborted;
+    }
+    result.queries.resize(queries.size());
+    for (auto& stats : queryStats) {
+        for (size_t q = 0; q < queries.size(); ++q) {
+            result.queries[q].merge(stats[q]);
+        }
+    }
+    return result;
+}
+
+void printOltp(const char* name, const RunResult& result) {
+    auto attempts = result.oltp.committed + result.oltp.aborted;
+    std::cout << name << ": tpmC=" << std::fixed << std::setprecision(1)
+              << double(result.oltp.newOrders) * 60.0 / result.elapsed
+              << " committed=" << result.oltp.committed << " aborted=" << result.oltp.aborted << " abort-rate="
+              << std::setprecision(2)
+              << (attempts == 0 ? 0.0 : 100.0 * double(result.oltp.aborted) / double(attempts)) << "%" << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    crossbow::string commitManager;
+    crossbow::string storageNodes;
+    uint64_t latency = 0;
+    RunOptions options;
+    options.warehouses = 1;
+    options.numThreads = 2;
+    options.numTerminals = 2;
+    options.numAnalytical = 1;
+    options.partitions = 1;
+    options.duration = 60;
+    options.seed = 0;
+    size_t chunkCount = 64;
+    size_t chunkLength = 0x100000u;
+    bool baseline = false;
+    bool populateData = false;
+    auto opts = create_options("ch_bench",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'c'>("commit-manager", &commitManager, tag::description{"Address to the commit manager"}),
+            value<'s'>("storage-nodes", &storageNodes, tag::description{"Semicolon-separated list of storage node addresses"}),
+            value<'l'>("latency", &latency, tag::description{"Simulated round trip time in microseconds (local store only)"}),
+            value<'W'>("warehouses", &options.warehouses, tag::description{"Number of warehouses"}),
+            value<'t'>("threads", &options.numThreads, tag::description{"Number of client threads"}),
+            value<'f'>("fibers", &options.numTerminals, tag::description{"Number of TPC-C terminals per thread"}),
+            value<'a'>("analytical", &options.numAnalytical, tag::description{"Number of analytical clients"}),
+            value<'P'>("partitions", &options.partitions, tag::description{"Number of concurrent scans per table"}),
+            value<'m'>("chunk-count", &chunkCount, tag::description{"Number of chunks of the scan memory"}),
+            value<'M'>("chunk-length", &chunkLength, tag::description{"Size of a chunk of the scan memory in bytes"}),
+            value<'d'>("duration", &options.duration, tag::description{"Duration of every run in seconds"}),
+            value<'b'>("baseline", &baseline, tag::description{"Run the OLTP load alone first to measure interference"}),
+            value<'p'>("populate", &populateData, tag::description{"Create and populate the database before the run"}),
+            value<'r'>("seed", &options.seed, tag::description{"Seed of the random number generators"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+    if (options.warehouses <= 0 || options.numThreads == 0 || options.partitions == 0) {
+        print_help(std::cout, opts);
+        return 1;
+    }
+
+    crossbow::allocator::init();
+
+    auto config = createClientConfig(commitManager, storageNodes, options.numThreads, latency);
+    tell::db::ClientManager<void> clientManager(config);
+    auto memoryManager = clientManager.newScanMemoryManager(chunkCount, chunkLength);
+
+    if (populateData) {
+        auto begin = Clock::now();
+        tpcc::populateDatabase(clientManager, options.warehouses, options.numThreads * options.numTerminals,
+                options.seed);
+        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin);
+        std::cout << "Populated " << options.warehouses << " warehouses in " << time.count() << "ms" << std::endl;
+    }
+
+    std::cout << options.warehouses << " warehouses with " << options.numThreads << " threads x "
+              << options.numTerminals << " terminals and " << options.numAnalytical << " analytical clients"
+              << std::endl;
+
+    if (baseline) {
+        auto result = run(clientManager, *memoryManager, options, 0);
+        printOltp("OLTP only", result);
+    }
+
+    auto result = run(clientManager, *memoryManager, options, options.numAnalytical);
+    printOltp("OLTP with analytics", result);
+    auto& queries = ch::queries();
+    for (size_t q = 0; q < queries.size(); ++q) {
+        auto& stats = result.queries[q];
+        std::cout << queries[q].name << ": executed=" << stats.executed << " failed=" << stats.failed
+                  << std::fixed << std::setprecision(1)
+                  << " rows/s=" << double(stats.tuples) / result.elapsed
+                  << " MB/s=" << double(stats.bytes) / result.elapsed / (1024.0 * 1024.0) << std::endl;
+        printLatency(std::cout, queries[q].name, stats.latency);
+    }
+#ifdef TELLDB_LOCAL_STORE
+    auto& memory = result.memory;
+    std::cout << "Scan memory: mean=" << std::fixed << std::setprecision(2)
+              << (memory.samples == 0 ? 0.0 : double(memory.chunksInUse) / double(memory.samples))
+              << " max=" << memory.maxChunksInUse << " of " << memoryManager->chunkCount() << " chunks in use"
+              << std::endl;
+#endif
+    return 0;
+}
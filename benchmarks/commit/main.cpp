@@ -0,0 +1,293 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "../common/BenchConfig.hpp"
+#include "../common/Statistics.hpp"
+
+#include <telldb/CommitStats.hpp>
+#include <telldb/TellDB.hpp>
+#include <telldb/Transaction.hpp>
+
+#include <crossbow/allocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace tell::db;
+using namespace tell::db::bench;
+
+namespace {
+
+/**
+ * @brief Phase breakdown of all commits of one configuration
+ */
+struct PhaseStats {
+    void record(const CommitProfile& profile, Clock::duration total) {
+        undoLog.record(profile.undoLog);
+        writeUndoLog.record(profile.writeUndoLog);
+        writeBack.record(profile.writeBack);
+        writeIndexes.record(profile.writeIndexes);
+        removeUndoLog.record(profile.removeUndoLog);
+        commit.record(profile.commit);
+        this->total.record(total);
+        undoLogSize += profile.undoLogSize;
+        undoLogChunks += profile.undoLogChunks;
+    }
+
+    void print(std::ostream& out) {
+        printLatency(out, "  undo-log", undoLog);
+        printLatency(out, "  write-undo-log", writeUndoLog);
+        printLatency(out, "  write-back", writeBack);
+        printLatency(out, "  write-indexes", writeIndexes);
+        printLatency(out, "  remove-undo-log", removeUndoLog);
+        printLatency(out, "  commit-manager", commit);
+        printLatency(out, "  total", total);
+        auto count = std::max(total.count(), size_t(1));
+        out << "  undo log: " << (undoLogSize / count) << " bytes " << (double(undoLogChunks) / double(count))
+            << " chunks per commit" << std::endl;
+    }
+
+    LatencyRecorder undoLog;
+    LatencyRecorder writeUndoLog;
+    LatencyRecorder writeBack;
+    LatencyRecorder writeIndexes;
+    LatencyRecorder removeUndoLog;
+    LatencyRecorder commit;
+    LatencyRecorder total;
+    uint64_t undoLogSize = 0;
+    uint64_t undoLogChunks = 0;
+};
+
+/**
+ * @brief Prints the statistics collected by the client manager over all configurations
+ */
+void printCommitStats(std::ostream& out, const CommitStats& stats) {
+    out << "all commits (client manager statistics)" << std::endl;
+    for (size_t i = 0; i < gCommitPhaseCount; ++i) {
+        auto& histogram = stats.phases[i];
+        out << "  " << commitPhaseName(static_cast<CommitPhase>(i)) << ": count=" << histogram.count()
+            << " mean=" << (histogram.mean() / 1000.0) << "us p50=" << (histogram.percentile(50) / 1000.0)
+            << "us p99=" << (histogram.percentile(99) / 1000.0) << "us" << std::endl;
+    }
+}
+
+/**
+ * @brief Writes transactions of varying size to a set of tables with the same number of indexes each
+ *
+ * Every table has one INT field per index holding a unique value and a TEXT payload. The rows written by a transaction
+ * are distributed round-robin over all tables.
+ */
+class CommitBenchmark {
+public:
+    CommitBenchmark(ClientManager<void>& clientManager, uint64_t tableCount, uint64_t indexCount,
+            uint32_t payloadSize)
+            : mClientManager(clientManager),
+              mIndexCount(indexCount),
+              mPayload(payloadSize, 'x'),
+              mPrefix("commit_bench_t" + boost::lexical_cast<crossbow::string>(tableCount) + "_i"
+                    + boost::lexical_cast<crossbow::string>(indexCount)),
+              mNextKey(0) {
+        for (uint64_t i = 0; i < tableCount; ++i) {
+            mTableNames.emplace_back(mPrefix + "_" + boost::lexical_cast<crossbow::string>(i));
+        }
+        for (uint64_t i = 0; i < indexCount; ++i) {
+            mFieldNames.emplace_back("f" + boost::lexical_cast<crossbow::string>(i));
+        }
+    }
+
+    void createSchema();
+
+    /**
+     * @brief Inserts the given number of new rows per transaction
+     *
+     * @return First key of the inserted rows of every repetition
+     */
+    std::vector<uint64_t> insert(uint64_t writeSetSize, uint64_t repetitions, PhaseStats& stats);
+
+    /**
+     * @brief Updates all fields of the rows previously inserted by insert
+     */
+    void update(const std::vector<uint64_t>& firstKeys, uint64_t writeSetSize, PhaseStats& stats);
+
+private:
+    template <typename Fun>
+    void execute(Fun fun) {
+        auto fiber = mClientManager.startTransaction(fun);
+        fiber.wait();
+    }
+
+    ClientManager<void>& mClientManager;
+    uint64_t mIndexCount;
+    crossbow::string mPayload;
+    crossbow::string mPrefix;
+    std::vector<crossbow::string> mTableNames;
+    std::vector<crossbow::string> mFieldNames;
+    uint64_t mNextKey;
+};
+
+void CommitBenchmark::createSchema() {
+    execute([this](Transaction& tx) {
+        for (const auto& tableName : mTableNames) {
+            tell::store::Schema schema(tell::store::TableType::TRANSACTIONAL);
+            for (const auto& fieldName : mFieldNames) {
+                schema.addField(tell::store::FieldType::INT, fieldName, true);
+            }
+            schema.addField(tell::store::FieldType::TEXT, "payload", true);
+            for (const auto& fieldName : mFieldNames) {
+                schema.addIndex(tableName + "_" + fieldName + "_idx",
+                        std::make_pair(true, std::vector<tell::store::Schema::id_t>{schema.idOf(fieldName)}));
+            }
+            tx.createTable(tableName, schema);
+        }
+        tx.commit();
+    });
+}
+
+std::vector<uint64_t> CommitBenchmark::insert(uint64_t writeSetSize, uint64_t repetitions, PhaseStats& stats) {
+    std::vector<uint64_t> firstKeys;
+    for (uint64_t r = 0; r < repetitions; ++r) {
+        auto firstKey = mNextKey;
+        mNextKey += writeSetSize;
+        firstKeys.emplace_back(firstKey);
+        execute([this, firstKey, writeSetSize, &stats](Transaction& tx) {
+            std::vector<table_t> tables;
+            for (const auto& tableName : mTableNames) {
+                tables.emplace_back(tx.openTable(tableName).get());
+            }
+            std::unordered_map<crossbow::string, Field> values;
+            values.emplace("payload", mPayload);
+            for (auto key = firstKey; key < firstKey + writeSetSize; ++key) {
+                for (const auto& fieldName : mFieldNames) {
+                    values[fieldName] = Field(static_cast<int32_t>(key));
+                }
+                tx.insert(tables[key % tables.size()], tell::db::key_t{key}, values);
+            }
+            auto begin = Clock::now();
+            tx.commit();
+            stats.record(tx.commitProfile(), Clock::now() - begin);
+        });
+    }
+    return firstKeys;
+}
+
+void CommitBenchmark::update(const std::vector<uint64_t>& firstKeys, uint64_t writeSetSize, PhaseStats& stats) {
+    for (auto firstKey : firstKeys) {
+        execute([this, firstKey, writeSetSize, &stats](Transaction& tx) {
+            std::vector<table_t> tables;
+            for (const auto& tableName : mTableNames) {
+                tables.emplace_back(tx.openTable(tableName).get());
+            }
+            std::vector<Future<Tuple>> tuples;
+            tuples.reserve(writeSetSize);
+            for (auto key = firstKey; key < firstKey + writeSetSize; ++key) {
+                tuples.emplace_back(tx.get(tables[key % tables.size()], tell::db::key_t{key}));
+            }
+            for (uint64_t i = 0; i < writeSetSize; ++i) {
+                auto key = firstKey + i;
+                const auto& tuple = tuples[i].get();
+                auto next = tuple;
+                // Negated values keep the index entries unique while moving every one of them
+                for (const auto& fieldName : mFieldNames) {
+                    next.at(fieldName) = -static_cast<int32_t>(key) - 1;
+                }
+                tx.update(tables[key % tables.size()], tell::db::key_t{key}, tuple, next);
+            }
+            auto begin = Clock::now();
+            tx.commit();
+            stats.record(tx.commitProfile(), Clock::now() - begin);
+        });
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    crossbow::string commitManager;
+    crossbow::string storageNodes;
+    uint64_t latency = 0;
+    crossbow::string writeSetSizes = "1,10,100,1000,10000";
+    crossbow::string tableCounts = "1,4";
+    crossbow::string indexCounts = "0,1,4";
+    uint32_t payloadSize = 100;
+    uint64_t repetitions = 20;
+    bool updates = false;
+    auto opts = create_options("commit_bench",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'c'>("commit-manager", &commitManager, tag::description{"Address to the commit manager"}),
+            value<'s'>("storage-nodes", &storageNodes, tag::description{"Semicolon-separated list of storage nodes"}),
+            value<'l'>("latency", &latency, tag::description{"Simulated round trip time in microseconds (local only)"}),
+            value<'w'>("write-set-sizes", &writeSetSizes,
+                    tag::description{"Comma-separated list of rows written per transaction"}),
+            value<'T'>("tables", &tableCounts, tag::description{"Comma-separated list of tables written to"}),
+            value<'I'>("indexes", &indexCounts, tag::description{"Comma-separated list of indexes per table"}),
+            value<'P'>("payload-size", &payloadSize, tag::description{"Size of the payload field in bytes"}),
+            value<'R'>("repetitions", &repetitions, tag::description{"Number of transactions per configuration"}),
+            value<'u'>("updates", &updates, tag::description{"Also measure updates of the inserted rows"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+
+    crossbow::allocator::init();
+
+    auto config = createClientConfig(commitManager, storageNodes, 1, latency);
+    ClientManager<void> clientManager(config);
+    clientManager.enableCommitStats();
+
+    for (auto tableCount : parseList(tableCounts)) {
+        for (auto indexCount : parseList(indexCounts)) {
+            CommitBenchmark benchmark(clientManager, tableCount, indexCount, payloadSize);
+            benchmark.createSchema();
+            for (auto writeSetSize : parseList(writeSetSizes)) {
+                PhaseStats insertStats;
+                auto firstKeys = benchmark.insert(writeSetSize, repetitions, insertStats);
+                std::cout << "insert tables=" << tableCount << " indexes=" << indexCount << " rows=" << writeSetSize
+                          << std::endl;
+                insertStats.print(std::cout);
+                if (updates) {
+                    PhaseStats updateStats;
+                    benchmark.update(firstKeys, writeSetSize, updateStats);
+                    std::cout << "update tables=" << tableCount << " indexes=" << indexCount << " rows="
+                              << writeSetSize << std::endl;
+                    updateStats.print(std::cout);
+                }
+            }
+        }
+    }
+    printCommitStats(std::cout, clientManager.commitStats());
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <tellstore/ClientConfig.hpp>
+
+#include <crossbow/string.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace tell {
+namespace db {
+namespace bench {
+
+/**
+ * @brief Creates the client configuration shared by all benchmarks
+ *
+ * Benchmarks linked against telldb connect to the given commit manager and storage nodes. Benchmarks linked against
+ * telldb-local (TELLDB_LOCAL_STORE is defined) run on the in-process stand-in where the storage nodes only determine
+ * the number of simulated nodes and every request takes the given round trip time.
+ */
+inline tell::store::ClientConfig createClientConfig(const crossbow::string& commitManager,
+        const crossbow::string& storageNodes, size_t numThreads, uint64_t latencyUs) {
+    tell::store::ClientConfig config;
+    config.commitManager = config.parseCommitManager(commitManager);
+    config.tellStore = config.parseTellStore(storageNodes);
+    config.numNetworkThreads = numThreads;
+#ifdef TELLDB_LOCAL_STORE
+    config.local.setLatency(std::chrono::microseconds(latencyUs));
+#else
+    (void) latencyUs;
+#endif
+    return config;
+}
+
+/**
+ * @brief Parses a comma-separated list of numbers as used by the parameter sweeps of the benchmarks
+ */
+inline std::vector<uint64_t> parseList(const crossbow::string& str) {
+    std::vector<uint64_t> result;
+    size_t i = 0;
+    while (i < str.size()) {
+        auto pos = str.find(',', i);
+        if (pos == crossbow::string::npos) {
+            pos = str.size();
+        }
+        result.emplace_back(boost::lexical_cast<uint64_t>(str.substr(i, pos - i)));
+        i = pos + 1;
+    }
+    return result;
+}
+
+} // namespace bench
+} // namespace db
+} // namespace tell
@@ -0,0 +1,95 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "KeyChooser.hpp"
+
+#include <cmath>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace {
+
+double zeta(uint64_t n, double theta) {
+    double sum = 0.0;
+    for (uint64_t i = 1; i <= n; ++i) {
+        sum += 1.0 / std::pow(double(i), theta);
+    }
+    return sum;
+}
+
+uint64_t fnvHash(uint64_t value) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value & 0xFFu);
+        hash *= 0x100000001B3ull;
+        value >>= 8;
+    }
+    return hash;
+}
+
+} // anonymous namespace
+
+KeyChooser::~KeyChooser() = default;
+
+uint64_t UniformChooser::next(Random& rng) const {
+    std::uniform_int_distribution<uint64_t> dist(0, mItems - 1);
+    return dist(rng);
+}
+
+constexpr double ZipfianChooser::DEFAULT_THETA;
+
+ZipfianChooser::ZipfianChooser(uint64_t items, double theta)
+        : mItems(items),
+          mTheta(theta),
+          mAlpha(1.0 / (1.0 - theta)),
+          mZetaN(zeta(items, theta)),
+          mEta((1.0 - std::pow(2.0 / double(items), 1.0 - theta)) / (1.0 - zeta(2, theta) / mZetaN)) {
+}
+
+uint64_t ZipfianChooser::next(Random& rng) const {
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    auto u = dist(rng);
+    auto uz = u * mZetaN;
+    if (uz < 1.0) {
+        return 0;
+    }
+    if (uz < 1.0 + std::pow(0.5, mTheta)) {
+        return (mItems > 1 ? 1 : 0);
+    }
+    auto result = static_cast<uint64_t>(double(mItems) * std::pow(mEta * u - mEta + 1.0, mAlpha));
+    return (result < mItems ? result : mItems - 1);
+}
+
+uint64_t ScrambledZipfianChooser::next(Random& rng) const {
+    return fnvHash(mZipfian.next(rng)) % mItems;
+}
+
+uint64_t LatestChooser::next(Random& rng) const {
+    auto bound = mBound.load();
+    auto distance = mZipfian.next(rng) % bound;
+    return bound - 1 - distance;
+}
+
+} // namespace bench
+} // namespace db
+} // namespace tell
@@ -0,0 +1,121 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+
+namespace tell {
+namespace db {
+namespace bench {
+
+using Random = std::mt19937_64;
+
+/**
+ * @brief Chooses keys from the range [0, items)
+ *
+ * Key choosers are immutable after construction and can be shared between clients, every client passes its own random
+ * number generator.
+ */
+class KeyChooser {
+public:
+    virtual ~KeyChooser();
+
+    virtual uint64_t next(Random& rng) const = 0;
+};
+
+class UniformChooser : public KeyChooser {
+public:
+    UniformChooser(uint64_t items)
+            : mItems(items) {
+    }
+
+    virtual uint64_t next(Random& rng) const override;
+
+private:
+    uint64_t mItems;
+};
+
+/**
+ * @brief Zipfian distributed keys where 0 is the most popular key
+ *
+ * Implements the algorithm from "Quickly Generating Billion-Record Synthetic Databases" by Gray et al. as used by YCSB.
+ */
+class ZipfianChooser : public KeyChooser {
+public:
+    static constexpr double DEFAULT_THETA = 0.99;
+
+    ZipfianChooser(uint64_t items, double theta = DEFAULT_THETA);
+
+    virtual uint64_t next(Random& rng) const override;
+
+private:
+    uint64_t mItems;
+    double mTheta;
+    double mAlpha;
+    double mZetaN;
+    double mEta;
+};
+
+/**
+ * @brief Zipfian distributed keys with the popular keys spread over the whole key range
+ */
+class ScrambledZipfianChooser : public KeyChooser {
+public:
+    ScrambledZipfianChooser(uint64_t items, double theta = ZipfianChooser::DEFAULT_THETA)
+            : mItems(items),
+              mZipfian(items, theta) {
+    }
+
+    virtual uint64_t next(Random& rng) const override;
+
+private:
+    uint64_t mItems;
+    ZipfianChooser mZipfian;
+};
+
+/**
+ * @brief Prefers the most recently inserted keys
+ *
+ * The upper bound of the key range is read from the given counter so keys inserted during the run are considered. The
+ * distance to the newest key is zipfian distributed over the initial number of items.
+ */
+class LatestChooser : public KeyChooser {
+public:
+    LatestChooser(const std::atomic<uint64_t>& bound, uint64_t items,
+            double theta = ZipfianChooser::DEFAULT_THETA)
+            : mBound(bound),
+              mZipfian(items, theta) {
+    }
+
+    virtual uint64_t next(Random& rng) const override;
+
+private:
+    const std::atomic<uint64_t>& mBound;
+    ZipfianChooser mZipfian;
+};
+
+} // namespace bench
+} // namespace db
+} // namespace tell
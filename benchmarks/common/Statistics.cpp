@@ -0,0 +1,53 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Statistics.hpp"
+
+#include <iomanip>
+#include <ostream>
+
+namespace tell {
+namespace db {
+namespace bench {
+
+void printLatency(std::ostream& out, const char* name, const LatencyRecorder& recorder) {
+    printHistogram(out, name, recorder.histogram());
+}
+
+void printHistogram(std::ostream& out, const char* name, const LatencyHistogram& histogram) {
+    auto us = [](double ns) {
+        return ns / 1000.0;
+    };
+    out << std::fixed << std::setprecision(1)
+        << name << ": count=" << histogram.count()
+        << " mean=" << us(histogram.mean())
+        << "us p50=" << us(histogram.percentile(50.0))
+        << "us p90=" << us(histogram.percentile(90.0))
+        << "us p99=" << us(histogram.percentile(99.0))
+        << "us p99.9=" << us(histogram.percentile(99.9))
+        << "us p99.99=" << us(histogram.percentile(99.99))
+        << "us max=" << us(histogram.max()) << "us" << std::endl;
+}
+
+} // namespace bench
+} // namespace db
+} // namespace tell
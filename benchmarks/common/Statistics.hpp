@@ -0,0 +1,77 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <telldb/LatencyHistogram.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+namespace tell {
+namespace db {
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Collects latency samples of a single client
+ *
+ * Every client records into its own recorder, the recorders are merged after the run. Samples are counted in a
+ * LatencyHistogram, so the memory does not grow with the length of the run.
+ */
+class LatencyRecorder {
+public:
+    void record(Clock::duration latency) {
+        mHistogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+    }
+
+    void merge(const LatencyRecorder& other) {
+        mHistogram.merge(other.mHistogram);
+    }
+
+    size_t count() const {
+        return static_cast<size_t>(mHistogram.count());
+    }
+
+    const LatencyHistogram& histogram() const {
+        return mHistogram;
+    }
+
+private:
+    LatencyHistogram mHistogram;
+};
+
+/**
+ * @brief Prints the latencies recorded like printHistogram
+ */
+void printLatency(std::ostream& out, const char* name, const LatencyRecorder& recorder);
+
+/**
+ * @brief Prints count, mean and the 50th, 90th, 99th, 99.9th, 99.99th percentile and maximum in microseconds
+ */
+void printHistogram(std::ostream& out, const char* name, const LatencyHistogram& histogram);
+
+} // namespace bench
+} // namespace db
+} // namespace tell
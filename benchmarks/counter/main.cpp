@@ -0,0 +1,193 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "../common/BenchConfig.hpp"
+#include "../common/Statistics.hpp"
+
+#include <telldb/Metrics.hpp>
+#include <telldb/TellDB.hpp>
+#include <telldb/Transaction.hpp>
+#include <telldb/WaitStats.hpp>
+
+#include <crossbow/allocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace tell::db;
+using namespace tell::db::bench;
+
+namespace {
+
+/**
+ * @brief Configuration of a single run
+ */
+struct CounterConfig {
+    uint64_t threads;
+    uint64_t fibers;
+    uint64_t batchSize;
+    uint64_t counters;
+};
+
+/**
+ * @brief Draws keys from remote counters with all fibers of all threads at the same time
+ *
+ * Every fiber runs one transaction drawing the given number of keys from one of the counters, the fibers are assigned
+ * to the counters round-robin. Every run uses a new client manager and new counters so the statistics of the client
+ * manager only cover the run and every thread starts without reserved keys.
+ */
+class CounterBenchmark {
+public:
+    CounterBenchmark(tell::store::ClientConfig config, uint64_t keysPerFiber)
+            : mConfig(std::move(config)),
+              mKeysPerFiber(keysPerFiber),
+              mRun(0) {
+    }
+
+    void run(const CounterConfig& counterConfig);
+
+private:
+    tell::store::ClientConfig mConfig;
+    uint64_t mKeysPerFiber;
+    uint64_t mRun;
+};
+
+void CounterBenchmark::run(const CounterConfig& counterConfig) {
+    mConfig.numNetworkThreads = counterConfig.threads;
+    ClientManager<void> clientManager(mConfig);
+    clientManager.setCounterBatchSize(counterConfig.batchSize);
+    clientManager.enableWaitProfiling();
+
+    // The counter rows have to exist before the clients race for them
+    std::vector<crossbow::string> names;
+    for (uint64_t i = 0; i < counterConfig.counters; ++i) {
+        names.emplace_back("counter_bench_" + boost::lexical_cast<crossbow::string>(mRun) + "_"
+                + boost::lexical_cast<crossbow::string>(i));
+    }
+    ++mRun;
+    auto createFiber = clientManager.startTransaction([&names](Transaction& tx) {
+        for (auto& name : names) {
+            tx.createCounter(name).next();
+        }
+        tx.commit();
+    });
+    createFiber.wait();
+    auto metricsBefore = clientManager.metrics();
+    auto waitsBefore = clientManager.waitStats();
+
+    auto keysPerFiber = mKeysPerFiber;
+    std::vector<TransactionFiber<void>> fibers;
+    auto begin = Clock::now();
+    for (uint64_t i = 0; i < counterConfig.threads * counterConfig.fibers; ++i) {
+        auto& name = names[i % names.size()];
+        fibers.emplace_back(clientManager.startTransaction([&name, keysPerFiber](Transaction& tx) {
+            auto counter = tx.getCounter(name);
+            for (uint64_t j = 0; j < keysPerFiber; ++j) {
+                counter.next();
+            }
+            tx.commit();
+        }, tell::store::TransactionType::READ_WRITE, static_cast<int>(i % counterConfig.threads)));
+    }
+    for (auto& fiber : fibers) {
+        fiber.wait();
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    auto metrics = clientManager.metrics();
+    auto waits = clientManager.waitStats();
+    auto delta = [&metrics, &metricsBefore](Metric metric) {
+        return metrics[metric] - metricsBefore[metric];
+    };
+    auto waitTime = [&waits, &waitsBefore](WaitSite site) {
+        auto& after = waits.site(site);
+        auto& before = waitsBefore.site(site);
+        return (after.mean() * double(after.count()) - before.mean() * double(before.count())) / 1e9;
+    };
+    auto keys = counterConfig.threads * counterConfig.fibers * mKeysPerFiber;
+    auto refills = delta(Metric::CounterRefills);
+    std::cout << std::setw(8) << counterConfig.threads << std::setw(8) << counterConfig.fibers << std::setw(8)
+              << counterConfig.batchSize << std::setw(9) << counterConfig.counters << std::fixed
+              << std::setprecision(0) << std::setw(13) << double(keys) / elapsed << std::setw(9) << refills
+              << std::setw(9) << delta(Metric::CounterRetries) << std::setw(9) << delta(Metric::CounterStalls)
+              << std::setprecision(3) << std::setw(12) << waitTime(WaitSite::Counter) * 1000.0 << std::setw(12)
+              << waitTime(WaitSite::CounterRefill) * 1000.0 << std::setw(11)
+              << (refills == 0 ? 0.0 : double(delta(Metric::CounterRetries)) / double(refills)) << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    crossbow::string commitManager;
+    crossbow::string storageNodes;
+    uint64_t latency = 0;
+    crossbow::string threadCounts = "1,2,4";
+    crossbow::string fiberCounts = "1,4,16";
+    crossbow::string batchSizes = "10,100,1000";
+    crossbow::string counterCounts = "1,16";
+    uint64_t keysPerFiber = 10000;
+    auto opts = create_options("counter_bench",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'c'>("commit-manager", &commitManager, tag::description{"Address to the commit manager"}),
+            value<'s'>("storage-nodes", &storageNodes, tag::description{"Semicolon-separated list of storage nodes"}),
+            value<'l'>("latency", &latency, tag::description{"Simulated round trip time in microseconds (local only)"}),
+            value<'t'>("threads", &threadCounts, tag::description{"Comma-separated list of client threads"}),
+            value<'f'>("fibers", &fiberCounts, tag::description{"Comma-separated list of fibers per thread"}),
+            value<'b'>("batch-sizes", &batchSizes, tag::description{"Comma-separated list of keys reserved at once"}),
+            value<'C'>("counters", &counterCounts, tag::description{"Comma-separated list of counters to share"}),
+            value<'k'>("keys", &keysPerFiber, tag::description{"Number of keys drawn by every fiber"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+
+    crossbow::allocator::init();
+
+    CounterBenchmark benchmark(createClientConfig(commitManager, storageNodes, 1, latency), keysPerFiber);
+    std::cout << std::setw(8) << "threads" << std::setw(8) << "fibers" << std::setw(8) << "batch" << std::setw(9)
+              << "counters" << std::setw(13) << "keys/s" << std::setw(9) << "refills" << std::setw(9) << "retries"
+              << std::setw(9) << "stalls" << std::setw(12) << "stall-ms" << std::setw(12) << "refill-ms"
+              << std::setw(11) << "retry-rate" << std::endl;
+    for (auto counters : parseList(counterCounts)) {
+        for (auto batchSize : parseList(batchSizes)) {
+            for (auto threads : parseList(threadCounts)) {
+                for (auto fibers : parseList(fiberCounts)) {
+                    benchmark.run(CounterConfig{threads, fibers, batchSize, counters});
+                }
+            }
+        }
+    }
+    return 0;
+}
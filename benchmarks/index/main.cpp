@@ -0,0 +1,382 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "../common/BenchConfig.hpp"
+#include "../common/KeyChooser.hpp"
+#include "../common/Statistics.hpp"
+
+#include <telldb/TellDB.hpp>
+#include <telldb/Transaction.hpp>
+
+#include <tellstore/LocalStorage.hpp>
+
+#include <crossbow/allocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace tell::db;
+using namespace tell::db::bench;
+
+namespace {
+
+constexpr uint64_t gPopulateBatchSize = 1000;
+
+/// Number of rows sharing the same index key in non-unique indexes
+constexpr uint64_t gDuplicates = 4;
+
+/// Keeps the compiler from optimizing away lookup results
+volatile uint64_t gSink = 0;
+
+/**
+ * @brief Index configuration under test
+ *
+ * The index key consists of width INT fields followed by an optional TEXT field of the given length.
+ */
+struct IndexConfig {
+    bool unique;
+    uint32_t width;
+    uint32_t textLength;
+
+    crossbow::string tableName() const {
+        return crossbow::string("index_bench_") + (unique ? "u" : "n") + boost::lexical_cast<crossbow::string>(width)
+                + "_" + boost::lexical_cast<crossbow::string>(textLength);
+    }
+
+    crossbow::string indexName() const {
+        return tableName() + "_idx";
+    }
+};
+
+/**
+ * @brief Reads of the Bd-Tree node and pointer tables served by the local storage
+ */
+struct NodeReads {
+    static NodeReads read(tell::store::local::Storage& storage, const crossbow::string& indexName) {
+        using tell::store::local::Operation;
+        return NodeReads{storage.requestCount("__index_nodes_" + indexName, Operation::Get),
+                storage.requestCount("__index_ptrs_" + indexName, Operation::Get)};
+    }
+
+    NodeReads operator-(const NodeReads& other) const {
+        return NodeReads{nodes - other.nodes, pointers - other.pointers};
+    }
+
+    uint64_t nodes;
+    uint64_t pointers;
+};
+
+class IndexBenchmark {
+public:
+    IndexBenchmark(ClientManager<void>& clientManager, tell::store::local::Storage& storage, const IndexConfig& config,
+            uint64_t rowCount)
+            : mClientManager(clientManager),
+              mStorage(storage),
+              mConfig(config),
+              mRowCount(rowCount),
+              mTableName(config.tableName()),
+              mIndexName(config.indexName()),
+              mNextRow(rowCount) {
+    }
+
+    void populate();
+
+    /**
+     * @brief Inserts and erases rows in transactions of the given size
+     *
+     * Measures buffering of the index operations in the write cache, iteration over the merged cache and Bd-Tree and
+     * the write-back of the cache on commit.
+     */
+    void modify(uint64_t txSize);
+
+    void pointLookups(uint64_t count, Random& rng);
+
+    void rangeScans(uint64_t length, uint64_t count, Random& rng);
+
+private:
+    template <typename Fun>
+    void execute(Fun fun) {
+        auto fiber = mClientManager.startTransaction(fun);
+        fiber.wait();
+    }
+
+    KeyType indexKey(uint64_t row) const;
+
+    std::unordered_map<crossbow::string, Field> rowValues(uint64_t row) const;
+
+    void report(const char* phase, uint64_t param, uint64_t ops, Clock::duration duration, const NodeReads& reads);
+
+    ClientManager<void>& mClientManager;
+    tell::store::local::Storage& mStorage;
+    IndexConfig mConfig;
+    uint64_t mRowCount;
+    crossbow::string mTableName;
+    crossbow::string mIndexName;
+    uint64_t mNextRow;
+};
+
+void IndexBenchmark::populate() {
+    execute([this](Transaction& tx) {
+        tell::store::Schema schema(tell::store::TableType::TRANSACTIONAL);
+        std::vector<tell::store::Schema::id_t> fields;
+        for (uint32_t i = 0; i < mConfig.width; ++i) {
+            auto name = "k" + boost::lexical_cast<crossbow::string>(i);
+            schema.addField(tell::store::FieldType::INT, name, true);
+        }
+        if (mConfig.textLength != 0) {
+            schema.addField(tell::store::FieldType::TEXT, "ktext", true);
+        }
+        schema.addField(tell::store::FieldType::TEXT, "payload", true);
+        for (uint32_t i = 0; i < mConfig.width; ++i) {
+            fields.emplace_back(schema.idOf("k" + boost::lexical_cast<crossbow::string>(i)));
+        }
+        if (mConfig.textLength != 0) {
+            fields.emplace_back(schema.idOf("ktext"));
+        }
+        schema.addIndex(mIndexName, std::make_pair(mConfig.unique, std::move(fields)));
+        tx.createTable(mTableName, schema);
+        tx.commit();
+    });
+
+    auto before = NodeReads::read(mStorage, mIndexName);
+    auto begin = Clock::now();
+    for (uint64_t row = 0; row < mRowCount; row += gPopulateBatchSize) {
+        auto end = std::min(row + gPopulateBatchSize, mRowCount);
+        execute([this, row, end](Transaction& tx) {
+            auto table = tx.openTable(mTableName).get();
+            for (auto i = row; i < end; ++i) {
+                tx.insert(table, tell::db::key_t{i}, rowValues(i));
+            }
+            tx.commit();
+        });
+    }
+    report("populate", gPopulateBatchSize, mRowCount, Clock::now() - begin,
+            NodeReads::read(mStorage, mIndexName) - before);
+}
+
+void IndexBenchmark::modify(uint64_t txSize) {
+    auto firstRow = mNextRow;
+    mNextRow += txSize;
+
+    Clock::duration insertTime, iterateTime, commitTime;
+    NodeReads iterateReads, commitReads;
+    uint64_t iterated = 0;
+    execute([&](Transaction& tx) {
+        auto table = tx.openTable(mTableName).get();
+        auto begin = Clock::now();
+        for (auto row = firstRow; row < firstRow + txSize; ++row) {
+            tx.insert(table, tell::db::key_t{row}, rowValues(row));
+        }
+        insertTime = Clock::now() - begin;
+
+        // Iterate from the end of the populated rows over all buffered inserts
+        auto before = NodeReads::read(mStorage, mIndexName);
+        begin = Clock::now();
+        auto startRow = (mRowCount > txSize ? mRowCount - txSize : 0);
+        for (auto iter = tx.lower_bound(table, mIndexName, indexKey(startRow)); !iter.done(); iter.next()) {
+            ++iterated;
+        }
+        iterateTime = Clock::now() - begin;
+        iterateReads = NodeReads::read(mStorage, mIndexName) - before;
+
+        before = NodeReads::read(mStorage, mIndexName);
+        begin = Clock::now();
+        tx.commit();
+        commitTime = Clock::now() - begin;
+        commitReads = NodeReads::read(mStorage, mIndexName) - before;
+    });
+    report("insert-buffer", txSize, txSize, insertTime, NodeReads{0, 0});
+    report("merge-iterate", txSize, iterated, iterateTime, iterateReads);
+    report("insert-writeback", txSize, txSize, commitTime, commitReads);
+
+    Clock::duration eraseTime;
+    execute([&](Transaction& tx) {
+        auto table = tx.openTable(mTableName).get();
+        std::vector<Future<Tuple>> tuples;
+        for (auto row = firstRow; row < firstRow + txSize; ++row) {
+            tuples.emplace_back(tx.get(table, tell::db::key_t{row}));
+        }
+        auto begin = Clock::now();
+        for (uint64_t i = 0; i < txSize; ++i) {
+            tx.remove(table, tell::db::key_t{firstRow + i}, tuples[i].get());
+        }
+        eraseTime = Clock::now() - begin;
+
+        auto before = NodeReads::read(mStorage, mIndexName);
+        begin = Clock::now();
+        tx.commit();
+        commitTime = Clock::now() - begin;
+        commitReads = NodeReads::read(mStorage, mIndexName) - before;
+    });
+    report("erase-buffer", txSize, txSize, eraseTime, NodeReads{0, 0});
+    report("erase-writeback", txSize, txSize, commitTime, commitReads);
+}
+
+void IndexBenchmark::pointLookups(uint64_t count, Random& rng) {
+    UniformChooser chooser(mRowCount);
+    Clock::duration time;
+    NodeReads reads;
+    execute([&](Transaction& tx) {
+        auto table = tx.openTable(mTableName).get();
+        auto before = NodeReads::read(mStorage, mIndexName);
+        auto begin = Clock::now();
+        for (uint64_t i = 0; i < count; ++i) {
+            auto iter = tx.lower_bound(table, mIndexName, indexKey(chooser.next(rng)));
+            if (!iter.done()) {
+                gSink = gSink + iter.value().value;
+            }
+        }
+        time = Clock::now() - begin;
+        reads = NodeReads::read(mStorage, mIndexName) - before;
+        tx.commit();
+    }, tell::store::TransactionType::READ_ONLY);
+    report("point-lookup", 1, count, time, reads);
+}
+
+void IndexBenchmark::rangeScans(uint64_t length, uint64_t count, Random& rng) {
+    UniformChooser chooser(mRowCount);
+    Clock::duration time;
+    NodeReads reads;
+    uint64_t entries = 0;
+    execute([&](Transaction& tx) {
+        auto table = tx.openTable(mTableName).get();
+        auto before = NodeReads::read(mStorage, mIndexName);
+        auto begin = Clock::now();
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t n = 0;
+            for (auto iter = tx.lower_bound(table, mIndexName, indexKey(chooser.next(rng))); !iter.done() && n < length;
+                    iter.next()) {
+                ++n;
+            }
+            entries += n;
+        }
+        time = Clock::now() - begin;
+        reads = NodeReads::read(mStorage, mIndexName) - before;
+        tx.commit();
+    }, tell::store::TransactionType::READ_ONLY);
+    report("range-scan", length, entries, time, reads);
+}
+
+KeyType IndexBenchmark::indexKey(uint64_t row) const {
+    auto value = (mConfig.unique ? row : row / gDuplicates);
+    KeyType key;
+    key.emplace_back(static_cast<int32_t>(value));
+    for (uint32_t i = 1; i < mConfig.width; ++i) {
+        key.emplace_back(static_cast<int32_t>(value % (i + 1)));
+    }
+    if (mConfig.textLength != 0) {
+        key.emplace_back(crossbow::string(mConfig.textLength, static_cast<char>('a' + value % 26)));
+    }
+    return key;
+}
+
+std::unordered_map<crossbow::string, Field> IndexBenchmark::rowValues(uint64_t row) const {
+    std::unordered_map<crossbow::string, Field> values;
+    auto key = indexKey(row);
+    for (uint32_t i = 0; i < mConfig.width; ++i) {
+        values.emplace("k" + boost::lexical_cast<crossbow::string>(i), key[i]);
+    }
+    if (mConfig.textLength != 0) {
+        values.emplace("ktext", key.back());
+    }
+    values.emplace("payload", crossbow::string(16, 'p'));
+    return values;
+}
+
+void IndexBenchmark::report(const char* phase, uint64_t param, uint64_t ops, Clock::duration duration,
+        const NodeReads& reads) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    auto perOp = [ops](double value) {
+        return (ops == 0 ? 0.0 : value / double(ops));
+    };
+    std::cout << std::left << std::setw(24) << mTableName << std::setw(18) << phase << std::right << std::setw(8)
+              << param << std::setw(10) << ops << std::fixed << std::setprecision(1) << std::setw(12)
+              << perOp(double(ns)) << " ns/op" << std::setprecision(3) << std::setw(10) << perOp(double(reads.nodes))
+              << " node-reads/op" << std::setw(10) << perOp(double(reads.pointers)) << " ptr-reads/op" << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    uint64_t latency = 0;
+    uint64_t rowCount = 100000;
+    crossbow::string txSizes = "1,10,100,1000";
+    crossbow::string widths = "1,2,4";
+    uint32_t textLength = 0;
+    crossbow::string scanLengths = "1,10,100,1000";
+    uint64_t lookups = 1000;
+    uint64_t seed = 0;
+    auto opts = create_options("index_bench",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'l'>("latency", &latency, tag::description{"Simulated round trip time in microseconds"}),
+            value<'n'>("rows", &rowCount, tag::description{"Number of rows in every index"}),
+            value<'T'>("tx-sizes", &txSizes, tag::description{"Comma-separated list of modifications per transaction"}),
+            value<'k'>("key-widths", &widths, tag::description{"Comma-separated list of INT fields per index key"}),
+            value<'K'>("text-length", &textLength, tag::description{"Length of an additional TEXT key field (0 for none)"}),
+            value<'S'>("scan-lengths", &scanLengths, tag::description{"Comma-separated list of range scan lengths"}),
+            value<'q'>("lookups", &lookups, tag::description{"Number of lookups and scans per measurement"}),
+            value<'r'>("seed", &seed, tag::description{"Seed of the random number generator"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+
+    crossbow::allocator::init();
+
+    auto config = createClientConfig("", "", 1, latency);
+    auto storage = std::make_shared<tell::store::local::Storage>(1);
+    config.storage = storage;
+    ClientManager<void> clientManager(config);
+
+    Random rng(seed);
+    for (auto unique : {true, false}) {
+        for (auto width : parseList(widths)) {
+            IndexBenchmark benchmark(clientManager, *storage, IndexConfig{unique, static_cast<uint32_t>(width),
+                    textLength}, rowCount);
+            benchmark.populate();
+            for (auto txSize : parseList(txSizes)) {
+                benchmark.modify(txSize);
+            }
+            benchmark.pointLookups(lookups, rng);
+            for (auto length : parseList(scanLengths)) {
+                benchmark.rangeScans(length, lookups, rng);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,304 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "../common/Statistics.hpp"
+#include "FieldSerialize.hpp"
+
+#include <telldb/Field.hpp>
+#include <telldb/ScanQuery.hpp>
+#include <telldb/Tuple.hpp>
+
+#include <tellstore/Record.hpp>
+#include <tellstore/Table.hpp>
+
+#include <crossbow/ChunkAllocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+/*
+ * Every call to the global operator new is counted, allocations served by the chunk memory pool of a transaction are
+ * not.
+ */
+namespace {
+
+std::atomic<uint64_t> gAllocations(0);
+
+} // anonymous namespace
+
+void* operator new(size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+namespace tell {
+namespace db {
+namespace bench {
+
+/**
+ * @brief Gives the benchmarks access to the serialization of a ScanQuery, which is private to Transaction
+ */
+class ScanQueryBenchmark {
+public:
+    static void serializeSelection(const ScanQuery& query, std::unique_ptr<char[]>& result, uint32_t& size) {
+        query.serializeSelection(result, size);
+    }
+};
+
+} // namespace bench
+} // namespace db
+} // namespace tell
+
+using namespace crossbow::program_options;
+using namespace tell::db;
+using namespace tell::db::bench;
+
+namespace {
+
+/// Recreate the memory pool after this many operations so it does not grow without bounds
+constexpr uint64_t gPoolOperations = 1024;
+
+volatile uint64_t gSink = 0;
+
+struct SchemaConfig {
+    const char* name;
+    uint32_t fixedFields;
+    uint32_t varFields;
+    bool nullable;
+};
+
+const SchemaConfig gSchemas[] = {
+    {"narrow-fixed", 4, 0, false},
+    {"narrow-var", 2, 2, false},
+    {"narrow-nullable", 2, 2, true},
+    {"wide-fixed", 32, 0, false},
+    {"wide-var", 16, 16, false},
+    {"wide-nullable", 16, 16, true},
+};
+
+const tell::store::FieldType gFixedTypes[] = {
+    tell::store::FieldType::INT,
+    tell::store::FieldType::BIGINT,
+    tell::store::FieldType::DOUBLE,
+    tell::store::FieldType::SMALLINT,
+    tell::store::FieldType::FLOAT,
+};
+
+tell::store::Schema createSchema(const SchemaConfig& config) {
+    tell::store::Schema schema(tell::store::TableType::TRANSACTIONAL);
+    for (uint32_t i = 0; i < config.fixedFields; ++i) {
+        auto type = gFixedTypes[i % (sizeof(gFixedTypes) / sizeof(gFixedTypes[0]))];
+        schema.addField(type, crossbow::string("fixed") + boost::lexical_cast<crossbow::string>(i), !config.nullable);
+    }
+    for (uint32_t i = 0; i < config.varFields; ++i) {
+        schema.addField(tell::store::FieldType::TEXT, crossbow::string("var") + boost::lexical_cast<crossbow::string>(i),
+                !config.nullable);
+    }
+    return schema;
+}
+
+Field createField(tell::store::FieldType type, uint32_t seed, uint32_t textLength) {
+    switch (type) {
+    case tell::store::FieldType::SMALLINT:
+        return Field(static_cast<int16_t>(seed));
+    case tell::store::FieldType::INT:
+        return Field(static_cast<int32_t>(seed));
+    case tell::store::FieldType::BIGINT:
+        return Field(static_cast<int64_t>(seed) << 20);
+    case tell::store::FieldType::FLOAT:
+        return Field(static_cast<float>(seed) / 3.0f);
+    case tell::store::FieldType::DOUBLE:
+        return Field(static_cast<double>(seed) / 7.0);
+    default:
+        return Field(crossbow::string(textLength, static_cast<char>('a' + (seed % 26))));
+    }
+}
+
+/**
+ * @brief Fills all fields of the tuple, every other field is NULL if the schema is nullable
+ */
+void fillTuple(Tuple& tuple, const tell::store::Record& record, bool nullable, uint32_t seed, uint32_t textLength) {
+    for (Tuple::id_t i = 0; i < tuple.count(); ++i) {
+        if (nullable && (i % 2) == 1) {
+            tuple[i] = nullptr;
+        } else {
+            tuple[i] = createField(record.schema()[i].type(), seed + i, textLength);
+        }
+    }
+}
+
+template <typename Fun>
+void run(const char* schema, const char* name, uint64_t iterations, uint64_t opsPerIteration, Fun fun) {
+    // Warm up caches and the allocator
+    for (uint64_t i = 0; i < std::min<uint64_t>(iterations / 10, 10000); ++i) {
+        fun(i);
+    }
+
+    auto allocations = gAllocations.load();
+    auto begin = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        fun(i);
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+    allocations = gAllocations.load() - allocations;
+
+    auto ops = double(iterations * opsPerIteration);
+    std::cout << std::left << std::setw(16) << schema << std::setw(24) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << double(duration) / ops << " ns/op"
+              << std::setw(10) << double(allocations) / ops << " allocs/op" << std::endl;
+}
+
+void runSchema(const SchemaConfig& config, uint64_t iterations, uint32_t textLength) {
+    tell::store::Record record(createSchema(config));
+    std::unique_ptr<crossbow::ChunkMemoryPool> pool(new crossbow::ChunkMemoryPool());
+
+    Tuple tuple(record, *pool);
+    fillTuple(tuple, record, config.nullable, 1, textLength);
+    Tuple other(record, *pool);
+    fillTuple(other, record, config.nullable, 2, textLength);
+
+    auto size = tuple.size();
+    std::unique_ptr<char[]> buffer(new char[size]);
+    tuple.serialize(buffer.get());
+    auto storeTuple = tell::store::Tuple::create(1, true, buffer.get(), size);
+
+    // Tuple
+    run(config.name, "tuple-from-store", iterations, 1, [&record, &pool, &storeTuple](uint64_t i) {
+        if (i % gPoolOperations == 0) {
+            pool.reset(new crossbow::ChunkMemoryPool());
+        }
+        Tuple result(record, *storeTuple, *pool);
+        gSink += result.count();
+    });
+    pool.reset(new crossbow::ChunkMemoryPool());
+    run(config.name, "tuple-size", iterations, 1, [&tuple](uint64_t) {
+        gSink += tuple.size();
+    });
+    run(config.name, "tuple-serialize", iterations, 1, [&tuple, &buffer](uint64_t) {
+        tuple.serialize(buffer.get());
+        gSink += static_cast<uint8_t>(buffer[0]);
+    });
+
+    // Field
+    std::vector<Tuple::id_t> nonNull;
+    for (Tuple::id_t i = 0; i < tuple.count(); ++i) {
+        if (!tuple[i].null()) {
+            nonNull.push_back(i);
+        }
+    }
+    run(config.name, "field-copy", iterations, nonNull.size(), [&tuple, &nonNull](uint64_t) {
+        for (auto id : nonNull) {
+            Field copy(tuple[id]);
+            gSink += static_cast<uint64_t>(copy.type());
+        }
+    });
+    run(config.name, "field-compare", iterations, nonNull.size(), [&tuple, &other, &nonNull](uint64_t) {
+        for (auto id : nonNull) {
+            gSink += (tuple[id] < other[id] ? 1 : 0);
+        }
+    });
+
+    // FieldSerialize - encodes all fields the way index keys are written to the undo log
+    KeyType key;
+    for (Tuple::id_t i = 0; i < tuple.count(); ++i) {
+        key.push_back(tuple[i]);
+    }
+    crossbow::sizer sizer;
+    sizer & key;
+    std::unique_ptr<uint8_t[]> keyBuffer(new uint8_t[sizer.size]);
+    run(config.name, "field-serialize", iterations, key.size(), [&key, &keyBuffer](uint64_t) {
+        crossbow::sizer s;
+        s & key;
+        crossbow::serializer ser(keyBuffer.get());
+        ser & key;
+        ser.buffer.release();
+        gSink += s.size;
+    });
+
+    // ScanQuery - one conjunct per non-NULL field
+    FullScan query(table_t{0});
+    for (auto id : nonNull) {
+        query && Conjunct(Conjunct::Predicate(tell::store::PredicateType::GREATER_EQUAL, id, tuple[id]));
+    }
+    run(config.name, "selection-serialize", iterations, 1, [&query](uint64_t) {
+        std::unique_ptr<char[]> selection;
+        uint32_t length;
+        ScanQueryBenchmark::serializeSelection(query, selection, length);
+        gSink += length;
+    });
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    crossbow::string schemaName;
+    uint64_t iterations = 1000000;
+    uint32_t textLength = 16;
+    auto opts = create_options("telldb_microbench",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'s'>("schema", &schemaName, tag::description{"Only run the given schema (default: all)"}),
+            value<'n'>("iterations", &iterations, tag::description{"Number of iterations per benchmark"}),
+            value<'L'>("text-length", &textLength, tag::description{"Length of TEXT fields in bytes"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+
+    bool found = false;
+    for (auto& config : gSchemas) {
+        if (!schemaName.empty() && schemaName != config.name) {
+            continue;
+        }
+        found = true;
+        runSchema(config, iterations, textLength);
+    }
+    if (!found) {
+        std::cerr << "Unknown schema " << schemaName << std::endl;
+        return 1;
+    }
+    return 0;
+}
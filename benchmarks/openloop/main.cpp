@@ -0,0 +1,356 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "../common/BenchConfig.hpp"
+#include "../common/Statistics.hpp"
+#include "../ycsb/Workload.hpp"
+
+#include <telldb/TellDB.hpp>
+#include <telldb/Transaction.hpp>
+
+#include <crossbow/allocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace tell::db::bench;
+
+namespace {
+
+using Fiber = tell::db::TransactionFiber<void>;
+
+constexpr uint64_t gPopulateBatchSize = 1000;
+
+enum class Arrival {
+    Fixed,
+    Poisson,
+};
+
+Arrival parseArrival(const crossbow::string& name) {
+    if (name == "fixed") {
+        return Arrival::Fixed;
+    }
+    if (name == "poisson") {
+        return Arrival::Poisson;
+    }
+    throw std::invalid_argument("Unknown arrival process");
+}
+
+/**
+ * @brief State of one generator and the transactions it issued
+ *
+ * All transactions of a generator execute on the same processor, the stats are only touched by the fibers of that
+ * processor and read after the generator finished.
+ */
+struct Generator {
+    explicit Generator(uint64_t seed)
+            : rng(seed),
+              completed(0) {
+    }
+
+    Random rng;
+    ycsb::ClientStats stats;
+
+    /// Latency from the intended start time of the transaction
+    tell::db::LatencyHistogram responseTime;
+
+    /// Latency from the actual start of the transaction
+    tell::db::LatencyHistogram serviceTime;
+
+    std::atomic<uint64_t> completed;
+};
+
+/**
+ * @brief Waits for issued transactions in the background
+ *
+ * Latencies are recorded inside the transactions, the reaper only releases the fibers once they finished so the
+ * generator never blocks on a running transaction.
+ */
+class Reaper {
+public:
+    Reaper()
+            : mDone(false),
+              mThread([this]() { run(); }) {
+    }
+
+    ~Reaper() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDone = true;
+        }
+        mCond.notify_one();
+        mThread.join();
+    }
+
+    void add(Fiber&& fiber) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFibers.emplace_back(std::move(fiber));
+        }
+        mCond.notify_one();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mCond.wait(lock, [this]() { return mDone || !mFibers.empty(); });
+            if (mFibers.empty()) {
+                return;
+            }
+            auto fiber = std::move(mFibers.front());
+            mFibers.pop_front();
+            lock.unlock();
+            fiber.wait();
+            lock.lock();
+        }
+    }
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    std::deque<Fiber> mFibers;
+    bool mDone;
+    std::thread mThread;
+};
+
+struct LoadResult {
+    double offered = 0.0;
+    double elapsed = 0.0;
+    uint64_t issued = 0x0u;
+    uint64_t maxInFlight = 0x0u;
+    ycsb::ClientStats stats;
+    tell::db::LatencyHistogram responseTime;
+    tell::db::LatencyHistogram serviceTime;
+};
+
+/**
+ * @brief Issues transactions at the given total rate for the given duration
+ *
+ * Every processor gets its own generator thread issuing rate / numThreads transactions per second. The intended start
+ * time of a transaction is determined by the arrival process alone: if the generator falls behind it issues the
+ * overdue transactions immediately and their latency includes the time they were delayed. A generator stalls when it
+ * has maxInFlight transactions outstanding, the offered load is then not sustainable.
+ */
+LoadResult runLoad(tell::db::ClientManager<void>& clientManager, ycsb::Workload& workload, double rate,
+        Arrival arrival, uint64_t duration, size_t numThreads, uint64_t maxInFlight, uint64_t seed) {
+    auto txType = (workload.spec().readOnly() ? tell::store::TransactionType::READ_ONLY
+                                              : tell::store::TransactionType::READ_WRITE);
+    std::vector<std::unique_ptr<Generator>> generators;
+    for (size_t i = 0; i < numThreads; ++i) {
+        generators.emplace_back(new Generator(seed + i));
+    }
+    std::vector<uint64_t> issued(numThreads, 0x0u);
+    std::vector<uint64_t> peak(numThreads, 0x0u);
+
+    std::vector<std::thread> threads;
+    auto begin = Clock::now();
+    auto end = begin + std::chrono::seconds(duration);
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&, i]() {
+            auto& generator = *generators[i];
+            Random arrivalRng(seed + numThreads + i);
+            std::exponential_distribution<double> exponential(rate / double(numThreads));
+            auto interval = std::chrono::duration<double>(double(numThreads) / rate);
+
+            Reaper reaper;
+            auto intended = begin;
+            while (intended < end) {
+                if (issued[i] - generator.completed.load() >= maxInFlight) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::this_thread::sleep_until(intended);
+
+                auto start = intended;
+                reaper.add(clientManager.startTransaction([&workload, &generator, start](tell::db::Transaction& tx) {
+                    auto actualStart = Clock::now();
+                    workload.execute(tx, generator.rng, generator.stats);
+                    auto now = Clock::now();
+                    generator.responseTime.record(static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count()));
+                    generator.serviceTime.record(static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(now - actualStart).count()));
+                    ++generator.completed;
+                }, txType, static_cast<int>(i)));
+                ++issued[i];
+                peak[i] = std::max(peak[i], issued[i] - generator.completed.load());
+
+                auto next = (arrival == Arrival::Fixed ? interval
+                                                       : std::chrono::duration<double>(exponential(arrivalRng)));
+                intended += std::chrono::duration_cast<Clock::duration>(next);
+            }
+            // The reaper waits for all outstanding transactions on destruction
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    LoadResult result;
+    result.offered = rate;
+    result.elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    for (size_t i = 0; i < numThreads; ++i) {
+        result.issued += issued[i];
+        result.maxInFlight = std::max(result.maxInFlight, peak[i]);
+        result.stats.merge(generators[i]->stats);
+        result.responseTime.merge(generators[i]->responseTime);
+        result.serviceTime.merge(generators[i]->serviceTime);
+    }
+    return result;
+}
+
+void populate(tell::db::ClientManager<void>& clientManager, const ycsb::Workload& workload, uint64_t recordCount) {
+    auto createFiber = clientManager.startTransaction([&workload](tell::db::Transaction& tx) {
+        workload.createSchema(tx);
+        tx.commit();
+    });
+    createFiber.wait();
+
+    Random rng(0);
+    for (uint64_t begin = 0; begin < recordCount; begin += gPopulateBatchSize) {
+        auto end = std::min(begin + gPopulateBatchSize, recordCount);
+        auto fiber = clientManager.startTransaction([&workload, &rng, begin, end](tell::db::Transaction& tx) {
+            workload.populate(tx, begin, end, rng);
+        });
+        fiber.wait();
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    crossbow::string commitManager;
+    crossbow::string storageNodes;
+    uint64_t latency = 0;
+    crossbow::string workloadName = "A";
+    crossbow::string distributionName;
+    uint64_t recordCount = 10000;
+    uint32_t fieldCount = 10;
+    uint32_t fieldLength = 100;
+    uint32_t opsPerTransaction = 1;
+    uint32_t maxScanLength = 100;
+    size_t numThreads = 2;
+    crossbow::string rates = "1000,2000,5000,10000";
+    crossbow::string arrivalName = "poisson";
+    uint64_t maxInFlight = 10000;
+    uint64_t duration = 10;
+    bool populateData = false;
+    uint64_t seed = 0;
+    auto opts = create_options("ycsb_openloop",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'c'>("commit-manager", &commitManager, tag::description{"Address to the commit manager"}),
+            value<'s'>("storage-nodes", &storageNodes, tag::description{"Semicolon-separated list of storage node addresses"}),
+            value<'l'>("latency", &latency, tag::description{"Simulated round trip time in microseconds (local store only)"}),
+            value<'w'>("workload", &workloadName, tag::description{"YCSB core workload (A-F)"}),
+            value<'k'>("key-distribution", &distributionName, tag::description{"uniform, zipfian or latest (default depends on the workload)"}),
+            value<'n'>("records", &recordCount, tag::description{"Number of records"}),
+            value<'F'>("field-count", &fieldCount, tag::description{"Number of fields per record"}),
+            value<'L'>("field-length", &fieldLength, tag::description{"Length of every field in bytes"}),
+            value<'o'>("ops-per-tx", &opsPerTransaction, tag::description{"Operations per transaction"}),
+            value<'S'>("scan-length", &maxScanLength, tag::description{"Maximum number of records per scan"}),
+            value<'t'>("threads", &numThreads, tag::description{"Number of client threads"}),
+            value<'R'>("rates", &rates, tag::description{"Comma-separated list of offered loads in transactions per second"}),
+            value<'a'>("arrival", &arrivalName, tag::description{"Arrival process: fixed or poisson"}),
+            value<'m'>("max-in-flight", &maxInFlight, tag::description{"Maximum outstanding transactions per thread"}),
+            value<'d'>("duration", &duration, tag::description{"Duration of every load level in seconds"}),
+            value<'p'>("populate", &populateData, tag::description{"Create and populate the usertable before the run"}),
+            value<'r'>("seed", &seed, tag::description{"Seed of the random number generators"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+    if (workloadName.size() != 1 || recordCount == 0 || fieldCount == 0 || opsPerTransaction == 0
+            || maxScanLength == 0 || numThreads == 0 || maxInFlight == 0) {
+        print_help(std::cout, opts);
+        return 1;
+    }
+
+    auto spec = ycsb::WorkloadSpec::core(workloadName[0]);
+    auto distribution = (distributionName.empty() ? spec.distribution : ycsb::parseDistribution(distributionName));
+    ycsb::Workload workload(spec, distribution, recordCount, fieldCount, fieldLength, opsPerTransaction,
+            maxScanLength);
+    auto arrival = parseArrival(arrivalName);
+
+    crossbow::allocator::init();
+
+    auto config = createClientConfig(commitManager, storageNodes, numThreads, latency);
+    tell::db::ClientManager<void> clientManager(config);
+
+    if (populateData) {
+        auto begin = Clock::now();
+        populate(clientManager, workload, recordCount);
+        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin);
+        std::cout << "Populated " << recordCount << " records in " << time.count() << "ms" << std::endl;
+    }
+
+    std::cout << "Workload " << workload.spec().name << " with " << numThreads << " threads, " << arrivalName
+              << " arrivals" << std::endl;
+    std::vector<LoadResult> results;
+    for (auto rate : parseList(rates)) {
+        if (rate == 0) {
+            continue;
+        }
+        auto result = runLoad(clientManager, workload, double(rate), arrival, duration, numThreads, maxInFlight,
+                seed);
+        std::cout << "Offered " << rate << " tx/s: achieved " << std::fixed << std::setprecision(1)
+                  << double(result.stats.committed) / result.elapsed << " tx/s committed=" << result.stats.committed
+                  << " aborted=" << result.stats.aborted << " max-in-flight=" << result.maxInFlight
+                  << (result.maxInFlight >= maxInFlight ? " (saturated)" : "") << std::endl;
+        printHistogram(std::cout, "  Response time", result.responseTime);
+        printHistogram(std::cout, "  Service time", result.serviceTime);
+        results.emplace_back(std::move(result));
+    }
+
+    // Throughput / latency curve
+    std::cout << std::endl << "offered,achieved,p50_us,p99_us,p99.9_us,max_us" << std::endl;
+    for (auto& result : results) {
+        auto& histogram = result.responseTime;
+        std::cout << std::fixed << std::setprecision(1) << result.offered << ","
+                  << double(result.stats.committed) / result.elapsed << ","
+                  << double(histogram.percentile(50.0)) / 1000.0 << ","
+                  << double(histogram.percentile(99.0)) / 1000.0 << ","
+                  << double(histogram.percentile(99.9)) / 1000.0 << ","
+                  << double(histogram.max()) / 1000.0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,339 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "../common/BenchConfig.hpp"
+#include "../common/Statistics.hpp"
+
+#include <telldb/Exceptions.hpp>
+#include <telldb/TellDB.hpp>
+#include <telldb/Trace.hpp>
+#include <telldb/Transaction.hpp>
+
+#include <crossbow/allocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace tell::db;
+using namespace tell::db::bench;
+
+namespace {
+
+using Fiber = TransactionFiber<void>;
+
+/**
+ * @brief Counters of the transactions replayed on one processor
+ *
+ * Only touched by the fibers of the processor and read after all transactions finished.
+ */
+struct ReplayStats {
+    void merge(const ReplayStats& other) {
+        committed += other.committed;
+        rolledBack += other.rolledBack;
+        aborted += other.aborted;
+        divergent += other.divergent;
+        missing += other.missing;
+        skipped += other.skipped;
+        responseTime.merge(other.responseTime);
+        originalTime.merge(other.originalTime);
+    }
+
+    uint64_t committed = 0x0u;
+    uint64_t rolledBack = 0x0u;
+    uint64_t aborted = 0x0u;
+    /// Transactions whose replay committed or aborted while the original did the opposite
+    uint64_t divergent = 0x0u;
+    /// Operations on tuples that did not exist during the replay
+    uint64_t missing = 0x0u;
+    /// Operations that can not be replayed (scans)
+    uint64_t skipped = 0x0u;
+    LatencyHistogram responseTime;
+    LatencyHistogram originalTime;
+};
+
+/**
+ * @brief Thrown when a replayed operation depends on a tuple that does not exist
+ */
+struct MissingTuple {
+};
+
+void fill(Tuple& tuple, const std::vector<Field>& values) {
+    for (Tuple::id_t i = 0; i < values.size() && i < tuple.count(); ++i) {
+        tuple[i] = values[i];
+    }
+}
+
+const Tuple& getTuple(Transaction& tx, table_t table, uint64_t key) {
+    try {
+        return tx.get(table, tell::db::key_t{key}).get();
+    } catch (std::range_error&) {
+        throw MissingTuple();
+    }
+}
+
+/**
+ * @brief Executes the operations of a traced transaction
+ *
+ * Tables are resolved by name, written tuples get the recorded field values. Range queries advance the iterator as
+ * often as the original transaction did.
+ */
+TraceOutcome replay(Transaction& tx, const TraceTransaction& trace, ReplayStats& stats) {
+    std::vector<table_t> tables;
+    for (const auto& name : trace.tables) {
+        tables.emplace_back(tx.openTable(name).get());
+    }
+
+    for (const auto& entry : trace.entries) {
+        auto table = tables.at(entry.table);
+        switch (entry.operation) {
+        case TraceOperation::Get: {
+            try {
+                getTuple(tx, table, entry.key);
+            } catch (MissingTuple&) {
+                ++stats.missing;
+            }
+        } break;
+        case TraceOperation::Insert: {
+            auto tuple = tx.newTuple(table);
+            fill(tuple, entry.values);
+            tx.insert(table, tell::db::key_t{entry.key}, tuple);
+        } break;
+        case TraceOperation::Update: {
+            const auto& from = getTuple(tx, table, entry.key);
+            auto to = tx.newTuple(table);
+            fill(to, entry.values);
+            tx.update(table, tell::db::key_t{entry.key}, from, to);
+        } break;
+        case TraceOperation::Remove: {
+            const auto& tuple = getTuple(tx, table, entry.key);
+            tx.remove(table, tell::db::key_t{entry.key}, tuple);
+        } break;
+        case TraceOperation::LowerBound:
+        case TraceOperation::ReverseLowerBound: {
+            auto iter = (entry.operation == TraceOperation::LowerBound
+                    ? tx.lower_bound(table, entry.index, entry.values)
+                    : tx.reverse_lower_bound(table, entry.index, entry.values));
+            for (uint64_t i = 0; i < entry.advanced && !iter.done(); ++i) {
+                iter.next();
+            }
+        } break;
+        case TraceOperation::Scan: {
+            ++stats.skipped;
+        } break;
+        }
+    }
+
+    if (trace.outcome == TraceOutcome::RolledBack) {
+        tx.rollback();
+        return TraceOutcome::RolledBack;
+    }
+    tx.commit();
+    return TraceOutcome::Committed;
+}
+
+/**
+ * @brief Waits for issued transactions in the background so the dispatcher never blocks
+ */
+class Reaper {
+public:
+    Reaper()
+            : mDone(false),
+              mThread([this]() { run(); }) {
+    }
+
+    ~Reaper() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDone = true;
+        }
+        mCond.notify_one();
+        mThread.join();
+    }
+
+    void add(Fiber&& fiber) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFibers.emplace_back(std::move(fiber));
+        }
+        mCond.notify_one();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mCond.wait(lock, [this]() { return mDone || !mFibers.empty(); });
+            if (mFibers.empty()) {
+                return;
+            }
+            auto fiber = std::move(mFibers.front());
+            mFibers.pop_front();
+            lock.unlock();
+            fiber.wait();
+            lock.lock();
+        }
+    }
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    std::deque<Fiber> mFibers;
+    bool mDone;
+    std::thread mThread;
+};
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    crossbow::string commitManager;
+    crossbow::string storageNodes;
+    uint64_t latency = 0;
+    crossbow::string tracePath;
+    size_t numThreads = 2;
+    double speed = 1.0;
+    auto opts = create_options("trace_replay",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'c'>("commit-manager", &commitManager, tag::description{"Address to the commit manager"}),
+            value<'s'>("storage-nodes", &storageNodes, tag::description{"Semicolon-separated list of storage node addresses"}),
+            value<'l'>("latency", &latency, tag::description{"Simulated round trip time in microseconds (local store only)"}),
+            value<'i'>("input", &tracePath, tag::description{"Trace written by ClientManager::startTrace"}),
+            value<'t'>("threads", &numThreads, tag::description{"Number of client threads"}),
+            value<'x'>("speed", &speed, tag::description{"Replay speed relative to the original (0 for as fast as possible)"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+    if (tracePath.empty() || numThreads == 0 || speed < 0.0) {
+        print_help(std::cout, opts);
+        return 1;
+    }
+
+    // Transactions are written when they finish, replay them in the order they started
+    std::vector<TraceTransaction> trace;
+    {
+        TraceReader reader(tracePath);
+        TraceTransaction transaction;
+        while (reader.next(transaction)) {
+            trace.emplace_back(std::move(transaction));
+        }
+    }
+    std::stable_sort(trace.begin(), trace.end(), [](const TraceTransaction& lhs, const TraceTransaction& rhs) {
+        return lhs.start < rhs.start;
+    });
+    std::cout << "Replaying " << trace.size() << " transactions from " << tracePath << std::endl;
+    if (trace.empty()) {
+        return 0;
+    }
+
+    crossbow::allocator::init();
+
+    auto config = createClientConfig(commitManager, storageNodes, numThreads, latency);
+    ClientManager<void> clientManager(config);
+
+    std::vector<ReplayStats> stats(numThreads);
+    auto begin = Clock::now();
+    {
+        Reaper reaper;
+        auto traceStart = trace.front().start;
+        for (size_t i = 0; i < trace.size(); ++i) {
+            const auto& transaction = trace[i];
+            auto intended = begin;
+            if (speed > 0.0) {
+                intended += std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double, std::nano>(double(transaction.start - traceStart) / speed));
+                std::this_thread::sleep_until(intended);
+            }
+
+            auto processor = i % numThreads;
+            auto& processorStats = stats[processor];
+            reaper.add(clientManager.startTransaction([&transaction, &processorStats, intended](Transaction& tx) {
+                auto outcome = TraceOutcome::Aborted;
+                try {
+                    outcome = replay(tx, transaction, processorStats);
+                } catch (MissingTuple&) {
+                    ++processorStats.missing;
+                    tx.rollback();
+                } catch (Conflict&) {
+                    tx.rollback();
+                } catch (Conflicts&) {
+                    tx.rollback();
+                } catch (IndexConflict&) {
+                    tx.rollback();
+                } catch (UniqueViolation&) {
+                    tx.rollback();
+                } catch (TupleExistsException&) {
+                    tx.rollback();
+                }
+                switch (outcome) {
+                case TraceOutcome::Committed:
+                    ++processorStats.committed;
+                    break;
+                case TraceOutcome::RolledBack:
+                    ++processorStats.rolledBack;
+                    break;
+                case TraceOutcome::Aborted:
+                    ++processorStats.aborted;
+                    break;
+                }
+                if ((outcome == TraceOutcome::Committed) != (transaction.outcome == TraceOutcome::Committed)) {
+                    ++processorStats.divergent;
+                }
+                processorStats.responseTime.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - intended).count()));
+                processorStats.originalTime.record(transaction.duration);
+            }, transaction.type, static_cast<int>(processor)));
+        }
+        // The reaper waits for all outstanding transactions on destruction
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    auto originalElapsed = double(trace.back().start + trace.back().duration - trace.front().start) / 1e9;
+
+    ReplayStats total;
+    for (auto& processorStats : stats) {
+        total.merge(processorStats);
+    }
+    std::cout << "Runtime: " << std::fixed << std::setprecision(3) << elapsed << "s (original " << originalElapsed
+              << "s)" << std::endl;
+    std::cout << "Committed: " << total.committed << " Rolled back: " << total.rolledBack << " Aborted: "
+              << total.aborted << " Divergent: " << total.divergent << std::endl;
+    std::cout << "Missing tuples: " << total.missing << " Skipped operations: " << total.skipped << std::endl;
+    printHistogram(std::cout, "Replay latency", total.responseTime);
+    printHistogram(std::cout, "Original latency", total.originalTime);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Populate.hpp"
+#include "Schema.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace tpcc {
+namespace {
+
+using PopulateTask = std::function<void(Transaction&, TpccRandom&)>;
+
+constexpr int32_t gItemBatchSize = 1000;
+constexpr int32_t gCustomerBatchSize = 500;
+constexpr int32_t gOrderBatchSize = 100;
+
+} // anonymous namespace
+
+void populateDatabase(ClientManager<void>& clientManager, int32_t warehouses, size_t numClients, uint64_t seed) {
+    auto createFiber = clientManager.startTransaction([](Transaction& tx) {
+        createSchema(tx);
+        tx.commit();
+    });
+    createFiber.wait();
+
+    // The customer ids of the initial orders are a random permutation per district
+    std::vector<std::vector<int32_t>> permutations;
+    Random rng(seed);
+    for (int32_t i = 0; i < warehouses * gDistrictsPerWarehouse; ++i) {
+        std::vector<int32_t> customers(gCustomersPerDistrict);
+        std::iota(customers.begin(), customers.end(), 1);
+        std::shuffle(customers.begin(), customers.end(), rng);
+        permutations.emplace_back(std::move(customers));
+    }
+
+    std::vector<PopulateTask> tasks;
+    for (int32_t i = 1; i <= gItemCount; i += gItemBatchSize) {
+        tasks.emplace_back([i](Transaction& tx, TpccRandom& random) {
+            populateItems(tx, random, i, std::min(i + gItemBatchSize, gItemCount + 1));
+        });
+    }
+    for (int32_t w = 1; w <= warehouses; ++w) {
+        tasks.emplace_back([w](Transaction& tx, TpccRandom& random) {
+            populateWarehouse(tx, random, w);
+        });
+        for (int32_t i = 1; i <= gItemCount; i += gItemBatchSize) {
+            tasks.emplace_back([w, i](Transaction& tx, TpccRandom& random) {
+                populateStock(tx, random, w, i, std::min(i + gItemBatchSize, gItemCount + 1));
+            });
+        }
+        for (int32_t d = 1; d <= gDistrictsPerWarehouse; ++d) {
+            for (int32_t c = 1; c <= gCustomersPerDistrict; c += gCustomerBatchSize) {
+                tasks.emplace_back([w, d, c](Transaction& tx, TpccRandom& random) {
+                    populateCustomers(tx, random, w, d, c,
+                            std::min(c + gCustomerBatchSize, gCustomersPerDistrict + 1));
+                });
+            }
+            auto& customers = permutations[(w - 1) * gDistrictsPerWarehouse + (d - 1)];
+            for (int32_t o = 1; o <= gInitialOrders; o += gOrderBatchSize) {
+                tasks.emplace_back([w, d, o, &customers](Transaction& tx, TpccRandom& random) {
+                    populateOrders(tx, random, w, d, o, std::min(o + gOrderBatchSize, gInitialOrders + 1),
+                            customers);
+                });
+            }
+        }
+    }
+
+    std::atomic<size_t> nextTask(0);
+    std::vector<std::thread> clients;
+    for (size_t i = 0; i < numClients; ++i) {
+        clients.emplace_back([&clientManager, &tasks, &nextTask, seed, i]() {
+            TpccRandom random(seed + i);
+            while (true) {
+                auto task = nextTask.fetch_add(1);
+                if (task >= tasks.size()) {
+                    break;
+                }
+                auto fiber = clientManager.startTransaction([&tasks, &random, task](Transaction& tx) {
+                    tasks[task](tx, random);
+                });
+                fiber.wait();
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+}
+
+} // namespace tpcc
+} // namespace bench
+} // namespace db
+} // namespace tell
@@ -0,0 +1,45 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <telldb/TellDB.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace tpcc {
+
+/**
+ * @brief Creates the schema and loads the initial database
+ *
+ * The population is split into transactions of bounded size that are executed by the given number of clients.
+ */
+void populateDatabase(ClientManager<void>& clientManager, int32_t warehouses, size_t numClients, uint64_t seed);
+
+} // namespace tpcc
+} // namespace bench
+} // namespace db
+} // namespace tell
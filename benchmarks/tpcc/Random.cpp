@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Random.hpp"
+
+#include <array>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace tpcc {
+namespace {
+
+const std::array<const char*, 10> gSyllables = {{
+    "BAR", "OUGHT", "ABLE", "PRI", "PRES", "ESE", "ANTI", "CALLY", "ATION", "EING"
+}};
+
+const char gAlphaNum[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+} // anonymous namespace
+
+TpccRandom::TpccRandom(uint64_t seed)
+        : mRng(seed) {
+    // The constant C of NURand has to be the same for all terminals
+    Random constants(0x5EEDu);
+    std::uniform_int_distribution<int32_t> cLast(0, 255);
+    std::uniform_int_distribution<int32_t> cId(0, 1023);
+    std::uniform_int_distribution<int32_t> olIId(0, 8191);
+    mCLast = cLast(constants);
+    mCId = cId(constants);
+    mOlIId = olIId(constants);
+}
+
+int32_t TpccRandom::uniform(int32_t lower, int32_t upper) {
+    std::uniform_int_distribution<int32_t> dist(lower, upper);
+    return dist(mRng);
+}
+
+double TpccRandom::uniform(double lower, double upper) {
+    std::uniform_real_distribution<double> dist(lower, upper);
+    return dist(mRng);
+}
+
+int32_t TpccRandom::nurand(int32_t a, int32_t lower, int32_t upper) {
+    int32_t c;
+    switch (a) {
+    case 255:
+        c = mCLast;
+        break;
+    case 1023:
+        c = mCId;
+        break;
+    default:
+        c = mOlIId;
+        break;
+    }
+    return (((uniform(0, a) | uniform(lower, upper)) + c) % (upper - lower + 1)) + lower;
+}
+
+crossbow::string TpccRandom::astring(uint32_t minLength, uint32_t maxLength) {
+    auto length = static_cast<uint32_t>(uniform(int32_t(minLength), int32_t(maxLength)));
+    crossbow::string result(length, ' ');
+    for (auto& c : result) {
+        c = gAlphaNum[uniform(0, int32_t(sizeof(gAlphaNum) - 2))];
+    }
+    return result;
+}
+
+crossbow::string TpccRandom::nstring(uint32_t minLength, uint32_t maxLength) {
+    auto length = static_cast<uint32_t>(uniform(int32_t(minLength), int32_t(maxLength)));
+    crossbow::string result(length, ' ');
+    for (auto& c : result) {
+        c = static_cast<char>('0' + uniform(0, 9));
+    }
+    return result;
+}
+
+crossbow::string TpccRandom::zip() {
+    return nstring(4, 4) + "11111";
+}
+
+crossbow::string TpccRandom::data(uint32_t minLength, uint32_t maxLength) {
+    auto result = astring(minLength, maxLength);
+    if (uniform(1, 10) == 1) {
+        auto pos = static_cast<size_t>(uniform(0, int32_t(result.size()) - 8));
+        result.replace(pos, 8, "ORIGINAL");
+    }
+    return result;
+}
+
+crossbow::string TpccRandom::randomLastName() {
+    return lastName(nurand(255, 0, 999));
+}
+
+crossbow::string TpccRandom::lastName(int32_t num) {
+    crossbow::string result;
+    result += gSyllables[num / 100];
+    result += gSyllables[(num / 10) % 10];
+    result += gSyllables[num % 10];
+    return result;
+}
+
+} // namespace tpcc
+} // namespace bench
+} // namespace db
+} // namespace tell
@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include "../common/KeyChooser.hpp"
+
+#include <crossbow/string.hpp>
+
+#include <cstdint>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace tpcc {
+
+/**
+ * @brief Random number and string generators as defined in clause 4.3 of the TPC-C specification
+ */
+class TpccRandom {
+public:
+    TpccRandom(uint64_t seed);
+
+    Random& rng() {
+        return mRng;
+    }
+
+    int32_t uniform(int32_t lower, int32_t upper);
+
+    double uniform(double lower, double upper);
+
+    /**
+     * @brief Non-uniform random number NURand(A, x, y)
+     */
+    int32_t nurand(int32_t a, int32_t lower, int32_t upper);
+
+    /**
+     * @brief Random alphanumeric string with a length in [minLength, maxLength]
+     */
+    crossbow::string astring(uint32_t minLength, uint32_t maxLength);
+
+    /**
+     * @brief Random numeric string with a length in [minLength, maxLength]
+     */
+    crossbow::string nstring(uint32_t minLength, uint32_t maxLength);
+
+    crossbow::string zip();
+
+    /**
+     * @brief Random data string of which 10% contain "ORIGINAL"
+     */
+    crossbow::string data(uint32_t minLength, uint32_t maxLength);
+
+    /**
+     * @brief Customer last name for a run time customer selection
+     */
+    crossbow::string randomLastName();
+
+    int32_t randomCustomerId() {
+        return nurand(1023, 1, 3000);
+    }
+
+    int32_t randomItemId() {
+        return nurand(8191, 1, 100000);
+    }
+
+    /**
+     * @brief Customer last name built from the syllables of the digits of num
+     */
+    static crossbow::string lastName(int32_t num);
+
+private:
+    Random mRng;
+    int32_t mCLast;
+    int32_t mCId;
+    int32_t mOlIId;
+};
+
+} // namespace tpcc
+} // namespace bench
+} // namespace db
+} // namespace tell
@@ -0,0 +1,339 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Schema.hpp"
+
+#include <chrono>
+#include <initializer_list>
+#include <utility>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace tpcc {
+namespace {
+
+using FieldType = tell::store::FieldType;
+using FieldList = std::initializer_list<std::pair<FieldType, const char*>>;
+
+tell::store::Schema createTableSchema(FieldList notNull, FieldList nullable = {}) {
+    tell::store::Schema schema(tell::store::TableType::TRANSACTIONAL);
+    for (auto& field : notNull) {
+        schema.addField(field.first, field.second, true);
+    }
+    for (auto& field : nullable) {
+        schema.addField(field.first, field.second, false);
+    }
+    return schema;
+}
+
+void addIndex(tell::store::Schema& schema, const char* name, bool unique, std::initializer_list<const char*> fields) {
+    std::vector<tell::store::Schema::id_t> ids;
+    for (auto field : fields) {
+        ids.emplace_back(schema.idOf(field));
+    }
+    schema.addIndex(name, std::make_pair(unique, std::move(ids)));
+}
+
+} // anonymous namespace
+
+int64_t now() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void createSchema(Transaction& tx) {
+    tx.createTable("warehouse", createTableSchema({
+            {FieldType::INT, "w_id"},
+            {FieldType::TEXT, "w_name"},
+            {FieldType::TEXT, "w_street_1"},
+            {FieldType::TEXT, "w_street_2"},
+            {FieldType::TEXT, "w_city"},
+            {FieldType::TEXT, "w_state"},
+            {FieldType::TEXT, "w_zip"},
+            {FieldType::DOUBLE, "w_tax"},
+            {FieldType::DOUBLE, "w_ytd"}}));
+
+    tx.createTable("district", createTableSchema({
+            {FieldType::INT, "d_id"},
+            {FieldType::INT, "d_w_id"},
+            {FieldType::TEXT, "d_name"},
+            {FieldType::TEXT, "d_street_1"},
+            {FieldType::TEXT, "d_street_2"},
+            {FieldType::TEXT, "d_city"},
+            {FieldType::TEXT, "d_state"},
+            {FieldType::TEXT, "d_zip"},
+            {FieldType::DOUBLE, "d_tax"},
+            {FieldType::DOUBLE, "d_ytd"}}));
+
+    auto customer = createTableSchema({
+            {FieldType::INT, "c_id"},
+            {FieldType::INT, "c_d_id"},
+            {FieldType::INT, "c_w_id"},
+            {FieldType::TEXT, "c_first"},
+            {FieldType::TEXT, "c_middle"},
+            {FieldType::TEXT, "c_last"},
+            {FieldType::TEXT, "c_street_1"},
+            {FieldType::TEXT, "c_street_2"},
+            {FieldType::TEXT, "c_city"},
+            {FieldType::TEXT, "c_state"},
+            {FieldType::TEXT, "c_zip"},
+            {FieldType::TEXT, "c_phone"},
+            {FieldType::BIGINT, "c_since"},
+            {FieldType::TEXT, "c_credit"},
+            {FieldType::DOUBLE, "c_credit_lim"},
+            {FieldType::DOUBLE, "c_discount"},
+            {FieldType::DOUBLE, "c_balance"},
+            {FieldType::DOUBLE, "c_ytd_payment"},
+            {FieldType::INT, "c_payment_cnt"},
+            {FieldType::INT, "c_delivery_cnt"},
+            {FieldType::TEXT, "c_data"}});
+    addIndex(customer, "customer_last_idx", false, {"c_w_id", "c_d_id", "c_last", "c_first"});
+    tx.createTable("customer", customer);
+
+    tx.createTable("history", createTableSchema({
+            {FieldType::INT, "h_c_id"},
+            {FieldType::INT, "h_c_d_id"},
+            {FieldType::INT, "h_c_w_id"},
+            {FieldType::INT, "h_d_id"},
+            {FieldType::INT, "h_w_id"},
+            {FieldType::BIGINT, "h_date"},
+            {FieldType::DOUBLE, "h_amount"},
+            {FieldType::TEXT, "h_data"}}));
+
+    auto newOrder = createTableSchema({
+            {FieldType::INT, "no_o_id"},
+            {FieldType::INT, "no_d_id"},
+            {FieldType::INT, "no_w_id"}});
+    addIndex(newOrder, "new_order_idx", true, {"no_w_id", "no_d_id", "no_o_id"});
+    tx.createTable("new_order", newOrder);
+
+    auto order = createTableSchema({
+            {FieldType::INT, "o_id"},
+            {FieldType::INT, "o_d_id"},
+            {FieldType::INT, "o_w_id"},
+            {FieldType::INT, "o_c_id"},
+            {FieldType::BIGINT, "o_entry_d"},
+            {FieldType::INT, "o_ol_cnt"},
+            {FieldType::INT, "o_all_local"}}, {
+            {FieldType::INT, "o_carrier_id"}});
+    addIndex(order, "order_customer_idx", true, {"o_w_id", "o_d_id", "o_c_id", "o_id"});
+    addIndex(order, "order_district_idx", true, {"o_w_id", "o_d_id", "o_id"});
+    tx.createTable("order", order);
+
+    tx.createTable("order_line", createTableSchema({
+            {FieldType::INT, "ol_o_id"},
+            {FieldType::INT, "ol_d_id"},
+            {FieldType::INT, "ol_w_id"},
+            {FieldType::INT, "ol_number"},
+            {FieldType::INT, "ol_i_id"},
+            {FieldType::INT, "ol_supply_w_id"},
+            {FieldType::INT, "ol_quantity"},
+            {FieldType::DOUBLE, "ol_amount"},
+            {FieldType::TEXT, "ol_dist_info"}}, {
+            {FieldType::BIGINT, "ol_delivery_d"}}));
+
+    tx.createTable("item", createTableSchema({
+            {FieldType::INT, "i_id"},
+            {FieldType::INT, "i_im_id"},
+            {FieldType::TEXT, "i_name"},
+            {FieldType::DOUBLE, "i_price"},
+            {FieldType::TEXT, "i_data"}}));
+
+    tx.createTable("stock", createTableSchema({
+            {FieldType::INT, "s_i_id"},
+            {FieldType::INT, "s_w_id"},
+            {FieldType::INT, "s_quantity"},
+            {FieldType::TEXT, "s_dist_01"},
+            {FieldType::TEXT, "s_dist_02"},
+            {FieldType::TEXT, "s_dist_03"},
+            {FieldType::TEXT, "s_dist_04"},
+            {FieldType::TEXT, "s_dist_05"},
+            {FieldType::TEXT, "s_dist_06"},
+            {FieldType::TEXT, "s_dist_07"},
+            {FieldType::TEXT, "s_dist_08"},
+            {FieldType::TEXT, "s_dist_09"},
+            {FieldType::TEXT, "s_dist_10"},
+            {FieldType::INT, "s_ytd"},
+            {FieldType::INT, "s_order_cnt"},
+            {FieldType::INT, "s_remote_cnt"},
+            {FieldType::TEXT, "s_data"}}));
+
+    tx.createCounter(gOrderCounter);
+    tx.createCounter(gHistoryCounter);
+}
+
+void populateItems(Transaction& tx, TpccRandom& random, int32_t begin, int32_t end) {
+    auto table = tx.openTable("item").get();
+    for (auto i = begin; i < end; ++i) {
+        tx.insert(table, key_t{itemKey(i)}, {
+                {"i_id", i},
+                {"i_im_id", random.uniform(1, 10000)},
+                {"i_name", random.astring(14, 24)},
+                {"i_price", random.uniform(1.0, 100.0)},
+                {"i_data", random.data(26, 50)}});
+    }
+    tx.commit();
+}
+
+void populateWarehouse(Transaction& tx, TpccRandom& random, int32_t w) {
+    auto warehouseTable = tx.openTable("warehouse").get();
+    auto districtTable = tx.openTable("district").get();
+    tx.insert(warehouseTable, key_t{warehouseKey(w)}, {
+            {"w_id", w},
+            {"w_name", random.astring(6, 10)},
+            {"w_street_1", random.astring(10, 20)},
+            {"w_street_2", random.astring(10, 20)},
+            {"w_city", random.astring(10, 20)},
+            {"w_state", random.astring(2, 2)},
+            {"w_zip", random.zip()},
+            {"w_tax", random.uniform(0.0, 0.2)},
+            {"w_ytd", 300000.0}});
+    for (int32_t d = 1; d <= gDistrictsPerWarehouse; ++d) {
+        tx.insert(districtTable, key_t{districtKey(w, d)}, {
+                {"d_id", d},
+                {"d_w_id", w},
+                {"d_name", random.astring(6, 10)},
+                {"d_street_1", random.astring(10, 20)},
+                {"d_street_2", random.astring(10, 20)},
+                {"d_city", random.astring(10, 20)},
+                {"d_state", random.astring(2, 2)},
+                {"d_zip", random.zip()},
+                {"d_tax", random.uniform(0.0, 0.2)},
+                {"d_ytd", 30000.0}});
+    }
+    tx.commit();
+}
+
+void populateStock(Transaction& tx, TpccRandom& random, int32_t w, int32_t begin, int32_t end) {
+    auto table = tx.openTable("stock").get();
+    for (auto i = begin; i < end; ++i) {
+        tx.insert(table, key_t{stockKey(w, i)}, {
+                {"s_i_id", i},
+                {"s_w_id", w},
+                {"s_quantity", random.uniform(10, 100)},
+                {"s_dist_01", random.astring(24, 24)},
+                {"s_dist_02", random.astring(24, 24)},
+                {"s_dist_03", random.astring(24, 24)},
+                {"s_dist_04", random.astring(24, 24)},
+                {"s_dist_05", random.astring(24, 24)},
+                {"s_dist_06", random.astring(24, 24)},
+                {"s_dist_07", random.astring(24, 24)},
+                {"s_dist_08", random.astring(24, 24)},
+                {"s_dist_09", random.astring(24, 24)},
+                {"s_dist_10", random.astring(24, 24)},
+                {"s_ytd", 0},
+                {"s_order_cnt", 0},
+                {"s_remote_cnt", 0},
+                {"s_data", random.data(26, 50)}});
+    }
+    tx.commit();
+}
+
+void populateCustomers(Transaction& tx, TpccRandom& random, int32_t w, int32_t d, int32_t begin, int32_t end) {
+    auto customerTable = tx.openTable("customer").get();
+    auto historyTable = tx.openTable("history").get();
+    auto date = now();
+    for (auto c = begin; c < end; ++c) {
+        auto lastName = TpccRandom::lastName(c <= 1000 ? c - 1 : random.nurand(255, 0, 999));
+        tx.insert(customerTable, key_t{customerKey(w, d, c)}, {
+                {"c_id", c},
+                {"c_d_id", d},
+                {"c_w_id", w},
+                {"c_first", random.astring(8, 16)},
+                {"c_middle", crossbow::string("OE")},
+                {"c_last", lastName},
+                {"c_street_1", random.astring(10, 20)},
+                {"c_street_2", random.astring(10, 20)},
+                {"c_city", random.astring(10, 20)},
+                {"c_state", random.astring(2, 2)},
+                {"c_zip", random.zip()},
+                {"c_phone", random.nstring(16, 16)},
+                {"c_since", date},
+                {"c_credit", crossbow::string(random.uniform(1, 10) == 1 ? "BC" : "GC")},
+                {"c_credit_lim", 50000.0},
+                {"c_discount", random.uniform(0.0, 0.5)},
+                {"c_balance", -10.0},
+                {"c_ytd_payment", 10.0},
+                {"c_payment_cnt", 1},
+                {"c_delivery_cnt", 0},
+                {"c_data", random.astring(300, 500)}});
+
+        // The initial history rows share the key of their customer, history rows of payments have the top bit set
+        tx.insert(historyTable, key_t{customerKey(w, d, c)}, {
+                {"h_c_id", c},
+                {"h_c_d_id", d},
+                {"h_c_w_id", w},
+                {"h_d_id", d},
+                {"h_w_id", w},
+                {"h_date", date},
+                {"h_amount", 10.0},
+                {"h_data", random.astring(12, 24)}});
+    }
+    tx.commit();
+}
+
+void populateOrders(Transaction& tx, TpccRandom& random, int32_t w, int32_t d, int32_t begin, int32_t end,
+        const std::vector<int32_t>& customers) {
+    auto orderTable = tx.openTable("order").get();
+    auto orderLineTable = tx.openTable("order_line").get();
+    auto newOrderTable = tx.openTable("new_order").get();
+    auto date = now();
+    for (auto o = begin; o < end; ++o) {
+        auto delivered = (o < gFirstNewOrder);
+        auto lineCount = random.uniform(5, 15);
+        tx.insert(orderTable, key_t{orderKey(w, d, o)}, {
+                {"o_id", o},
+                {"o_d_id", d},
+                {"o_w_id", w},
+                {"o_c_id", customers.at(o - 1)},
+                {"o_entry_d", date},
+                {"o_carrier_id", delivered ? Field(random.uniform(1, 10)) : Field(nullptr)},
+                {"o_ol_cnt", lineCount},
+                {"o_all_local", 1}});
+        for (int32_t number = 1; number <= lineCount; ++number) {
+            tx.insert(orderLineTable, key_t{orderLineKey(w, d, o, number)}, {
+                    {"ol_o_id", o},
+                    {"ol_d_id", d},
+                    {"ol_w_id", w},
+                    {"ol_number", number},
+                    {"ol_i_id", random.uniform(1, gItemCount)},
+                    {"ol_supply_w_id", w},
+                    {"ol_delivery_d", delivered ? Field(date) : Field(nullptr)},
+                    {"ol_quantity", 5},
+                    {"ol_amount", delivered ? 0.0 : random.uniform(0.01, 9999.99)},
+                    {"ol_dist_info", random.astring(24, 24)}});
+        }
+        if (!delivered) {
+            tx.insert(newOrderTable, key_t{orderKey(w, d, o)}, {
+                    {"no_o_id", o},
+                    {"no_d_id", d},
+                    {"no_w_id", w}});
+        }
+    }
+    tx.commit();
+}
+
+} // namespace tpcc
+} // namespace bench
+} // namespace db
+} // namespace tell
@@ -0,0 +1,121 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include "Random.hpp"
+
+#include <telldb/Transaction.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace tpcc {
+
+constexpr int32_t gDistrictsPerWarehouse = 10;
+constexpr int32_t gCustomersPerDistrict = 3000;
+constexpr int32_t gItemCount = 100000;
+constexpr int32_t gInitialOrders = 3000;
+
+/// First order of every district that is still undelivered after the population
+constexpr int32_t gFirstNewOrder = 2101;
+
+/// Name of the counter handing out the ids of new orders
+constexpr const char* gOrderCounter = "tpcc_order_id";
+
+/// Name of the counter handing out the keys of history rows
+constexpr const char* gHistoryCounter = "tpcc_history_id";
+
+/*
+ * Every table is keyed by a packed version of its TPC-C primary key. Order ids of new orders are taken from a global
+ * counter and offset by gInitialOrders, they are unique but not dense within a district. All lookups that depend on
+ * the order of order ids (latest order of a customer, oldest new order, last 20 orders of a district) go through
+ * indexes.
+ */
+
+inline uint64_t warehouseKey(int32_t w) {
+    return static_cast<uint64_t>(w);
+}
+
+inline uint64_t districtKey(int32_t w, int32_t d) {
+    return static_cast<uint64_t>(w) * gDistrictsPerWarehouse + static_cast<uint64_t>(d - 1);
+}
+
+inline uint64_t customerKey(int32_t w, int32_t d, int32_t c) {
+    return districtKey(w, d) * gCustomersPerDistrict + static_cast<uint64_t>(c - 1);
+}
+
+inline uint64_t itemKey(int32_t i) {
+    return static_cast<uint64_t>(i);
+}
+
+inline uint64_t stockKey(int32_t w, int32_t i) {
+    return static_cast<uint64_t>(w) * gItemCount + static_cast<uint64_t>(i - 1);
+}
+
+inline uint64_t orderKey(int32_t w, int32_t d, int32_t o) {
+    return (districtKey(w, d) << 32) | static_cast<uint32_t>(o);
+}
+
+inline uint64_t orderLineKey(int32_t w, int32_t d, int32_t o, int32_t number) {
+    return (orderKey(w, d, o) << 4) | static_cast<uint64_t>(number);
+}
+
+/**
+ * @brief Current time in milliseconds used for all date columns
+ */
+int64_t now();
+
+/**
+ * @brief Creates all tables, their indexes and the counters
+ */
+void createSchema(Transaction& tx);
+
+void populateItems(Transaction& tx, TpccRandom& random, int32_t begin, int32_t end);
+
+/**
+ * @brief Inserts the warehouse and its districts
+ */
+void populateWarehouse(Transaction& tx, TpccRandom& random, int32_t w);
+
+void populateStock(Transaction& tx, TpccRandom& random, int32_t w, int32_t begin, int32_t end);
+
+/**
+ * @brief Inserts the customers [begin, end) of a district with one history row each
+ */
+void populateCustomers(Transaction& tx, TpccRandom& random, int32_t w, int32_t d, int32_t begin, int32_t end);
+
+/**
+ * @brief Inserts the orders [begin, end) of a district with their order lines and new orders
+ *
+ * @param customers Random permutation of the customer ids of the district
+ */
+void populateOrders(Transaction& tx, TpccRandom& random, int32_t w, int32_t d, int32_t begin, int32_t end,
+        const std::vector<int32_t>& customers);
+
+} // namespace tpcc
+} // namespace bench
+} // namespace db
+} // namespace tell
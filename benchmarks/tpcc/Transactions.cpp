@@ -0,0 +1,491 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Transactions.hpp"
+#include "Schema.hpp"
+
+#include <telldb/Exceptions.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace tpcc {
+namespace {
+
+/**
+ * @brief Thrown by a New-Order transaction that hits the unused item id
+ */
+struct UserAbort {
+};
+
+constexpr int32_t gMaxId = std::numeric_limits<int32_t>::max();
+
+const std::array<const char*, gDistrictsPerWarehouse> gDistInfoFields = {{
+    "s_dist_01", "s_dist_02", "s_dist_03", "s_dist_04", "s_dist_05",
+    "s_dist_06", "s_dist_07", "s_dist_08", "s_dist_09", "s_dist_10"
+}};
+
+template <typename T>
+T valueOf(const Tuple& tuple, const crossbow::string& name) {
+    return tuple[name].value<T>();
+}
+
+} // anonymous namespace
+
+const char* transactionName(TransactionKind kind) {
+    switch (kind) {
+    case TransactionKind::NewOrder:
+        return "New-Order";
+    case TransactionKind::Payment:
+        return "Payment";
+    case TransactionKind::OrderStatus:
+        return "Order-Status";
+    case TransactionKind::Delivery:
+        return "Delivery";
+    case TransactionKind::StockLevel:
+        return "Stock-Level";
+    }
+    return "Unknown";
+}
+
+tell::store::TransactionType transactionType(TransactionKind kind) {
+    switch (kind) {
+    case TransactionKind::OrderStatus:
+    case TransactionKind::StockLevel:
+        return tell::store::TransactionType::READ_ONLY;
+    default:
+        return tell::store::TransactionType::READ_WRITE;
+    }
+}
+
+void TransactionStats::merge(const TransactionStats& other) {
+    committed += other.committed;
+    aborted += other.aborted;
+    rolledBack += other.rolledBack;
+    latency.merge(other.latency);
+}
+
+TransactionKind Terminal::chooseTransaction() {
+    auto value = mRandom.uniform(1, 100);
+    if (value <= 45) {
+        return TransactionKind::NewOrder;
+    } else if (value <= 88) {
+        return TransactionKind::Payment;
+    } else if (value <= 92) {
+        return TransactionKind::OrderStatus;
+    } else if (value <= 96) {
+        return TransactionKind::Delivery;
+    }
+    return TransactionKind::StockLevel;
+}
+
+TransactionResult Terminal::execute(TransactionKind kind, Transaction& tx) {
+    try {
+        switch (kind) {
+        case TransactionKind::NewOrder:
+            newOrder(tx);
+            break;
+        case TransactionKind::Payment:
+            payment(tx);
+            break;
+        case TransactionKind::OrderStatus:
+            orderStatus(tx);
+            break;
+        case TransactionKind::Delivery:
+            delivery(tx);
+            break;
+        case TransactionKind::StockLevel:
+            stockLevel(tx);
+            break;
+        }
+        tx.commit();
+    } catch (UserAbort&) {
+        tx.rollback();
+        return TransactionResult::RolledBack;
+    } catch (Conflict&) {
+        tx.rollback();
+        return TransactionResult::Aborted;
+    } catch (Conflicts&) {
+        tx.rollback();
+        return TransactionResult::Aborted;
+    } catch (IndexConflict&) {
+        tx.rollback();
+        return TransactionResult::Aborted;
+    }
+    return TransactionResult::Committed;
+}
+
+void Terminal::newOrder(Transaction& tx) {
+    auto warehouseTableFuture = tx.openTable("warehouse");
+    auto districtTableFuture = tx.openTable("district");
+    auto customerTableFuture = tx.openTable("customer");
+    auto itemTableFuture = tx.openTable("item");
+    auto stockTableFuture = tx.openTable("stock");
+    auto orderTableFuture = tx.openTable("order");
+    auto newOrderTableFuture = tx.openTable("new_order");
+    auto orderLineTableFuture = tx.openTable("order_line");
+    auto warehouseTable = warehouseTableFuture.get();
+    auto districtTable = districtTableFuture.get();
+    auto customerTable = customerTableFuture.get();
+    auto itemTable = itemTableFuture.get();
+    auto stockTable = stockTableFuture.get();
+    auto orderTable = orderTableFuture.get();
+    auto newOrderTable = newOrderTableFuture.get();
+    auto orderLineTable = orderLineTableFuture.get();
+
+    auto w = mHomeWarehouse;
+    auto d = mRandom.uniform(1, gDistrictsPerWarehouse);
+    auto c = mRandom.randomCustomerId();
+    auto lineCount = mRandom.uniform(5, 15);
+    auto rollback = (mRandom.uniform(1, 100) == 1);
+
+    std::vector<int32_t> items;
+    std::vector<int32_t> supplyWarehouses;
+    std::vector<int32_t> quantities;
+    int32_t allLocal = 1;
+    while (items.size() < static_cast<size_t>(lineCount)) {
+        auto i = mRandom.randomItemId();
+        if (std::find(items.begin(), items.end(), i) != items.end()) {
+            continue;
+        }
+        items.emplace_back(i);
+        auto supply = chooseWarehouse(1);
+        if (supply != w) {
+            allLocal = 0;
+        }
+        supplyWarehouses.emplace_back(supply);
+        quantities.emplace_back(mRandom.uniform(1, 10));
+    }
+    if (rollback) {
+        items.back() = gItemCount + 1;
+    }
+
+    // Issue all reads before waiting for the first one
+    auto warehouseFuture = tx.get(warehouseTable, key_t{warehouseKey(w)});
+    auto districtFuture = tx.get(districtTable, key_t{districtKey(w, d)});
+    auto customerFuture = tx.get(customerTable, key_t{customerKey(w, d, c)});
+    std::vector<Future<Tuple>> itemFutures;
+    std::vector<Future<Tuple>> stockFutures;
+    for (size_t i = 0; i < items.size(); ++i) {
+        itemFutures.emplace_back(tx.get(itemTable, key_t{itemKey(items[i])}));
+        stockFutures.emplace_back(tx.get(stockTable, key_t{stockKey(supplyWarehouses[i], items[i])}));
+    }
+
+    auto wTax = valueOf<double>(warehouseFuture.get(), "w_tax");
+    auto dTax = valueOf<double>(districtFuture.get(), "d_tax");
+    auto cDiscount = valueOf<double>(customerFuture.get(), "c_discount");
+
+    auto o = gInitialOrders + static_cast<int32_t>(tx.getCounter(gOrderCounter).next());
+    tx.insert(orderTable, key_t{orderKey(w, d, o)}, {
+            {"o_id", o},
+            {"o_d_id", d},
+            {"o_w_id", w},
+            {"o_c_id", c},
+            {"o_entry_d", now()},
+            {"o_carrier_id", Field(nullptr)},
+            {"o_ol_cnt", lineCount},
+            {"o_all_local", allLocal}});
+    tx.insert(newOrderTable, key_t{orderKey(w, d, o)}, {
+            {"no_o_id", o},
+            {"no_d_id", d},
+            {"no_w_id", w}});
+
+    crossbow::string distInfoField = gDistInfoFields[d - 1];
+    double total = 0.0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        const Tuple* item;
+        try {
+            item = &itemFutures[i].get();
+        } catch (std::range_error&) {
+            throw UserAbort();
+        }
+        auto& stock = stockFutures[i].get();
+        auto quantity = quantities[i];
+
+        Tuple newStock = stock;
+        auto sQuantity = valueOf<int32_t>(stock, "s_quantity");
+        newStock["s_quantity"] = (sQuantity >= quantity + 10 ? sQuantity - quantity : sQuantity - quantity + 91);
+        newStock["s_ytd"] = valueOf<int32_t>(stock, "s_ytd") + quantity;
+        newStock["s_order_cnt"] = valueOf<int32_t>(stock, "s_order_cnt") + 1;
+        if (supplyWarehouses[i] != w) {
+            newStock["s_remote_cnt"] = valueOf<int32_t>(stock, "s_remote_cnt") + 1;
+        }
+        tx.update(stockTable, key_t{stockKey(supplyWarehouses[i], items[i])}, stock, newStock);
+
+        auto amount = quantity * valueOf<double>(*item, "i_price");
+        total += amount;
+        auto number = static_cast<int32_t>(i + 1);
+        tx.insert(orderLineTable, key_t{orderLineKey(w, d, o, number)}, {
+                {"ol_o_id", o},
+                {"ol_d_id", d},
+                {"ol_w_id", w},
+                {"ol_number", number},
+                {"ol_i_id", items[i]},
+                {"ol_supply_w_id", supplyWarehouses[i]},
+                {"ol_delivery_d", Field(nullptr)},
+                {"ol_quantity", quantity},
+                {"ol_amount", amount},
+                {"ol_dist_info", valueOf<crossbow::string>(stock, distInfoField)}});
+    }
+    total *= (1.0 - cDiscount) * (1.0 + wTax + dTax);
+    (void) total;
+}
+
+void Terminal::payment(Transaction& tx) {
+    auto warehouseTableFuture = tx.openTable("warehouse");
+    auto districtTableFuture = tx.openTable("district");
+    auto customerTableFuture = tx.openTable("customer");
+    auto historyTableFuture = tx.openTable("history");
+    auto warehouseTable = warehouseTableFuture.get();
+    auto districtTable = districtTableFuture.get();
+    auto customerTable = customerTableFuture.get();
+    auto historyTable = historyTableFuture.get();
+
+    auto w = mHomeWarehouse;
+    auto d = mRandom.uniform(1, gDistrictsPerWarehouse);
+    auto cW = chooseWarehouse(15);
+    auto cD = (cW == w ? d : mRandom.uniform(1, gDistrictsPerWarehouse));
+    auto amount = mRandom.uniform(1.0, 5000.0);
+
+    auto warehouseFuture = tx.get(warehouseTable, key_t{warehouseKey(w)});
+    auto districtFuture = tx.get(districtTable, key_t{districtKey(w, d)});
+    auto c = chooseCustomer(tx, customerTable, cW, cD);
+    auto customerFuture = tx.get(customerTable, key_t{customerKey(cW, cD, c)});
+
+    auto& warehouse = warehouseFuture.get();
+    Tuple newWarehouse = warehouse;
+    newWarehouse["w_ytd"] = valueOf<double>(warehouse, "w_ytd") + amount;
+    tx.update(warehouseTable, key_t{warehouseKey(w)}, warehouse, newWarehouse);
+
+    auto& district = districtFuture.get();
+    Tuple newDistrict = district;
+    newDistrict["d_ytd"] = valueOf<double>(district, "d_ytd") + amount;
+    tx.update(districtTable, key_t{districtKey(w, d)}, district, newDistrict);
+
+    auto& customer = customerFuture.get();
+    Tuple newCustomer = customer;
+    newCustomer["c_balance"] = valueOf<double>(customer, "c_balance") - amount;
+    newCustomer["c_ytd_payment"] = valueOf<double>(customer, "c_ytd_payment") + amount;
+    newCustomer["c_payment_cnt"] = valueOf<int32_t>(customer, "c_payment_cnt") + 1;
+    if (valueOf<crossbow::string>(customer, "c_credit") == "BC") {
+        auto data = boost::lexical_cast<crossbow::string>(c) + " " + boost::lexical_cast<crossbow::string>(cD) + " "
+                + boost::lexical_cast<crossbow::string>(cW) + " " + boost::lexical_cast<crossbow::string>(d) + " "
+                + boost::lexical_cast<crossbow::string>(w) + " " + boost::lexical_cast<crossbow::string>(amount)
+                + " | " + valueOf<crossbow::string>(customer, "c_data");
+        if (data.size() > 500) {
+            data.resize(500);
+        }
+        newCustomer["c_data"] = data;
+    }
+    tx.update(customerTable, key_t{customerKey(cW, cD, c)}, customer, newCustomer);
+
+    auto historyKey = (uint64_t(1) << 63) | tx.getCounter(gHistoryCounter).next();
+    tx.insert(historyTable, key_t{historyKey}, {
+            {"h_c_id", c},
+            {"h_c_d_id", cD},
+            {"h_c_w_id", cW},
+            {"h_d_id", d},
+            {"h_w_id", w},
+            {"h_date", now()},
+            {"h_amount", amount},
+            {"h_data", valueOf<crossbow::string>(warehouse, "w_name") + "    "
+                    + valueOf<crossbow::string>(district, "d_name")}});
+}
+
+void Terminal::orderStatus(Transaction& tx) {
+    auto customerTableFuture = tx.openTable("customer");
+    auto orderTableFuture = tx.openTable("order");
+    auto orderLineTableFuture = tx.openTable("order_line");
+    auto customerTable = customerTableFuture.get();
+    auto orderTable = orderTableFuture.get();
+    auto orderLineTable = orderLineTableFuture.get();
+
+    auto w = mHomeWarehouse;
+    auto d = mRandom.uniform(1, gDistrictsPerWarehouse);
+    auto c = chooseCustomer(tx, customerTable, w, d);
+    tx.get(customerTable, key_t{customerKey(w, d, c)}).get();
+
+    // The latest order of the customer is the last entry before (w, d, c, max)
+    auto iter = tx.reverse_lower_bound(orderTable, "order_customer_idx", {Field(w), Field(d), Field(c), Field(gMaxId)});
+    if (iter.done() || iter.key()[0].value<int32_t>() != w || iter.key()[1].value<int32_t>() != d
+            || iter.key()[2].value<int32_t>() != c) {
+        return;
+    }
+    auto o = iter.key()[3].value<int32_t>();
+    auto& order = tx.get(orderTable, iter.value()).get();
+    auto lineCount = valueOf<int32_t>(order, "o_ol_cnt");
+
+    std::vector<Future<Tuple>> lines;
+    for (int32_t number = 1; number <= lineCount; ++number) {
+        lines.emplace_back(tx.get(orderLineTable, key_t{orderLineKey(w, d, o, number)}));
+    }
+    for (auto& line : lines) {
+        line.get();
+    }
+}
+
+void Terminal::delivery(Transaction& tx) {
+    auto customerTableFuture = tx.openTable("customer");
+    auto orderTableFuture = tx.openTable("order");
+    auto newOrderTableFuture = tx.openTable("new_order");
+    auto orderLineTableFuture = tx.openTable("order_line");
+    auto customerTable = customerTableFuture.get();
+    auto orderTable = orderTableFuture.get();
+    auto newOrderTable = newOrderTableFuture.get();
+    auto orderLineTable = orderLineTableFuture.get();
+
+    auto w = mHomeWarehouse;
+    auto carrier = mRandom.uniform(1, 10);
+    auto date = now();
+    for (int32_t d = 1; d <= gDistrictsPerWarehouse; ++d) {
+        // The oldest undelivered order is the first entry after (w, d)
+        auto iter = tx.lower_bound(newOrderTable, "new_order_idx", {Field(w), Field(d), Field(int32_t(0))});
+        if (iter.done() || iter.key()[0].value<int32_t>() != w || iter.key()[1].value<int32_t>() != d) {
+            continue;
+        }
+        auto o = iter.key()[2].value<int32_t>();
+        auto key = iter.value();
+
+        auto newOrderFuture = tx.get(newOrderTable, key);
+        auto orderFuture = tx.get(orderTable, key);
+        tx.remove(newOrderTable, key, newOrderFuture.get());
+
+        auto& order = orderFuture.get();
+        Tuple newOrder = order;
+        newOrder["o_carrier_id"] = carrier;
+        tx.update(orderTable, key, order, newOrder);
+
+        auto lineCount = valueOf<int32_t>(order, "o_ol_cnt");
+        std::vector<Future<Tuple>> lines;
+        for (int32_t number = 1; number <= lineCount; ++number) {
+            lines.emplace_back(tx.get(orderLineTable, key_t{orderLineKey(w, d, o, number)}));
+        }
+        double total = 0.0;
+        for (int32_t number = 1; number <= lineCount; ++number) {
+            auto& line = lines[number - 1].get();
+            total += valueOf<double>(line, "ol_amount");
+            Tuple newLine = line;
+            newLine["ol_delivery_d"] = date;
+            tx.update(orderLineTable, key_t{orderLineKey(w, d, o, number)}, line, newLine);
+        }
+
+        auto c = valueOf<int32_t>(order, "o_c_id");
+        auto& customer = tx.get(customerTable, key_t{customerKey(w, d, c)}).get();
+        Tuple newCustomer = customer;
+        newCustomer["c_balance"] = valueOf<double>(customer, "c_balance") + total;
+        newCustomer["c_delivery_cnt"] = valueOf<int32_t>(customer, "c_delivery_cnt") + 1;
+        tx.update(customerTable, key_t{customerKey(w, d, c)}, customer, newCustomer);
+    }
+}
+
+void Terminal::stockLevel(Transaction& tx) {
+    auto orderTableFuture = tx.openTable("order");
+    auto orderLineTableFuture = tx.openTable("order_line");
+    auto stockTableFuture = tx.openTable("stock");
+    auto orderTable = orderTableFuture.get();
+    auto orderLineTable = orderLineTableFuture.get();
+    auto stockTable = stockTableFuture.get();
+
+    auto w = mHomeWarehouse;
+    auto d = mRandom.uniform(1, gDistrictsPerWarehouse);
+    auto threshold = mRandom.uniform(10, 20);
+
+    // The last 20 orders of the district
+    std::vector<std::pair<int32_t, Future<Tuple>>> orders;
+    for (auto iter = tx.reverse_lower_bound(orderTable, "order_district_idx", {Field(w), Field(d), Field(gMaxId)});
+            !iter.done() && orders.size() < 20; iter.next()) {
+        if (iter.key()[0].value<int32_t>() != w || iter.key()[1].value<int32_t>() != d) {
+            break;
+        }
+        orders.emplace_back(iter.key()[2].value<int32_t>(), tx.get(orderTable, iter.value()));
+    }
+
+    std::vector<Future<Tuple>> lines;
+    for (auto& order : orders) {
+        auto lineCount = valueOf<int32_t>(order.second.get(), "o_ol_cnt");
+        for (int32_t number = 1; number <= lineCount; ++number) {
+            lines.emplace_back(tx.get(orderLineTable, key_t{orderLineKey(w, d, order.first, number)}));
+        }
+    }
+    std::set<int32_t> items;
+    for (auto& line : lines) {
+        items.insert(valueOf<int32_t>(line.get(), "ol_i_id"));
+    }
+
+    std::vector<Future<Tuple>> stocks;
+    for (auto i : items) {
+        stocks.emplace_back(tx.get(stockTable, key_t{stockKey(w, i)}));
+    }
+    size_t lowStock = 0;
+    for (auto& stock : stocks) {
+        if (valueOf<int32_t>(stock.get(), "s_quantity") < threshold) {
+            ++lowStock;
+        }
+    }
+    (void) lowStock;
+}
+
+int32_t Terminal::chooseCustomer(Transaction& tx, table_t customerTable, int32_t w, int32_t d) {
+    if (mRandom.uniform(1, 100) > 60) {
+        return mRandom.randomCustomerId();
+    }
+
+    // All customers with the last name ordered by their first name - choose the one in the middle
+    auto lastName = mRandom.randomLastName();
+    std::vector<key_t> customers;
+    for (auto iter = tx.lower_bound(customerTable, "customer_last_idx", {Field(w), Field(d), Field(lastName)});
+            !iter.done(); iter.next()) {
+        auto& key = iter.key();
+        if (key[0].value<int32_t>() != w || key[1].value<int32_t>() != d
+                || key[2].value<crossbow::string>() != lastName) {
+            break;
+        }
+        customers.emplace_back(iter.value());
+    }
+    if (customers.empty()) {
+        return mRandom.randomCustomerId();
+    }
+    auto key = customers[(customers.size() + 1) / 2 - 1].value;
+    return static_cast<int32_t>(key - districtKey(w, d) * gCustomersPerDistrict) + 1;
+}
+
+int32_t Terminal::chooseWarehouse(int32_t remotePercent) {
+    if (mWarehouses == 1 || mRandom.uniform(1, 100) > remotePercent) {
+        return mHomeWarehouse;
+    }
+    auto w = mRandom.uniform(1, mWarehouses - 1);
+    return (w >= mHomeWarehouse ? w + 1 : w);
+}
+
+} // namespace tpcc
+} // namespace bench
+} // namespace db
+} // namespace tell
@@ -0,0 +1,120 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include "Random.hpp"
+#include "../common/Statistics.hpp"
+
+#include <telldb/Transaction.hpp>
+
+#include <tellstore/TransactionType.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace tpcc {
+
+enum class TransactionKind : uint8_t {
+    NewOrder = 0,
+    Payment,
+    OrderStatus,
+    Delivery,
+    StockLevel,
+};
+
+constexpr size_t gTransactionKindCount = static_cast<size_t>(TransactionKind::StockLevel) + 1;
+
+const char* transactionName(TransactionKind kind);
+
+tell::store::TransactionType transactionType(TransactionKind kind);
+
+enum class TransactionResult : uint8_t {
+    Committed,
+
+    /// The transaction was aborted because of a conflict
+    Aborted,
+
+    /// The transaction was rolled back by the workload (1% of all New-Order transactions)
+    RolledBack,
+};
+
+struct TransactionStats {
+    void merge(const TransactionStats& other);
+
+    uint64_t committed = 0x0u;
+    uint64_t aborted = 0x0u;
+    uint64_t rolledBack = 0x0u;
+    LatencyRecorder latency;
+};
+
+/**
+ * @brief The five TPC-C transactions issued by a single terminal
+ */
+class Terminal {
+public:
+    Terminal(int32_t warehouses, int32_t homeWarehouse, uint64_t seed)
+            : mRandom(seed),
+              mWarehouses(warehouses),
+              mHomeWarehouse(homeWarehouse) {
+    }
+
+    /**
+     * @brief Chooses the next transaction according to the standard mix (45/43/4/4/4)
+     */
+    TransactionKind chooseTransaction();
+
+    TransactionResult execute(TransactionKind kind, Transaction& tx);
+
+private:
+    void newOrder(Transaction& tx);
+
+    void payment(Transaction& tx);
+
+    void orderStatus(Transaction& tx);
+
+    void delivery(Transaction& tx);
+
+    void stockLevel(Transaction& tx);
+
+    /**
+     * @brief Chooses a customer by last name (60%) or id (40%) and returns its id
+     */
+    int32_t chooseCustomer(Transaction& tx, table_t customerTable, int32_t w, int32_t d);
+
+    /**
+     * @brief Chooses a remote warehouse with the given probability in percent
+     */
+    int32_t chooseWarehouse(int32_t remotePercent);
+
+    TpccRandom mRandom;
+    int32_t mWarehouses;
+    int32_t mHomeWarehouse;
+};
+
+} // namespace tpcc
+} // namespace bench
+} // namespace db
+} // namespace tell
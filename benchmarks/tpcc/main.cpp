@@ -0,0 +1,157 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Populate.hpp"
+#include "Schema.hpp"
+#include "Transactions.hpp"
+#include "../common/BenchConfig.hpp"
+
+#include <telldb/TellDB.hpp>
+#include <telldb/Transaction.hpp>
+
+#include <crossbow/allocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace tell::db::bench;
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    crossbow::string commitManager;
+    crossbow::string storageNodes;
+    uint64_t latency = 0;
+    int32_t warehouses = 1;
+    size_t numThreads = 2;
+    size_t numFibers = 4;
+    uint64_t duration = 60;
+    bool populateData = false;
+    uint64_t seed = 0;
+    auto opts = create_options("tpcc_bench",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'c'>("commit-manager", &commitManager, tag::description{"Address to the commit manager"}),
+            value<'s'>("storage-nodes", &storageNodes, tag::description{"Semicolon-separated list of storage node addresses"}),
+            value<'l'>("latency", &latency, tag::description{"Simulated round trip time in microseconds (local store only)"}),
+            value<'W'>("warehouses", &warehouses, tag::description{"Number of warehouses"}),
+            value<'t'>("threads", &numThreads, tag::description{"Number of client threads"}),
+            value<'f'>("fibers", &numFibers, tag::description{"Number of terminals per thread"}),
+            value<'d'>("duration", &duration, tag::description{"Duration of the run in seconds"}),
+            value<'p'>("populate", &populateData, tag::description{"Create and populate the database before the run"}),
+            value<'r'>("seed", &seed, tag::description{"Seed of the random number generators"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+    if (warehouses <= 0 || numThreads == 0 || numFibers == 0) {
+        print_help(std::cout, opts);
+        return 1;
+    }
+
+    crossbow::allocator::init();
+
+    auto config = createClientConfig(commitManager, storageNodes, numThreads, latency);
+    tell::db::ClientManager<void> clientManager(config);
+
+    auto numClients = numThreads * numFibers;
+    if (populateData) {
+        auto begin = Clock::now();
+        tpcc::populateDatabase(clientManager, warehouses, numClients, seed);
+        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin);
+        std::cout << "Populated " << warehouses << " warehouses in " << time.count() << "ms" << std::endl;
+    }
+
+    // Every terminal is a thread issuing one transaction at a time to the fiber on its processor
+    using Stats = std::array<tpcc::TransactionStats, tpcc::gTransactionKindCount>;
+    std::vector<Stats> stats(numClients);
+    std::vector<std::thread> clients;
+    auto begin = Clock::now();
+    auto end = begin + std::chrono::seconds(duration);
+    for (size_t i = 0; i < numClients; ++i) {
+        clients.emplace_back([&clientManager, &stats, warehouses, end, seed, numThreads, i]() {
+            tpcc::Terminal terminal(warehouses, static_cast<int32_t>(i % warehouses) + 1, seed + i);
+            auto& clientStats = stats[i];
+            while (Clock::now() < end) {
+                auto kind = terminal.chooseTransaction();
+                auto result = tpcc::TransactionResult::Aborted;
+                auto txBegin = Clock::now();
+                auto fiber = clientManager.startTransaction([&terminal, &result, kind](tell::db::Transaction& tx) {
+                    result = terminal.execute(kind, tx);
+                }, tpcc::transactionType(kind), static_cast<int>(i % numThreads));
+                fiber.wait();
+
+                auto& txStats = clientStats[static_cast<size_t>(kind)];
+                switch (result) {
+                case tpcc::TransactionResult::Committed:
+                    ++txStats.committed;
+                    txStats.latency.record(Clock::now() - txBegin);
+                    break;
+                case tpcc::TransactionResult::Aborted:
+                    ++txStats.aborted;
+                    break;
+                case tpcc::TransactionResult::RolledBack:
+                    ++txStats.rolledBack;
+                    break;
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    Stats total;
+    for (auto& clientStats : stats) {
+        for (size_t i = 0; i < tpcc::gTransactionKindCount; ++i) {
+            total[i].merge(clientStats[i]);
+        }
+    }
+
+    auto& newOrders = total[static_cast<size_t>(tpcc::TransactionKind::NewOrder)];
+    std::cout << warehouses << " warehouses with " << numThreads << " threads x " << numFibers << " terminals"
+              << std::endl;
+    std::cout << "Runtime: " << elapsed << "s" << std::endl;
+    std::cout << "tpmC: " << double(newOrders.committed) * 60.0 / elapsed << std::endl;
+    for (size_t i = 0; i < tpcc::gTransactionKindCount; ++i) {
+        auto& txStats = total[i];
+        auto attempts = txStats.committed + txStats.aborted;
+        auto name = tpcc::transactionName(static_cast<tpcc::TransactionKind>(i));
+        std::cout << name << ": committed=" << txStats.committed << " aborted=" << txStats.aborted
+                  << " rolled-back=" << txStats.rolledBack << " abort-rate="
+                  << std::fixed << std::setprecision(2)
+                  << (attempts == 0 ? 0.0 : 100.0 * double(txStats.aborted) / double(attempts)) << "%" << std::endl;
+        printLatency(std::cout, name, txStats.latency);
+    }
+    return 0;
+}
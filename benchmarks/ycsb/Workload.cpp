@@ -0,0 +1,287 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Workload.hpp"
+
+#include <telldb/Exceptions.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace ycsb {
+
+const char* operationName(Operation op) {
+    switch (op) {
+    case Operation::Read:
+        return "READ";
+    case Operation::Update:
+        return "UPDATE";
+    case Operation::Insert:
+        return "INSERT";
+    case Operation::Scan:
+        return "SCAN";
+    case Operation::ReadModifyWrite:
+        return "READ-MODIFY-WRITE";
+    }
+    return "UNKNOWN";
+}
+
+Distribution parseDistribution(const crossbow::string& name) {
+    if (name == "uniform") {
+        return Distribution::Uniform;
+    } else if (name == "zipfian") {
+        return Distribution::Zipfian;
+    } else if (name == "latest") {
+        return Distribution::Latest;
+    }
+    throw std::invalid_argument("Unknown key distribution");
+}
+
+WorkloadSpec WorkloadSpec::core(char name) {
+    // Proportions in the order read, update, insert, scan, read-modify-write
+    switch (name) {
+    case 'A':
+    case 'a':
+        return WorkloadSpec{'A', {{0.5, 0.5, 0.0, 0.0, 0.0}}, Distribution::Zipfian};
+    case 'B':
+    case 'b':
+        return WorkloadSpec{'B', {{0.95, 0.05, 0.0, 0.0, 0.0}}, Distribution::Zipfian};
+    case 'C':
+    case 'c':
+        return WorkloadSpec{'C', {{1.0, 0.0, 0.0, 0.0, 0.0}}, Distribution::Zipfian};
+    case 'D':
+    case 'd':
+        return WorkloadSpec{'D', {{0.95, 0.0, 0.05, 0.0, 0.0}}, Distribution::Latest};
+    case 'E':
+    case 'e':
+        return WorkloadSpec{'E', {{0.0, 0.0, 0.05, 0.95, 0.0}}, Distribution::Zipfian};
+    case 'F':
+    case 'f':
+        return WorkloadSpec{'F', {{0.5, 0.0, 0.0, 0.0, 0.5}}, Distribution::Zipfian};
+    default:
+        throw std::invalid_argument("Unknown workload");
+    }
+}
+
+void ClientStats::merge(const ClientStats& other) {
+    committed += other.committed;
+    aborted += other.aborted;
+    missing += other.missing;
+    for (size_t i = 0; i < operations.size(); ++i) {
+        operations[i] += other.operations[i];
+    }
+    latency.merge(other.latency);
+}
+
+constexpr const char* Workload::TABLE_NAME;
+constexpr const char* Workload::KEY_FIELD;
+constexpr const char* Workload::KEY_INDEX;
+
+Workload::Workload(const WorkloadSpec& spec, Distribution distribution, uint64_t recordCount, uint32_t fieldCount,
+        uint32_t fieldLength, uint32_t opsPerTransaction, uint32_t maxScanLength)
+        : mSpec(spec),
+          mRecordCount(recordCount),
+          mFieldCount(fieldCount),
+          mFieldLength(fieldLength),
+          mOpsPerTransaction(opsPerTransaction),
+          mMaxScanLength(maxScanLength),
+          mNextKey(recordCount),
+          mKeyBound(recordCount) {
+    mSpec.distribution = distribution;
+    for (uint32_t i = 0; i < mFieldCount; ++i) {
+        mFieldNames.emplace_back(crossbow::string("field") + boost::lexical_cast<crossbow::string>(i));
+    }
+    switch (distribution) {
+    case Distribution::Uniform:
+        mChooser.reset(new UniformChooser(recordCount));
+        break;
+    case Distribution::Zipfian:
+        mChooser.reset(new ScrambledZipfianChooser(recordCount));
+        break;
+    case Distribution::Latest:
+        mChooser.reset(new LatestChooser(mKeyBound, recordCount));
+        break;
+    }
+}
+
+void Workload::createSchema(Transaction& tx) const {
+    tell::store::Schema schema(tell::store::TableType::TRANSACTIONAL);
+    schema.addField(tell::store::FieldType::BIGINT, KEY_FIELD, true);
+    for (uint32_t i = 0; i < mFieldCount; ++i) {
+        schema.addField(tell::store::FieldType::TEXT, mFieldNames[i], true);
+    }
+    schema.addIndex(KEY_INDEX, std::make_pair(true, std::vector<tell::store::Schema::id_t>{schema.idOf(KEY_FIELD)}));
+    tx.createTable(TABLE_NAME, schema);
+}
+
+void Workload::populate(Transaction& tx, uint64_t begin, uint64_t end, Random& rng) const {
+    auto table = tx.openTable(TABLE_NAME).get();
+    for (auto key = begin; key < end; ++key) {
+        tx.insert(table, key_t{key}, createTuple(tx, table, key, rng));
+    }
+    tx.commit();
+}
+
+bool Workload::execute(Transaction& tx, Random& rng, ClientStats& stats) {
+    std::vector<uint64_t> inserted;
+    try {
+        auto table = tx.openTable(TABLE_NAME).get();
+        for (uint32_t i = 0; i < mOpsPerTransaction; ++i) {
+            auto op = chooseOperation(rng);
+            ++stats.operations[static_cast<size_t>(op)];
+            switch (op) {
+            case Operation::Read:
+                read(tx, table, rng, stats);
+                break;
+            case Operation::Update:
+                update(tx, table, rng, stats, false);
+                break;
+            case Operation::Insert:
+                inserted.push_back(insert(tx, table, rng));
+                break;
+            case Operation::Scan:
+                scan(tx, table, rng, stats);
+                break;
+            case Operation::ReadModifyWrite:
+                update(tx, table, rng, stats, true);
+                break;
+            }
+        }
+        tx.commit();
+    } catch (Conflict&) {
+        tx.rollback();
+        ++stats.aborted;
+        return false;
+    } catch (Conflicts&) {
+        tx.rollback();
+        ++stats.aborted;
+        return false;
+    } catch (IndexConflict&) {
+        tx.rollback();
+        ++stats.aborted;
+        return false;
+    }
+    ++stats.committed;
+
+    // Make the inserted keys visible to the latest distribution
+    for (auto key : inserted) {
+        auto bound = mKeyBound.load();
+        while (bound <= key && !mKeyBound.compare_exchange_weak(bound, key + 1)) {
+        }
+    }
+    return true;
+}
+
+Operation Workload::chooseOperation(Random& rng) const {
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    auto value = dist(rng);
+    for (size_t i = 0; i < gOperationCount; ++i) {
+        if (value < mSpec.proportion[i]) {
+            return static_cast<Operation>(i);
+        }
+        value -= mSpec.proportion[i];
+    }
+    return Operation::Read;
+}
+
+crossbow::string Workload::randomString(Random& rng) const {
+    std::uniform_int_distribution<int> dist('a', 'z');
+    crossbow::string result(mFieldLength, ' ');
+    for (auto& c : result) {
+        c = static_cast<char>(dist(rng));
+    }
+    return result;
+}
+
+Tuple Workload::createTuple(Transaction& tx, table_t table, uint64_t key, Random& rng) const {
+    auto tuple = tx.newTuple(table);
+    tuple[KEY_FIELD] = Field(static_cast<int64_t>(key));
+    for (uint32_t i = 0; i < mFieldCount; ++i) {
+        tuple[mFieldNames[i]] = Field(randomString(rng));
+    }
+    return tuple;
+}
+
+void Workload::read(Transaction& tx, table_t table, Random& rng, ClientStats& stats) {
+    try {
+        tx.get(table, key_t{mChooser->next(rng)}).get();
+    } catch (std::range_error&) {
+        // The key was inserted by a transaction that did not yet commit
+        ++stats.missing;
+    }
+}
+
+void Workload::update(Transaction& tx, table_t table, Random& rng, ClientStats& stats, bool allFields) {
+    key_t key{mChooser->next(rng)};
+    try {
+        auto& from = tx.get(table, key).get();
+        Tuple to = from;
+        if (allFields) {
+            for (uint32_t i = 0; i < mFieldCount; ++i) {
+                to[mFieldNames[i]] = Field(randomString(rng));
+            }
+        } else {
+            std::uniform_int_distribution<uint32_t> dist(0, mFieldCount - 1);
+            to[mFieldNames[dist(rng)]] = Field(randomString(rng));
+        }
+        tx.update(table, key, from, to);
+    } catch (std::range_error&) {
+        ++stats.missing;
+    }
+}
+
+uint64_t Workload::insert(Transaction& tx, table_t table, Random& rng) {
+    auto key = mNextKey.fetch_add(1);
+    tx.insert(table, key_t{key}, createTuple(tx, table, key, rng));
+    return key;
+}
+
+void Workload::scan(Transaction& tx, table_t table, Random& rng, ClientStats& stats) {
+    std::uniform_int_distribution<uint32_t> lengthDist(1, mMaxScanLength);
+    auto length = lengthDist(rng);
+    auto start = static_cast<int64_t>(mChooser->next(rng));
+
+    // Collect the keys from the index first so that all reads are in flight at the same time
+    std::vector<Future<Tuple>> results;
+    results.reserve(length);
+    for (auto iter = tx.lower_bound(table, KEY_INDEX, {Field(start)}); !iter.done() && results.size() < length;
+            iter.next()) {
+        results.emplace_back(tx.get(table, iter.value()));
+    }
+    for (auto& result : results) {
+        try {
+            result.get();
+        } catch (std::range_error&) {
+            ++stats.missing;
+        }
+    }
+}
+
+} // namespace ycsb
+} // namespace bench
+} // namespace db
+} // namespace tell
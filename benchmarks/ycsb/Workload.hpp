@@ -0,0 +1,172 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include "../common/KeyChooser.hpp"
+#include "../common/Statistics.hpp"
+
+#include <telldb/Transaction.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tell {
+namespace db {
+namespace bench {
+namespace ycsb {
+
+enum class Operation : uint8_t {
+    Read = 0,
+    Update,
+    Insert,
+    Scan,
+    ReadModifyWrite,
+};
+
+constexpr size_t gOperationCount = static_cast<size_t>(Operation::ReadModifyWrite) + 1;
+
+const char* operationName(Operation op);
+
+enum class Distribution : uint8_t {
+    Uniform,
+    Zipfian,
+    Latest,
+};
+
+/**
+ * @brief Parses uniform, zipfian or latest
+ *
+ * @throws std::invalid_argument If the name is unknown
+ */
+Distribution parseDistribution(const crossbow::string& name);
+
+/**
+ * @brief Operation mix and key distribution of one of the YCSB core workloads
+ */
+struct WorkloadSpec {
+    /**
+     * @brief Returns the specification of core workload A to F
+     *
+     * @throws std::invalid_argument If the name is unknown
+     */
+    static WorkloadSpec core(char name);
+
+    bool readOnly() const {
+        return proportion[static_cast<size_t>(Operation::Read)] == 1.0;
+    }
+
+    char name;
+    std::array<double, gOperationCount> proportion;
+    Distribution distribution;
+};
+
+/**
+ * @brief Counters of a single client
+ */
+struct ClientStats {
+    ClientStats() {
+        operations.fill(0x0u);
+    }
+
+    void merge(const ClientStats& other);
+
+    uint64_t committed = 0x0u;
+    uint64_t aborted = 0x0u;
+    uint64_t missing = 0x0u;
+    std::array<uint64_t, gOperationCount> operations;
+    LatencyRecorder latency;
+};
+
+/**
+ * @brief The usertable and the operations executed on it
+ *
+ * Every record has a BIGINT key field with a unique index (used by scans) and a number of TEXT fields of fixed length.
+ * Inserted keys are taken from a shared counter starting at the number of populated records.
+ */
+class Workload {
+public:
+    static constexpr const char* TABLE_NAME = "usertable";
+    static constexpr const char* KEY_FIELD = "ycsb_key";
+    static constexpr const char* KEY_INDEX = "ycsb_key_idx";
+
+    Workload(const WorkloadSpec& spec, Distribution distribution, uint64_t recordCount, uint32_t fieldCount,
+            uint32_t fieldLength, uint32_t opsPerTransaction, uint32_t maxScanLength);
+
+    const WorkloadSpec& spec() const {
+        return mSpec;
+    }
+
+    void createSchema(Transaction& tx) const;
+
+    /**
+     * @brief Inserts the records [begin, end)
+     */
+    void populate(Transaction& tx, uint64_t begin, uint64_t end, Random& rng) const;
+
+    /**
+     * @brief Executes one transaction of the workload
+     *
+     * @return Whether the transaction committed
+     */
+    bool execute(Transaction& tx, Random& rng, ClientStats& stats);
+
+private:
+    Operation chooseOperation(Random& rng) const;
+
+    crossbow::string randomString(Random& rng) const;
+
+    Tuple createTuple(Transaction& tx, table_t table, uint64_t key, Random& rng) const;
+
+    void read(Transaction& tx, table_t table, Random& rng, ClientStats& stats);
+
+    void update(Transaction& tx, table_t table, Random& rng, ClientStats& stats, bool allFields);
+
+    uint64_t insert(Transaction& tx, table_t table, Random& rng);
+
+    void scan(Transaction& tx, table_t table, Random& rng, ClientStats& stats);
+
+    WorkloadSpec mSpec;
+    uint64_t mRecordCount;
+    uint32_t mFieldCount;
+    uint32_t mFieldLength;
+    uint32_t mOpsPerTransaction;
+    uint32_t mMaxScanLength;
+
+    std::vector<crossbow::string> mFieldNames;
+
+    /// Next key to insert
+    std::atomic<uint64_t> mNextKey;
+
+    /// Upper bound of the committed keys
+    std::atomic<uint64_t> mKeyBound;
+
+    std::unique_ptr<KeyChooser> mChooser;
+};
+
+} // namespace ycsb
+} // namespace bench
+} // namespace db
+} // namespace tell
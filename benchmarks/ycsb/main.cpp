@@ -0,0 +1,197 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Workload.hpp"
+#include "../common/BenchConfig.hpp"
+
+#include <telldb/TellDB.hpp>
+#include <telldb/Transaction.hpp>
+
+#include <crossbow/allocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace tell::db::bench;
+
+namespace {
+
+constexpr uint64_t gPopulateBatchSize = 1000;
+
+void populate(tell::db::ClientManager<void>& clientManager, const ycsb::Workload& workload, uint64_t recordCount,
+        size_t numClients) {
+    auto createFiber = clientManager.startTransaction([&workload](tell::db::Transaction& tx) {
+        workload.createSchema(tx);
+        tx.commit();
+    });
+    createFiber.wait();
+
+    std::atomic<uint64_t> nextBatch(0);
+    std::vector<std::thread> clients;
+    for (size_t i = 0; i < numClients; ++i) {
+        clients.emplace_back([&clientManager, &workload, &nextBatch, recordCount, i]() {
+            Random rng(i);
+            while (true) {
+                auto begin = nextBatch.fetch_add(gPopulateBatchSize);
+                if (begin >= recordCount) {
+                    break;
+                }
+                auto end = std::min(begin + gPopulateBatchSize, recordCount);
+                auto fiber = clientManager.startTransaction([&workload, &rng, begin, end](tell::db::Transaction& tx) {
+                    workload.populate(tx, begin, end, rng);
+                });
+                fiber.wait();
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    crossbow::string commitManager;
+    crossbow::string storageNodes;
+    uint64_t latency = 0;
+    crossbow::string workloadName = "A";
+    crossbow::string distributionName;
+    uint64_t recordCount = 10000;
+    uint32_t fieldCount = 10;
+    uint32_t fieldLength = 100;
+    uint32_t opsPerTransaction = 1;
+    uint32_t maxScanLength = 100;
+    size_t numThreads = 2;
+    size_t numFibers = 4;
+    uint64_t duration = 10;
+    bool populateData = false;
+    uint64_t seed = 0;
+    auto opts = create_options("ycsb_bench",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'c'>("commit-manager", &commitManager, tag::description{"Address to the commit manager"}),
+            value<'s'>("storage-nodes", &storageNodes, tag::description{"Semicolon-separated list of storage node addresses"}),
+            value<'l'>("latency", &latency, tag::description{"Simulated round trip time in microseconds (local store only)"}),
+            value<'w'>("workload", &workloadName, tag::description{"YCSB core workload (A-F)"}),
+            value<'k'>("key-distribution", &distributionName, tag::description{"uniform, zipfian or latest (default depends on the workload)"}),
+            value<'n'>("records", &recordCount, tag::description{"Number of records"}),
+            value<'F'>("field-count", &fieldCount, tag::description{"Number of fields per record"}),
+            value<'L'>("field-length", &fieldLength, tag::description{"Length of every field in bytes"}),
+            value<'o'>("ops-per-tx", &opsPerTransaction, tag::description{"Operations per transaction"}),
+            value<'S'>("scan-length", &maxScanLength, tag::description{"Maximum number of records per scan"}),
+            value<'t'>("threads", &numThreads, tag::description{"Number of client threads"}),
+            value<'f'>("fibers", &numFibers, tag::description{"Number of concurrent transactions per thread"}),
+            value<'d'>("duration", &duration, tag::description{"Duration of the run in seconds"}),
+            value<'p'>("populate", &populateData, tag::description{"Create and populate the usertable before the run"}),
+            value<'r'>("seed", &seed, tag::description{"Seed of the random number generators"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+    if (workloadName.size() != 1 || recordCount == 0 || fieldCount == 0 || opsPerTransaction == 0
+            || maxScanLength == 0 || numThreads == 0 || numFibers == 0) {
+        print_help(std::cout, opts);
+        return 1;
+    }
+
+    auto spec = ycsb::WorkloadSpec::core(workloadName[0]);
+    auto distribution = (distributionName.empty() ? spec.distribution : ycsb::parseDistribution(distributionName));
+    ycsb::Workload workload(spec, distribution, recordCount, fieldCount, fieldLength, opsPerTransaction,
+            maxScanLength);
+
+    crossbow::allocator::init();
+
+    auto config = createClientConfig(commitManager, storageNodes, numThreads, latency);
+    tell::db::ClientManager<void> clientManager(config);
+
+    auto numClients = numThreads * numFibers;
+    if (populateData) {
+        auto begin = Clock::now();
+        populate(clientManager, workload, recordCount, numClients);
+        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin);
+        std::cout << "Populated " << recordCount << " records in " << time.count() << "ms" << std::endl;
+    }
+
+    // Every client is a thread issuing one transaction at a time to the fiber on its processor
+    auto txType = (workload.spec().readOnly() ? tell::store::TransactionType::READ_ONLY
+                                              : tell::store::TransactionType::READ_WRITE);
+    std::vector<ycsb::ClientStats> stats(numClients);
+    std::vector<std::thread> clients;
+    auto begin = Clock::now();
+    auto end = begin + std::chrono::seconds(duration);
+    for (size_t i = 0; i < numClients; ++i) {
+        clients.emplace_back([&clientManager, &workload, &stats, txType, end, seed, numThreads, i]() {
+            auto& clientStats = stats[i];
+            Random rng(seed + i);
+            while (Clock::now() < end) {
+                auto txBegin = Clock::now();
+                auto fiber = clientManager.startTransaction([&workload, &rng, &clientStats](tell::db::Transaction& tx) {
+                    workload.execute(tx, rng, clientStats);
+                }, txType, static_cast<int>(i % numThreads));
+                fiber.wait();
+                clientStats.latency.record(Clock::now() - txBegin);
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    ycsb::ClientStats total;
+    for (auto& clientStats : stats) {
+        total.merge(clientStats);
+    }
+    uint64_t totalOperations = 0;
+    for (auto count : total.operations) {
+        totalOperations += count;
+    }
+
+    std::cout << "Workload " << workload.spec().name << " with " << numThreads << " threads x " << numFibers
+              << " fibers and " << opsPerTransaction << " operations per transaction" << std::endl;
+    std::cout << "Runtime: " << elapsed << "s" << std::endl;
+    std::cout << "Throughput: " << double(total.committed) / elapsed << " tx/s "
+              << double(totalOperations) / elapsed << " ops/s" << std::endl;
+    std::cout << "Committed: " << total.committed << " Aborted: " << total.aborted << " Missing: " << total.missing
+              << std::endl;
+    for (size_t i = 0; i < ycsb::gOperationCount; ++i) {
+        if (total.operations[i] != 0) {
+            std::cout << ycsb::operationName(static_cast<ycsb::Operation>(i)) << ": " << total.operations[i]
+                      << std::endl;
+        }
+    }
+    printLatency(std::cout, "Transaction latency", total.latency);
+    return 0;
+}
@@ -0,0 +1,329 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <tellstore/ClientManager.hpp>
+
+#include <tellstore/ErrorCode.hpp>
+
+#include <crossbow/alignment.hpp>
+
+#include <boost/any.hpp>
+#include <boost/format.hpp>
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace tell {
+namespace store {
+namespace {
+
+/// Number of cycles the event processor polls before going to sleep
+constexpr uint64_t gPollCycles = 1000000;
+
+/// Size of the message header of every request and response
+constexpr size_t gHeaderSize = 32;
+
+/**
+ * @brief Serializes a generic tuple into the format of the given record
+ */
+std::vector<char> serializeTuple(const Record& record, const GenericTuple& tuple) {
+    const auto& schema = record.schema();
+    auto numFields = record.fieldCount();
+
+    size_t size = record.staticSize();
+    for (decltype(numFields) i = 0; i < numFields; ++i) {
+        auto& field = record.getFieldMeta(i).field;
+        if (field.isFixedSized()) {
+            continue;
+        }
+        auto iter = tuple.find(field.name());
+        if (iter != tuple.end()) {
+            size += boost::any_cast<const crossbow::string&>(iter->second).size();
+        }
+    }
+
+    std::vector<char> result(crossbow::align(size, 8u), 0);
+    auto dest = result.data();
+    auto varHeapOffset = record.staticSize();
+    for (decltype(numFields) i = 0; i < numFields; ++i) {
+        auto& fieldMeta = record.getFieldMeta(i);
+        auto& field = fieldMeta.field;
+        auto current = dest + fieldMeta.offset;
+        auto iter = tuple.find(field.name());
+        if (iter == tuple.end()) {
+            if (field.isNotNull()) {
+                throw std::invalid_argument((boost::format("Field %1% must not be null") % field.name()).str());
+            }
+            record.setFieldNull(dest, fieldMeta.nullIdx, true);
+            if (!field.isFixedSized()) {
+                *reinterpret_cast<uint32_t*>(current) = varHeapOffset;
+            }
+            continue;
+        }
+
+        auto& value = iter->second;
+        switch (field.type()) {
+        case FieldType::SMALLINT:
+            *reinterpret_cast<int16_t*>(current) = boost::any_cast<int16_t>(value);
+            break;
+        case FieldType::INT:
+            *reinterpret_cast<int32_t*>(current) = boost::any_cast<int32_t>(value);
+            break;
+        case FieldType::BIGINT:
+            *reinterpret_cast<int64_t*>(current) = boost::any_cast<int64_t>(value);
+            break;
+        case FieldType::FLOAT:
+            *reinterpret_cast<float*>(current) = boost::any_cast<float>(value);
+            break;
+        case FieldType::DOUBLE:
+            *reinterpret_cast<double*>(current) = boost::any_cast<double>(value);
+            break;
+        case FieldType::TEXT:
+        case FieldType::BLOB: {
+            *reinterpret_cast<uint32_t*>(current) = varHeapOffset;
+            auto& data = boost::any_cast<const crossbow::string&>(value);
+            memcpy(dest + varHeapOffset, data.c_str(), data.size());
+            varHeapOffset += data.size();
+        } break;
+        default:
+            throw std::invalid_argument((boost::format("Can not serialize field %1%") % field.name()).str());
+        }
+    }
+
+    if (!schema.varSizeFields().empty()) {
+        auto current = dest + record.staticSize() - sizeof(uint32_t);
+        *reinterpret_cast<uint32_t*>(current) = varHeapOffset;
+    }
+    return result;
+}
+
+std::vector<char> serializeTuple(const AbstractTuple& tuple) {
+    std::vector<char> result(tuple.size());
+    tuple.serialize(result.data());
+    return result;
+}
+
+} // anonymous namespace
+
+std::vector<crossbow::string> ClientConfig::parseTellStore(const crossbow::string& host) {
+    std::vector<crossbow::string> result;
+    if (host.empty()) {
+        return result;
+    }
+    size_t i = 0;
+    while (true) {
+        auto pos = host.find(';', i);
+        result.emplace_back(host.substr(i, pos - i));
+        if (pos == crossbow::string::npos) {
+            break;
+        }
+        i = pos + 1;
+    }
+    return result;
+}
+
+namespace local {
+
+Processor::Processor(Storage& storage, const StoreConfig& config, uint64_t seed)
+        : mStorage(storage),
+          mConfig(config),
+          mProcessor(gPollCycles),
+          mTaskQueue(mProcessor),
+          mLinkFree(Clock::now()),
+          mRandom(seed),
+          mConflictDist(0.0, 1.0) {
+    mProcessor.start();
+}
+
+Processor::~Processor() = default;
+
+void Processor::executeFiber(std::function<void(crossbow::infinio::Fiber&)> fun) {
+    mTaskQueue.execute([this, fun] () {
+        mProcessor.executeFiber(fun);
+    });
+}
+
+void Processor::execute(std::function<void()> fun) {
+    mTaskQueue.execute(std::move(fun));
+}
+
+Clock::time_point Processor::transfer(size_t bytes) {
+    auto now = Clock::now();
+    if (mConfig.bandwidth == 0x0u) {
+        return now;
+    }
+    auto duration = std::chrono::nanoseconds(static_cast<uint64_t>(bytes * 1000000000.0 / mConfig.bandwidth));
+    mLinkFree = std::max(now, mLinkFree) + duration;
+    return mLinkFree;
+}
+
+Clock::time_point Processor::schedule(Operation op, size_t bytes) {
+    auto latency = mConfig.latency[static_cast<size_t>(op)];
+    if (mConfig.jitter != 0x0u) {
+        latency += mRandom() % mConfig.jitter;
+    }
+    return transfer(bytes) + std::chrono::nanoseconds(latency);
+}
+
+bool Processor::injectConflict() {
+    if (mConfig.conflictProbability <= 0.0) {
+        return false;
+    }
+    return mConflictDist(mRandom) < mConfig.conflictProbability;
+}
+
+} // namespace local
+
+std::unique_ptr<commitmanager::SnapshotDescriptor> ClientHandle::startTransaction(TransactionType type) {
+    auto snapshot = mProcessor.storage().startTransaction(type);
+    waitUntil(mProcessor.schedule(local::Operation::StartTransaction, 2 * gHeaderSize));
+    return snapshot;
+}
+
+void ClientHandle::commit(const commitmanager::SnapshotDescriptor& snapshot) {
+    mProcessor.storage().commit(snapshot);
+    waitUntil(mProcessor.schedule(local::Operation::Commit, 2 * gHeaderSize));
+}
+
+Table ClientHandle::createTable(const crossbow::string& name, Schema schema) {
+    Table table;
+    auto ec = mProcessor.storage().createTable(name, schema, table);
+    waitUntil(mProcessor.schedule(local::Operation::CreateTable, 2 * gHeaderSize + name.size()));
+    if (ec) {
+        throw std::system_error(ec);
+    }
+    return table;
+}
+
+std::shared_ptr<GetTableResponse> ClientHandle::getTable(const crossbow::string& name) {
+    Table table;
+    auto ec = mProcessor.storage().getTable(name, table);
+    auto completion = mProcessor.schedule(local::Operation::GetTable, 2 * gHeaderSize + name.size());
+    return std::make_shared<GetTableResponse>(mFiber, completion, ec, std::move(table));
+}
+
+std::shared_ptr<GetResponse> ClientHandle::get(const Table& table, uint64_t key) {
+    std::unique_ptr<Tuple> tuple;
+    auto check = local::VersionCheck::version(std::numeric_limits<uint64_t>::max());
+    auto ec = mProcessor.storage().get(table.tableId(), key, check, tuple);
+    auto completion = mProcessor.schedule(local::Operation::Get, 2 * gHeaderSize + (tuple ? tuple->size() : 0));
+    return std::make_shared<GetResponse>(mFiber, completion, ec, std::move(tuple));
+}
+
+std::shared_ptr<GetResponse> ClientHandle::get(const Table& table, uint64_t key,
+        const commitmanager::SnapshotDescriptor& snapshot) {
+    std::unique_ptr<Tuple> tuple;
+    auto ec = mProcessor.storage().get(table.tableId(), key, local::VersionCheck::snapshot(snapshot), tuple);
+    auto completion = mProcessor.schedule(local::Operation::Get, 2 * gHeaderSize + (tuple ? tuple->size() : 0));
+    return std::make_shared<GetResponse>(mFiber, completion, ec, std::move(tuple));
+}
+
+std::shared_ptr<ModificationResponse> ClientHandle::insert(const Table& table, uint64_t key, uint64_t version,
+        GenericTuple data) {
+    return modification(local::Operation::Insert, table, key, local::VersionCheck::version(version),
+            serializeTuple(table.record(), data));
+}
+
+std::shared_ptr<ModificationResponse> ClientHandle::insert(const Table& table, uint64_t key,
+        const commitmanager::SnapshotDescriptor& snapshot, const AbstractTuple& tuple) {
+    return modification(local::Operation::Insert, table, key, local::VersionCheck::snapshot(snapshot),
+            serializeTuple(tuple));
+}
+
+std::shared_ptr<ModificationResponse> ClientHandle::update(const Table& table, uint64_t key, uint64_t version,
+        GenericTuple data) {
+    return modification(local::Operation::Update, table, key, local::VersionCheck::version(version),
+            serializeTuple(table.record(), data));
+}
+
+std::shared_ptr<ModificationResponse> ClientHandle::update(const Table& table, uint64_t key,
+        const commitmanager::SnapshotDescriptor& snapshot, const AbstractTuple& tuple) {
+    return modification(local::Operation::Update, table, key, local::VersionCheck::snapshot(snapshot),
+            serializeTuple(tuple));
+}
+
+std::shared_ptr<ModificationResponse> ClientHandle::remove(const Table& table, uint64_t key, uint64_t version) {
+    return modification(local::Operation::Remove, table, key, local::VersionCheck::version(version),
+            std::vector<char>());
+}
+
+std::shared_ptr<ModificationResponse> ClientHandle::remove(const Table& table, uint64_t key,
+        const commitmanager::SnapshotDescriptor& snapshot) {
+    return modification(local::Operation::Remove, table, key, local::VersionCheck::snapshot(snapshot),
+            std::vector<char>());
+}
+
+std::shared_ptr<ModificationResponse> ClientHandle::revert(const Table& table, uint64_t key,
+        const commitmanager::SnapshotDescriptor& snapshot) {
+    auto ec = mProcessor.storage().revert(table.tableId(), key, snapshot);
+    auto completion = mProcessor.schedule(local::Operation::Revert, 2 * gHeaderSize);
+    return std::make_shared<ModificationResponse>(mFiber, completion, ec);
+}
+
+std::shared_ptr<ScanIterator> ClientHandle::scan(const Table& table, const commitmanager::SnapshotDescriptor& snapshot,
+        ScanMemoryManager& memoryManager, ScanQueryType queryType, uint32_t selectionLength, const char* selection,
+        uint32_t queryLength, const char* /* query */) {
+    std::error_code ec;
+    std::vector<ScanEntry> result;
+    if (queryType != ScanQueryType::FULL) {
+        ec = std::make_error_code(std::errc::operation_not_supported);
+    } else {
+        ec = mProcessor.storage().scan(table.tableId(), snapshot, selectionLength, selection, result);
+    }
+    auto completion = mProcessor.schedule(local::Operation::Scan, 2 * gHeaderSize + selectionLength + queryLength);
+    return std::make_shared<ScanIterator>(mProcessor, mFiber, memoryManager, completion, ec, std::move(result));
+}
+
+std::shared_ptr<ModificationResponse> ClientHandle::modification(local::Operation op, const Table& table,
+        uint64_t key, const local::VersionCheck& check, std::vector<char> data) {
+    auto bytes = 2 * gHeaderSize + data.size();
+    std::error_code ec;
+    if (check.transactional() && mProcessor.injectConflict()) {
+        ec = make_error_code(error::not_in_snapshot);
+    } else {
+        auto& storage = mProcessor.storage();
+        switch (op) {
+        case local::Operation::Insert:
+            ec = storage.insert(table.tableId(), key, check, std::move(data));
+            break;
+        case local::Operation::Update:
+            ec = storage.update(table.tableId(), key, check, std::move(data));
+            break;
+        case local::Operation::Remove:
+            ec = storage.remove(table.tableId(), key, check);
+            break;
+        default:
+            throw std::logic_error("Invalid modification");
+        }
+    }
+    return std::make_shared<ModificationResponse>(mFiber, mProcessor.schedule(op, bytes), ec);
+}
+
+void ClientHandle::waitUntil(local::Clock::time_point completion) {
+    while (local::Clock::now() < completion) {
+        mFiber.yield();
+    }
+}
+
+} // namespace store
+} // namespace tell
@@ -0,0 +1,123 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <tellstore/ClientSocket.hpp>
+#include <tellstore/ClientManager.hpp>
+
+#include <crossbow/alignment.hpp>
+
+#include <cstring>
+
+namespace tell {
+namespace store {
+
+bool LocalResponse::wait() {
+    while (!done()) {
+        mFiber.yield();
+    }
+    return !mError;
+}
+
+ScanIterator::ScanIterator(local::Processor& processor, crossbow::infinio::Fiber& fiber,
+        ScanMemoryManager& memoryManager, local::Clock::time_point completion, std::error_code ec,
+        std::vector<ScanEntry> result)
+        : mProcessor(processor),
+          mFiber(fiber),
+          mMemoryManager(memoryManager),
+          mCompletion(completion),
+          mError(std::move(ec)),
+          mResult(std::move(result)),
+          mResultPos(0x0u),
+          mChunk(nullptr),
+          mChunkPos(0x0u) {
+}
+
+ScanIterator::~ScanIterator() {
+    releaseChunk();
+}
+
+bool ScanIterator::hasNext() {
+    if (mChunkPos < mChunkEntries.size()) {
+        return true;
+    }
+    wait();
+    if (mError) {
+        return false;
+    }
+    return fillChunk();
+}
+
+std::tuple<uint64_t, const char*, size_t> ScanIterator::next() {
+    return mChunkEntries.at(mChunkPos++);
+}
+
+void ScanIterator::wait() {
+    while (local::Clock::now() < mCompletion) {
+        mFiber.yield();
+    }
+}
+
+bool ScanIterator::fillChunk() {
+    releaseChunk();
+    if (mResultPos == mResult.size()) {
+        return false;
+    }
+
+    // The scan stalls if all chunks are in use by other scans
+    while ((mChunk = mMemoryManager.acquire()) == nullptr) {
+        mFiber.yield();
+    }
+
+    size_t used = 0x0u;
+    for (; mResultPos < mResult.size(); ++mResultPos) {
+        auto& entry = mResult[mResultPos];
+        auto size = entry.data.size();
+        if (used + size > mMemoryManager.chunkLength()) {
+            break;
+        }
+        memcpy(mChunk + used, entry.data.data(), size);
+        mChunkEntries.emplace_back(entry.key, mChunk + used, size);
+        used = crossbow::align(used + size, 8u);
+    }
+    if (mChunkEntries.empty()) {
+        mError = std::make_error_code(std::errc::no_buffer_space);
+        return false;
+    }
+
+    auto completion = mProcessor.transfer(used);
+    while (local::Clock::now() < completion) {
+        mFiber.yield();
+    }
+    return true;
+}
+
+void ScanIterator::releaseChunk() {
+    if (mChunk != nullptr) {
+        mMemoryManager.release(mChunk);
+        mChunk = nullptr;
+    }
+    mChunkEntries.clear();
+    mChunkPos = 0x0u;
+}
+
+} // namespace store
+} // namespace tell
@@ -0,0 +1,439 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <tellstore/LocalStorage.hpp>
+
+#include <tellstore/ErrorCode.hpp>
+#include <tellstore/StdTypes.hpp>
+
+#include <crossbow/logger.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace tell {
+namespace store {
+namespace local {
+namespace {
+
+template <typename T>
+T readValue(const char* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+template <typename T>
+bool compare(PredicateType type, T lhs, T rhs) {
+    switch (type) {
+    case PredicateType::EQUAL:
+        return lhs == rhs;
+    case PredicateType::NOT_EQUAL:
+        return lhs != rhs;
+    case PredicateType::LESS:
+        return lhs < rhs;
+    case PredicateType::LESS_EQUAL:
+        return lhs <= rhs;
+    case PredicateType::GREATER:
+        return lhs > rhs;
+    case PredicateType::GREATER_EQUAL:
+        return lhs >= rhs;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Matches a SQL LIKE pattern supporting the % and _ wildcards
+ */
+bool like(const char* str, size_t strLen, const char* pattern, size_t patternLen) {
+    size_t s = 0, p = 0;
+    size_t starP = std::numeric_limits<size_t>::max(), starS = 0;
+    while (s < strLen) {
+        if (p < patternLen && (pattern[p] == '_' || pattern[p] == str[s])) {
+            ++s;
+            ++p;
+        } else if (p < patternLen && pattern[p] == '%') {
+            starP = p++;
+            starS = s;
+        } else if (starP != std::numeric_limits<size_t>::max()) {
+            p = starP + 1;
+            s = ++starS;
+        } else {
+            return false;
+        }
+    }
+    while (p < patternLen && pattern[p] == '%') {
+        ++p;
+    }
+    return p == patternLen;
+}
+
+/**
+ * @brief Evaluates the serialized selection of a scan query against tuples of a record
+ *
+ * The selection has the layout written by ScanQuery::serializeSelection: a 16 byte header with the number of columns,
+ * the number of conjuncts and the partitioning followed by the predicates grouped by column.
+ */
+class Selection {
+public:
+    Selection(const Record& record, uint32_t length, const char* data)
+            : mRecord(record),
+              mLength(length),
+              mData(data),
+              mNumColumns(0x0u),
+              mNumConjuncts(0x0u),
+              mKeyShift(0x0u),
+              mPartitionKey(0x0u),
+              mPartitionValue(0x0u) {
+        if (mLength < 16u) {
+            return;
+        }
+        mNumColumns = readValue<uint32_t>(mData);
+        mNumConjuncts = readValue<uint16_t>(mData + 4);
+        mKeyShift = readValue<uint16_t>(mData + 6);
+        mPartitionKey = readValue<uint32_t>(mData + 8);
+        mPartitionValue = readValue<uint32_t>(mData + 12);
+    }
+
+    bool matches(uint64_t key, const char* tuple) const {
+        if (mPartitionKey != 0x0u && ((key >> mKeyShift) % mPartitionKey) != mPartitionValue) {
+            return false;
+        }
+        if (mNumConjuncts == 0x0u) {
+            return true;
+        }
+
+        std::vector<bool> conjuncts(mNumConjuncts, false);
+        auto pos = mData + 16;
+        for (decltype(mNumColumns) i = 0; i < mNumColumns; ++i) {
+            auto id = readValue<uint16_t>(pos);
+            auto numPredicates = readValue<uint16_t>(pos + 2);
+            pos += 8;
+
+            bool isNull = false;
+            FieldType type;
+            auto field = mRecord.data(tuple, id, isNull, &type);
+            for (decltype(numPredicates) j = 0; j < numPredicates; ++j) {
+                auto predicate = static_cast<PredicateType>(readValue<uint8_t>(pos));
+                auto conjunct = readValue<uint8_t>(pos + 1);
+                bool result = false;
+                switch (type) {
+                case FieldType::SMALLINT:
+                    result = !isNull && compare(predicate, readValue<int16_t>(field), readValue<int16_t>(pos + 2));
+                    pos += 8;
+                    break;
+                case FieldType::INT:
+                    result = !isNull && compare(predicate, readValue<int32_t>(field), readValue<int32_t>(pos + 4));
+                    pos += 8;
+                    break;
+                case FieldType::FLOAT:
+                    result = !isNull && compare(predicate, readValue<float>(field), readValue<float>(pos + 4));
+                    pos += 8;
+                    break;
+                case FieldType::BIGINT:
+                    result = !isNull && compare(predicate, readValue<int64_t>(field), readValue<int64_t>(pos + 8));
+                    pos += 16;
+                    break;
+                case FieldType::DOUBLE:
+                    result = !isNull && compare(predicate, readValue<double>(field), readValue<double>(pos + 8));
+                    pos += 16;
+                    break;
+                case FieldType::TEXT:
+                case FieldType::BLOB: {
+                    auto length = readValue<uint32_t>(pos + 4);
+                    auto value = pos + 8;
+                    if (!isNull) {
+                        auto offset = readValue<uint32_t>(field);
+                        auto strLength = readValue<uint32_t>(field + sizeof(uint32_t)) - offset;
+                        result = matchString(predicate, tuple + offset, strLength, value, length);
+                    }
+                    pos += 8 + length + ((length % 8 == 0) ? 0 : 8 - (length % 8));
+                } break;
+                default:
+                    pos += 8;
+                    break;
+                }
+                if (predicate == PredicateType::IS_NULL) {
+                    result = isNull;
+                } else if (predicate == PredicateType::IS_NOT_NULL) {
+                    result = !isNull;
+                }
+                if (result && conjunct < conjuncts.size()) {
+                    conjuncts[conjunct] = true;
+                }
+            }
+        }
+        return std::all_of(conjuncts.begin(), conjuncts.end(), [] (bool c) {
+            return c;
+        });
+    }
+
+private:
+    static bool matchString(PredicateType predicate, const char* str, size_t strLength, const char* value,
+            size_t length) {
+        switch (predicate) {
+        case PredicateType::LIKE:
+            return like(str, strLength, value, length);
+        case PredicateType::NOT_LIKE:
+            return !like(str, strLength, value, length);
+        default:
+            break;
+        }
+        auto res = memcmp(str, value, std::min(strLength, length));
+        if (res == 0) {
+            res = (strLength < length ? -1 : (strLength > length ? 1 : 0));
+        }
+        return compare(predicate, res, 0);
+    }
+
+    const Record& mRecord;
+    uint32_t mLength;
+    const char* mData;
+    uint32_t mNumColumns;
+    uint16_t mNumConjuncts;
+    uint16_t mKeyShift;
+    uint32_t mPartitionKey;
+    uint32_t mPartitionValue;
+};
+
+} // anonymous namespace
+
+Storage::Storage(size_t numNodes)
+        : mNumNodes(std::max<size_t>(numNodes, 1)),
+          mNextTableId(1),
+          mLastVersion(0x0u),
+          mBaseVersion(0x0u),
+          mLowestActiveVersion(1) {
+}
+
+Storage::~Storage() = default;
+
+size_t Storage::nodeOf(uint64_t tableId, uint64_t key) const {
+    return std::hash<uint64_t>()(key ^ (tableId << 48)) % mNumNodes;
+}
+
+std::error_code Storage::createTable(const crossbow::string& name, const Schema& schema, Table& result) {
+    std::lock_guard<decltype(mTablesMutex)> lock(mTablesMutex);
+    if (mTableNames.find(name) != mTableNames.end()) {
+        return std::make_error_code(std::errc::file_exists);
+    }
+    auto tableId = mNextTableId++;
+    result = Table(tableId, name, schema);
+    mTableNames.emplace(name, tableId);
+    mTables.emplace(tableId, std::unique_ptr<TableData>(new TableData(result)));
+    return std::error_code();
+}
+
+std::error_code Storage::getTable(const crossbow::string& name, Table& result) {
+    std::lock_guard<decltype(mTablesMutex)> lock(mTablesMutex);
+    auto i = mTableNames.find(name);
+    if (i == mTableNames.end()) {
+        return std::make_error_code(std::errc::no_such_file_or_directory);
+    }
+    result = mTables.at(i->second)->table;
+    return std::error_code();
+}
+
+uint64_t Storage::requestCount(const crossbow::string& name, Operation op) {
+    std::lock_guard<decltype(mTablesMutex)> lock(mTablesMutex);
+    auto i = mTableNames.find(name);
+    if (i == mTableNames.end()) {
+        return 0x0u;
+    }
+    return mTables.at(i->second)->requests[static_cast<size_t>(op)].load();
+}
+
+auto Storage::table(uint64_t tableId) -> TableData* {
+    std::lock_guard<decltype(mTablesMutex)> lock(mTablesMutex);
+    auto i = mTables.find(tableId);
+    return (i == mTables.end() ? nullptr : i->second.get());
+}
+
+std::error_code Storage::get(uint64_t tableId, uint64_t key, const VersionCheck& check,
+        std::unique_ptr<Tuple>& result) {
+    auto t = table(tableId);
+    if (!t) {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+    t->count(Operation::Get);
+    std::lock_guard<decltype(t->mutex)> lock(t->mutex);
+    auto i = t->tuples.find(key);
+    if (i == t->tuples.end()) {
+        return make_error_code(error::not_found);
+    }
+    auto& versions = i->second;
+    for (auto v = versions.rbegin(); v != versions.rend(); ++v) {
+        if (!check.inReadSet(v->version)) {
+            continue;
+        }
+        if (v->deleted) {
+            break;
+        }
+        result = Tuple::create(v->version, v == versions.rbegin(), v->data.data(), v->data.size());
+        return std::error_code();
+    }
+    return make_error_code(error::not_found);
+}
+
+std::error_code Storage::insert(uint64_t tableId, uint64_t key, const VersionCheck& check, std::vector<char> data) {
+    return write(tableId, key, check, true, false, std::move(data));
+}
+
+std::error_code Storage::update(uint64_t tableId, uint64_t key, const VersionCheck& check, std::vector<char> data) {
+    return write(tableId, key, check, false, false, std::move(data));
+}
+
+std::error_code Storage::remove(uint64_t tableId, uint64_t key, const VersionCheck& check) {
+    return write(tableId, key, check, false, true, std::vector<char>());
+}
+
+std::error_code Storage::write(uint64_t tableId, uint64_t key, const VersionCheck& check, bool isInsert, bool deleted,
+        std::vector<char> data) {
+    auto t = table(tableId);
+    if (!t) {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+    t->count(isInsert ? Operation::Insert : (deleted ? Operation::Remove : Operation::Update));
+    std::lock_guard<decltype(t->mutex)> lock(t->mutex);
+    auto i = t->tuples.find(key);
+    if (i == t->tuples.end()) {
+        if (!isInsert) {
+            return make_error_code(error::invalid_write);
+        }
+        i = t->tuples.emplace(key, VersionList()).first;
+    }
+
+    auto& versions = i->second;
+    auto version = check.writeVersion();
+    if (!versions.empty()) {
+        auto& newest = versions.back();
+        if (!check.inReadSet(newest.version)) {
+            return make_error_code(error::not_in_snapshot);
+        }
+        if (isInsert != newest.deleted) {
+            return make_error_code(error::invalid_write);
+        }
+        if (newest.version == version) {
+            newest.deleted = deleted;
+            newest.data = std::move(data);
+            return std::error_code();
+        }
+    }
+    versions.emplace_back(Element{version, deleted, std::move(data)});
+    collect(versions);
+    return std::error_code();
+}
+
+std::error_code Storage::revert(uint64_t tableId, uint64_t key, const commitmanager::SnapshotDescriptor& snapshot) {
+    auto t = table(tableId);
+    if (!t) {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+    t->count(Operation::Revert);
+    std::lock_guard<decltype(t->mutex)> lock(t->mutex);
+    auto i = t->tuples.find(key);
+    if (i == t->tuples.end() || i->second.empty() || i->second.back().version != snapshot.version()) {
+        return make_error_code(error::invalid_write);
+    }
+    i->second.pop_back();
+    if (i->second.empty()) {
+        t->tuples.erase(i);
+    }
+    return std::error_code();
+}
+
+std::error_code Storage::scan(uint64_t tableId, const commitmanager::SnapshotDescriptor& snapshot,
+        uint32_t selectionLength, const char* selection, std::vector<ScanEntry>& result) {
+    auto t = table(tableId);
+    if (!t) {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+    t->count(Operation::Scan);
+    auto check = VersionCheck::snapshot(snapshot);
+    Selection query(t->table.record(), selectionLength, selection);
+
+    std::lock_guard<decltype(t->mutex)> lock(t->mutex);
+    for (auto& tuple : t->tuples) {
+        auto& versions = tuple.second;
+        for (auto v = versions.rbegin(); v != versions.rend(); ++v) {
+            if (!check.inReadSet(v->version)) {
+                continue;
+            }
+            if (!v->deleted && query.matches(tuple.first, v->data.data())) {
+                result.emplace_back(ScanEntry{tuple.first, v->data});
+            }
+            break;
+        }
+    }
+    return std::error_code();
+}
+
+void Storage::collect(VersionList& versions) {
+    // Every version smaller than the lowest active version is visible to all running transactions, so only the
+    // newest of them has to be kept
+    auto lowestActiveVersion = mLowestActiveVersion.load();
+    auto i = versions.end();
+    for (auto v = versions.begin(); v != versions.end() && v->version < lowestActiveVersion; ++v) {
+        i = v;
+    }
+    if (i != versions.end() && i != versions.begin()) {
+        versions.erase(versions.begin(), i);
+    }
+}
+
+std::unique_ptr<commitmanager::SnapshotDescriptor> Storage::startTransaction(TransactionType /* type */) {
+    std::lock_guard<decltype(mVersionMutex)> lock(mVersionMutex);
+    auto version = ++mLastVersion;
+    mActiveVersions.emplace(version, mBaseVersion);
+    mActiveBaseVersions.insert(mBaseVersion);
+    mLowestActiveVersion.store(*mActiveBaseVersions.begin() + 1);
+
+    // Versions committed after the base version are not part of the descriptor: Transactions might read a slightly
+    // older snapshot than the commit manager would give them but the snapshot is still consistent.
+    std::vector<char> descriptor(commitmanager::SnapshotDescriptor::descriptorLength(mBaseVersion, version), 0);
+    return commitmanager::SnapshotDescriptor::create(mLowestActiveVersion.load(), mBaseVersion, version,
+            descriptor.data());
+}
+
+void Storage::commit(const commitmanager::SnapshotDescriptor& snapshot) {
+    std::lock_guard<decltype(mVersionMutex)> lock(mVersionMutex);
+    auto i = mActiveVersions.find(snapshot.version());
+    if (i == mActiveVersions.end()) {
+        LOG_ERROR("Committing unknown version %1%", snapshot.version());
+        return;
+    }
+    mActiveBaseVersions.erase(mActiveBaseVersions.find(i->second));
+    mActiveVersions.erase(i);
+
+    mCommittedVersions.insert(snapshot.version());
+    while (!mCommittedVersions.empty() && *mCommittedVersions.begin() == mBaseVersion + 1) {
+        mCommittedVersions.erase(mCommittedVersions.begin());
+        ++mBaseVersion;
+    }
+    mLowestActiveVersion.store((mActiveBaseVersions.empty() ? mBaseVersion : *mActiveBaseVersions.begin()) + 1);
+}
+
+} // namespace local
+} // namespace store
+} // namespace tell
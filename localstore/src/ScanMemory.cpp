@@ -0,0 +1,64 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <tellstore/ScanMemory.hpp>
+
+#include <crossbow/alignment.hpp>
+
+#include <stdexcept>
+
+namespace tell {
+namespace store {
+
+ScanMemoryManager::ScanMemoryManager(size_t chunkCount, size_t chunkLength)
+        : mChunkCount(chunkCount),
+          mChunkLength(crossbow::align(chunkLength, 8u)),
+          mData(new char[mChunkCount * mChunkLength]),
+          mChunksInUse(0x0u) {
+    mFreeChunks.reserve(mChunkCount);
+    for (size_t i = mChunkCount; i > 0; --i) {
+        mFreeChunks.push_back(mData.get() + (i - 1) * mChunkLength);
+    }
+}
+
+char* ScanMemoryManager::acquire() {
+    std::lock_guard<decltype(mMutex)> lock(mMutex);
+    if (mFreeChunks.empty()) {
+        return nullptr;
+    }
+    auto chunk = mFreeChunks.back();
+    mFreeChunks.pop_back();
+    ++mChunksInUse;
+    return chunk;
+}
+
+void ScanMemoryManager::release(char* chunk) {
+    if (chunk < mData.get() || chunk >= mData.get() + mChunkCount * mChunkLength) {
+        throw std::invalid_argument("Chunk does not belong to this memory manager");
+    }
+    std::lock_guard<decltype(mMutex)> lock(mMutex);
+    mFreeChunks.push_back(chunk);
+    --mChunksInUse;
+}
+
+} // namespace store
+} // namespace tell
@@ -0,0 +1,130 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/string.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tell {
+namespace store {
+namespace local {
+
+class Storage;
+
+/**
+ * @brief Remote operations known to the local storage
+ */
+enum class Operation : uint8_t {
+    Get = 0,
+    Insert,
+    Update,
+    Remove,
+    Revert,
+    Scan,
+    CreateTable,
+    GetTable,
+    StartTransaction,
+    Commit,
+};
+
+constexpr size_t gOperationCount = static_cast<size_t>(Operation::Commit) + 1;
+
+/**
+ * @brief Configuration of the in-process storage
+ *
+ * All timing parameters are simulated: the result of an operation is computed as soon as it is issued, but it only
+ * becomes visible to the issuing fiber once the simulated round trip is over. The random number generators of the
+ * storage are seeded from seed, so two runs with the same configuration and the same workload issue the same
+ * conflicts.
+ */
+struct StoreConfig {
+    StoreConfig() {
+        latency.fill(0x0u);
+    }
+
+    /**
+     * @brief Sets the round trip time for all operations
+     */
+    void setLatency(std::chrono::nanoseconds value) {
+        latency.fill(static_cast<uint64_t>(value.count()));
+    }
+
+    /**
+     * @brief Sets the round trip time for a single operation
+     */
+    void setLatency(Operation op, std::chrono::nanoseconds value) {
+        latency[static_cast<size_t>(op)] = static_cast<uint64_t>(value.count());
+    }
+
+    /// Round trip time per operation in nanoseconds
+    std::array<uint64_t, gOperationCount> latency;
+
+    /// Upper bound of the uniformly distributed latency added to every operation in nanoseconds
+    uint64_t jitter = 0x0u;
+
+    /// Bandwidth of every processor's link to the storage in bytes per second (0 means unlimited)
+    uint64_t bandwidth = 0x0u;
+
+    /// Probability that a write on a transactional table fails with a conflict
+    double conflictProbability = 0.0;
+
+    /// Seed for all random number generators of the storage
+    uint64_t seed = 0x0u;
+};
+
+} // namespace local
+
+/**
+ * @brief Client configuration for the in-process TellStore stand-in
+ *
+ * Mirrors the TellStore client configuration so that applications can switch between a real cluster and the local
+ * storage without changes. The addresses are only used to determine the number of simulated storage nodes.
+ */
+struct ClientConfig {
+    static crossbow::string parseCommitManager(const crossbow::string& host) {
+        return host;
+    }
+
+    static std::vector<crossbow::string> parseTellStore(const crossbow::string& host);
+
+    crossbow::string commitManager;
+
+    std::vector<crossbow::string> tellStore;
+
+    /// Number of processor threads executing fibers
+    size_t numNetworkThreads = 2;
+
+    /// Configuration of the simulated storage
+    local::StoreConfig local;
+
+    /// Storage shared between client managers - a new storage is created if this is not set
+    std::shared_ptr<local::Storage> storage;
+};
+
+} // namespace store
+} // namespace tell
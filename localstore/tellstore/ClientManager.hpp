@@ -0,0 +1,256 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <tellstore/AbstractTuple.hpp>
+#include <tellstore/ClientConfig.hpp>
+#include <tellstore/ClientSocket.hpp>
+#include <tellstore/GenericTuple.hpp>
+#include <tellstore/LocalStorage.hpp>
+#include <tellstore/ScanMemory.hpp>
+#include <tellstore/StdTypes.hpp>
+#include <tellstore/Table.hpp>
+#include <tellstore/TransactionType.hpp>
+
+#include <commitmanager/SnapshotDescriptor.hpp>
+
+#include <crossbow/infinio/EventProcessor.hpp>
+#include <crossbow/infinio/Fiber.hpp>
+#include <crossbow/non_copyable.hpp>
+#include <crossbow/string.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <system_error>
+#include <vector>
+
+namespace tell {
+namespace store {
+namespace local {
+
+/**
+ * @brief A client thread together with its simulated link to the storage
+ *
+ * Every processor runs its own event loop executing fibers. The link serializes all transfers of the processor, so a
+ * finite bandwidth results in queueing delay when many fibers issue requests at the same time.
+ */
+class Processor : crossbow::non_copyable, crossbow::non_movable {
+public:
+    Processor(Storage& storage, const StoreConfig& config, uint64_t seed);
+
+    ~Processor();
+
+    Storage& storage() {
+        return mStorage;
+    }
+
+    /**
+     * @brief Executes the function in a new fiber on this processor (thread safe)
+     */
+    void executeFiber(std::function<void(crossbow::infinio::Fiber&)> fun);
+
+    /**
+     * @brief Executes the function on the processor thread (thread safe)
+     */
+    void execute(std::function<void()> fun);
+
+    /**
+     * @brief Computes the completion time of a request
+     *
+     * @param op The operation
+     * @param bytes Number of bytes sent and received for the request
+     */
+    Clock::time_point schedule(Operation op, size_t bytes);
+
+    /**
+     * @brief Computes the time the link finishes transferring the given number of bytes
+     */
+    Clock::time_point transfer(size_t bytes);
+
+    /**
+     * @brief Decides whether the next transactional write fails with an injected conflict
+     */
+    bool injectConflict();
+
+private:
+    Storage& mStorage;
+    const StoreConfig& mConfig;
+
+    crossbow::infinio::EventProcessor mProcessor;
+    crossbow::infinio::TaskQueue mTaskQueue;
+
+    Clock::time_point mLinkFree;
+    std::mt19937_64 mRandom;
+    std::uniform_real_distribution<double> mConflictDist;
+};
+
+} // namespace local
+
+/**
+ * @brief Handle used by a fiber to access the local storage
+ *
+ * Provides the same operations as the TellStore client handle.
+ */
+class ClientHandle : crossbow::non_copyable, crossbow::non_movable {
+public:
+    ClientHandle(local::Processor& processor, crossbow::infinio::Fiber& fiber)
+            : mProcessor(processor),
+              mFiber(fiber) {
+    }
+
+    crossbow::infinio::Fiber& fiber() {
+        return mFiber;
+    }
+
+    local::Processor& processor() {
+        return mProcessor;
+    }
+
+    std::unique_ptr<commitmanager::SnapshotDescriptor> startTransaction(
+            TransactionType type = TransactionType::READ_WRITE);
+
+    void commit(const commitmanager::SnapshotDescriptor& snapshot);
+
+    Table createTable(const crossbow::string& name, Schema schema);
+
+    std::shared_ptr<GetTableResponse> getTable(const crossbow::string& name);
+
+    std::shared_ptr<GetResponse> get(const Table& table, uint64_t key);
+
+    std::shared_ptr<GetResponse> get(const Table& table, uint64_t key,
+            const commitmanager::SnapshotDescriptor& snapshot);
+
+    std::shared_ptr<ModificationResponse> insert(const Table& table, uint64_t key, uint64_t version,
+            GenericTuple data);
+
+    std::shared_ptr<ModificationResponse> insert(const Table& table, uint64_t key,
+            const commitmanager::SnapshotDescriptor& snapshot, const AbstractTuple& tuple);
+
+    std::shared_ptr<ModificationResponse> update(const Table& table, uint64_t key, uint64_t version,
+            GenericTuple data);
+
+    std::shared_ptr<ModificationResponse> update(const Table& table, uint64_t key,
+            const commitmanager::SnapshotDescriptor& snapshot, const AbstractTuple& tuple);
+
+    std::shared_ptr<ModificationResponse> remove(const Table& table, uint64_t key, uint64_t version);
+
+    std::shared_ptr<ModificationResponse> remove(const Table& table, uint64_t key,
+            const commitmanager::SnapshotDescriptor& snapshot);
+
+    std::shared_ptr<ModificationResponse> revert(const Table& table, uint64_t key,
+            const commitmanager::SnapshotDescriptor& snapshot);
+
+    /**
+     * @brief Starts a scan
+     *
+     * Only full scans are supported, the selection (including partitioning) is evaluated by the local storage.
+     */
+    std::shared_ptr<ScanIterator> scan(const Table& table, const commitmanager::SnapshotDescriptor& snapshot,
+            ScanMemoryManager& memoryManager, ScanQueryType queryType, uint32_t selectionLength,
+            const char* selection, uint32_t queryLength, const char* query);
+
+private:
+    std::shared_ptr<ModificationResponse> modification(local::Operation op, const Table& table, uint64_t key,
+            const local::VersionCheck& check, std::vector<char> data);
+
+    void waitUntil(local::Clock::time_point completion);
+
+    local::Processor& mProcessor;
+    crossbow::infinio::Fiber& mFiber;
+};
+
+/**
+ * @brief Client manager of the local storage
+ *
+ * Starts the processor threads and creates one context for every processor. Transactions are executed as fibers on
+ * the processors and share the context of their processor.
+ */
+template <typename Context>
+class ClientManager : crossbow::non_copyable, crossbow::non_movable {
+public:
+    template <typename... Args>
+    ClientManager(ClientConfig& config, Args... contextArgs)
+            : mConfig(config.local),
+              mStorage(config.storage ? config.storage
+                                      : std::make_shared<local::Storage>(std::max<size_t>(config.tellStore.size(), 1))),
+              mNextProcessor(0x0u) {
+        auto numProcessors = std::max<size_t>(config.numNetworkThreads, 1);
+        mContexts.reserve(numProcessors);
+        mProcessors.reserve(numProcessors);
+        for (decltype(numProcessors) i = 0; i < numProcessors; ++i) {
+            mContexts.emplace_back(new Context(contextArgs...));
+            mProcessors.emplace_back(new local::Processor(*mStorage, mConfig, mConfig.seed + i));
+        }
+    }
+
+    void shutdown() {
+        mProcessors.clear();
+    }
+
+    /**
+     * @brief Executes the function in a new fiber on any processor
+     */
+    template <typename Fun>
+    void execute(Fun fun) {
+        execute(mNextProcessor.fetch_add(1) % mProcessors.size(), std::move(fun));
+    }
+
+    /**
+     * @brief Executes the function in a new fiber on the given processor
+     */
+    template <typename Fun>
+    void execute(size_t num, Fun fun) {
+        auto& processor = *mProcessors.at(num % mProcessors.size());
+        auto& context = *mContexts.at(num % mContexts.size());
+        processor.executeFiber([&processor, &context, fun] (crossbow::infinio::Fiber& fiber) mutable {
+            ClientHandle handle(processor, fiber);
+            fun(handle, context);
+        });
+    }
+
+    std::unique_ptr<ScanMemoryManager> allocateScanMemory(size_t chunkCount, size_t chunkLength) {
+        return std::unique_ptr<ScanMemoryManager>(new ScanMemoryManager(chunkCount, chunkLength));
+    }
+
+    size_t numProcessors() const {
+        return mProcessors.size();
+    }
+
+    local::Storage& storage() {
+        return *mStorage;
+    }
+
+private:
+    local::StoreConfig mConfig;
+    std::shared_ptr<local::Storage> mStorage;
+    std::vector<std::unique_ptr<Context>> mContexts;
+    std::vector<std::unique_ptr<local::Processor>> mProcessors;
+    std::atomic<size_t> mNextProcessor;
+};
+
+} // namespace store
+} // namespace tell
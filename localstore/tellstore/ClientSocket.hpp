@@ -0,0 +1,210 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <tellstore/ErrorCode.hpp>
+#include <tellstore/ScanMemory.hpp>
+#include <tellstore/Table.hpp>
+
+#include <crossbow/infinio/Fiber.hpp>
+#include <crossbow/non_copyable.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+namespace tell {
+namespace store {
+namespace local {
+
+class Processor;
+
+using Clock = std::chrono::steady_clock;
+
+} // namespace local
+
+/**
+ * @brief Base class for all responses of the local storage
+ *
+ * The result of an operation is computed when the operation is issued, it only becomes visible after the simulated
+ * completion time passed. A fiber waiting on a response yields to the other fibers of its processor in the meantime,
+ * so outstanding requests overlap the same way they do with a real network.
+ */
+class LocalResponse : crossbow::non_copyable, crossbow::non_movable {
+public:
+    LocalResponse(crossbow::infinio::Fiber& fiber, local::Clock::time_point completion, std::error_code ec)
+            : mFiber(fiber),
+              mCompletion(completion),
+              mError(std::move(ec)) {
+    }
+
+    /**
+     * @brief Whether the response has arrived
+     */
+    bool done() const {
+        return local::Clock::now() >= mCompletion;
+    }
+
+    /**
+     * @brief Waits until the response has arrived
+     *
+     * @return True if the operation succeeded
+     */
+    bool wait();
+
+    bool waitForResult() {
+        return wait();
+    }
+
+    /**
+     * @brief Error code of the operation (waits for the response)
+     */
+    const std::error_code& error() {
+        wait();
+        return mError;
+    }
+
+protected:
+    void checkResult() {
+        if (!wait()) {
+            throw std::system_error(mError);
+        }
+    }
+
+private:
+    crossbow::infinio::Fiber& mFiber;
+    local::Clock::time_point mCompletion;
+    std::error_code mError;
+};
+
+class GetTableResponse : public LocalResponse {
+public:
+    GetTableResponse(crossbow::infinio::Fiber& fiber, local::Clock::time_point completion, std::error_code ec,
+            Table table)
+            : LocalResponse(fiber, completion, std::move(ec)),
+              mTable(std::move(table)) {
+    }
+
+    Table get() {
+        checkResult();
+        return mTable;
+    }
+
+private:
+    Table mTable;
+};
+
+class GetResponse : public LocalResponse {
+public:
+    GetResponse(crossbow::infinio::Fiber& fiber, local::Clock::time_point completion, std::error_code ec,
+            std::unique_ptr<Tuple> tuple)
+            : LocalResponse(fiber, completion, std::move(ec)),
+              mTuple(std::move(tuple)) {
+    }
+
+    std::unique_ptr<Tuple> get() {
+        checkResult();
+        return std::move(mTuple);
+    }
+
+private:
+    std::unique_ptr<Tuple> mTuple;
+};
+
+class ModificationResponse : public LocalResponse {
+public:
+    using LocalResponse::LocalResponse;
+
+    bool get() {
+        checkResult();
+        return true;
+    }
+};
+
+/**
+ * @brief A single tuple of a scan result
+ */
+struct ScanEntry {
+    uint64_t key;
+    std::vector<char> data;
+};
+
+/**
+ * @brief Iterator over the result of a scan
+ *
+ * The result is transferred chunk by chunk through the memory of the ScanMemoryManager. Every chunk is charged
+ * against the bandwidth of the processor's link when it gets filled.
+ */
+class ScanIterator : crossbow::non_copyable, crossbow::non_movable {
+public:
+    ScanIterator(local::Processor& processor, crossbow::infinio::Fiber& fiber, ScanMemoryManager& memoryManager,
+            local::Clock::time_point completion, std::error_code ec, std::vector<ScanEntry> result);
+
+    ~ScanIterator();
+
+    /**
+     * @brief Whether there are more tuples (waits for the next chunk if required)
+     */
+    bool hasNext();
+
+    /**
+     * @brief The next tuple as key, data and size
+     *
+     * The data is only valid until the next call to hasNext.
+     */
+    std::tuple<uint64_t, const char*, size_t> next();
+
+    const std::error_code& error() {
+        wait();
+        return mError;
+    }
+
+    /**
+     * @brief Waits until the scan is finished
+     */
+    void wait();
+
+private:
+    bool fillChunk();
+
+    void releaseChunk();
+
+    local::Processor& mProcessor;
+    crossbow::infinio::Fiber& mFiber;
+    ScanMemoryManager& mMemoryManager;
+    local::Clock::time_point mCompletion;
+    std::error_code mError;
+
+    std::vector<ScanEntry> mResult;
+    size_t mResultPos;
+
+    char* mChunk;
+    std::vector<std::tuple<uint64_t, const char*, size_t>> mChunkEntries;
+    size_t mChunkPos;
+};
+
+} // namespace store
+} // namespace tell
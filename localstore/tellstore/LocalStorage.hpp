@@ -0,0 +1,200 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <tellstore/ClientConfig.hpp>
+#include <tellstore/ClientSocket.hpp>
+#include <tellstore/Table.hpp>
+#include <tellstore/TransactionType.hpp>
+
+#include <commitmanager/SnapshotDescriptor.hpp>
+
+#include <crossbow/non_copyable.hpp>
+#include <crossbow/string.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace tell {
+namespace store {
+namespace local {
+
+/**
+ * @brief Describes which versions an operation can see and which version it writes
+ *
+ * Transactional operations use the snapshot of their transaction, non transactional operations behave like TellStore
+ * does for them: they see every version up to the given one and write the version after it.
+ */
+class VersionCheck {
+public:
+    static VersionCheck snapshot(const commitmanager::SnapshotDescriptor& snapshot) {
+        return VersionCheck(&snapshot, snapshot.version());
+    }
+
+    static VersionCheck version(uint64_t version) {
+        return VersionCheck(nullptr, version);
+    }
+
+    uint64_t writeVersion() const {
+        return (mSnapshot ? mVersion : mVersion + 1);
+    }
+
+    bool inReadSet(uint64_t version) const {
+        if (mSnapshot) {
+            return (version == mVersion || mSnapshot->inReadSet(version));
+        }
+        return (version <= mVersion);
+    }
+
+    bool transactional() const {
+        return mSnapshot != nullptr;
+    }
+
+private:
+    VersionCheck(const commitmanager::SnapshotDescriptor* snapshot, uint64_t version)
+            : mSnapshot(snapshot),
+              mVersion(version) {
+    }
+
+    const commitmanager::SnapshotDescriptor* mSnapshot;
+    uint64_t mVersion;
+};
+
+/**
+ * @brief In-process storage and commit manager
+ *
+ * Keeps a multi-versioned copy of every table in memory and implements the snapshot isolation rules of TellStore.
+ * All operations are synchronous and thread safe, the simulated network lives in the Processor.
+ */
+class Storage : crossbow::non_copyable, crossbow::non_movable {
+public:
+    Storage(size_t numNodes);
+
+    ~Storage();
+
+    /**
+     * @brief Number of simulated storage nodes
+     */
+    size_t numNodes() const {
+        return mNumNodes;
+    }
+
+    /**
+     * @brief The storage node responsible for the given key
+     */
+    size_t nodeOf(uint64_t tableId, uint64_t key) const;
+
+public: // Tables
+    std::error_code createTable(const crossbow::string& name, const Schema& schema, Table& result);
+
+    std::error_code getTable(const crossbow::string& name, Table& result);
+
+    /**
+     * @brief Number of requests of the given operation the table has served so far
+     *
+     * Returns 0 if the table does not exist.
+     */
+    uint64_t requestCount(const crossbow::string& name, Operation op);
+
+public: // Tuples
+    std::error_code get(uint64_t tableId, uint64_t key, const VersionCheck& check, std::unique_ptr<Tuple>& result);
+
+    std::error_code insert(uint64_t tableId, uint64_t key, const VersionCheck& check, std::vector<char> data);
+
+    std::error_code update(uint64_t tableId, uint64_t key, const VersionCheck& check, std::vector<char> data);
+
+    std::error_code remove(uint64_t tableId, uint64_t key, const VersionCheck& check);
+
+    std::error_code revert(uint64_t tableId, uint64_t key, const commitmanager::SnapshotDescriptor& snapshot);
+
+    std::error_code scan(uint64_t tableId, const commitmanager::SnapshotDescriptor& snapshot, uint32_t selectionLength,
+            const char* selection, std::vector<ScanEntry>& result);
+
+public: // Commit manager
+    std::unique_ptr<commitmanager::SnapshotDescriptor> startTransaction(TransactionType type);
+
+    void commit(const commitmanager::SnapshotDescriptor& snapshot);
+
+private:
+    struct Element {
+        uint64_t version;
+        bool deleted;
+        std::vector<char> data;
+    };
+
+    /// Versions of a tuple, the newest version is the last element
+    using VersionList = std::vector<Element>;
+
+    struct TableData {
+        TableData(Table t)
+                : table(std::move(t)) {
+            for (auto& count : requests) {
+                count.store(0x0u);
+            }
+        }
+
+        void count(Operation op) {
+            requests[static_cast<size_t>(op)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Table table;
+        std::array<std::atomic<uint64_t>, gOperationCount> requests;
+        std::mutex mutex;
+        std::unordered_map<uint64_t, VersionList> tuples;
+    };
+
+    TableData* table(uint64_t tableId);
+
+    std::error_code write(uint64_t tableId, uint64_t key, const VersionCheck& check, bool isInsert, bool deleted,
+            std::vector<char> data);
+
+    void collect(VersionList& versions);
+
+    size_t mNumNodes;
+
+    std::mutex mTablesMutex;
+    std::unordered_map<crossbow::string, uint64_t> mTableNames;
+    std::unordered_map<uint64_t, std::unique_ptr<TableData>> mTables;
+    uint64_t mNextTableId;
+
+    std::mutex mVersionMutex;
+    uint64_t mLastVersion;
+    uint64_t mBaseVersion;
+    /// Maps the version of every running transaction to the base version of its snapshot
+    std::map<uint64_t, uint64_t> mActiveVersions;
+    std::multiset<uint64_t> mActiveBaseVersions;
+    std::set<uint64_t> mCommittedVersions;
+    std::atomic<uint64_t> mLowestActiveVersion;
+};
+
+} // namespace local
+} // namespace store
+} // namespace tell
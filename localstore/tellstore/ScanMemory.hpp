@@ -0,0 +1,85 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/non_copyable.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tell {
+namespace store {
+
+/**
+ * @brief Manages the memory scan results are written to
+ *
+ * The memory is split into chunks of equal size. A running scan holds at most one chunk at a time, so the number of
+ * chunks bounds the number of concurrent scans the same way the registered RDMA buffers of the real client do.
+ */
+class ScanMemoryManager : crossbow::non_copyable, crossbow::non_movable {
+public:
+    ScanMemoryManager(size_t chunkCount, size_t chunkLength);
+
+    /**
+     * @brief Acquires a free chunk
+     *
+     * @return Pointer to the chunk or nullptr if all chunks are in use
+     */
+    char* acquire();
+
+    /**
+     * @brief Returns a chunk acquired with acquire
+     */
+    void release(char* chunk);
+
+    size_t chunkCount() const {
+        return mChunkCount;
+    }
+
+    size_t chunkLength() const {
+        return mChunkLength;
+    }
+
+    /**
+     * @brief Number of chunks currently held by scans
+     */
+    size_t chunksInUse() const {
+        return mChunksInUse.load();
+    }
+
+private:
+    size_t mChunkCount;
+    size_t mChunkLength;
+    std::unique_ptr<char[]> mData;
+
+    std::mutex mMutex;
+    std::vector<char*> mFreeChunks;
+    std::atomic<size_t> mChunksInUse;
+};
+
+} // namespace store
+} // namespace tell
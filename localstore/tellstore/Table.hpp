@@ -0,0 +1,136 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <tellstore/Record.hpp>
+#include <tellstore/StdTypes.hpp>
+
+#include <crossbow/string.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tell {
+namespace store {
+
+/**
+ * @brief A tuple as returned by the storage
+ */
+class Tuple {
+public:
+    static std::unique_ptr<Tuple> create(uint64_t version, bool isNewest, const char* data, uint32_t size) {
+        std::unique_ptr<Tuple> tuple(new Tuple(version, isNewest, size));
+        memcpy(tuple->mData.get(), data, size);
+        return tuple;
+    }
+
+    uint64_t version() const {
+        return mVersion;
+    }
+
+    bool isNewest() const {
+        return mIsNewest;
+    }
+
+    uint32_t size() const {
+        return mSize;
+    }
+
+    const char* data() const {
+        return mData.get();
+    }
+
+private:
+    Tuple(uint64_t version, bool isNewest, uint32_t size)
+            : mVersion(version),
+              mIsNewest(isNewest),
+              mSize(size),
+              mData(new char[size]) {
+    }
+
+    uint64_t mVersion;
+    bool mIsNewest;
+    uint32_t mSize;
+    std::unique_ptr<char[]> mData;
+};
+
+/**
+ * @brief Handle to a table in the storage
+ */
+class Table {
+public:
+    Table()
+            : mTableId(0x0u),
+              mRecord(Schema()) {
+    }
+
+    Table(uint64_t tableId, crossbow::string tableName, Schema schema)
+            : mTableId(tableId),
+              mTableName(std::move(tableName)),
+              mRecord(std::move(schema)) {
+    }
+
+    uint64_t tableId() const {
+        return mTableId;
+    }
+
+    const crossbow::string& tableName() const {
+        return mTableName;
+    }
+
+    const Record& record() const {
+        return mRecord;
+    }
+
+    TableType tableType() const {
+        return mRecord.schema().type();
+    }
+
+    template <typename T>
+    T field(const crossbow::string& name, const char* data) const {
+        static_assert(std::is_arithmetic<T>::value, "Only fixed size fields can be read directly");
+        Record::id_t id;
+        if (!mRecord.idOf(name, id)) {
+            throw std::logic_error("Field not found");
+        }
+
+        bool isNull = false;
+        FieldType type;
+        auto field = mRecord.data(data, id, isNull, &type);
+        if (isNull) {
+            throw std::logic_error("Field is null");
+        }
+        return *reinterpret_cast<const T*>(field);
+    }
+
+private:
+    uint64_t mTableId;
+    crossbow::string mTableName;
+    Record mRecord;
+};
+
+} // namespace store
+} // namespace tell
@@ -0,0 +1,172 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <tellstore/ClientManager.hpp>
+
+#include <crossbow/infinio/Fiber.hpp>
+#include <crossbow/non_copyable.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+
+namespace tell {
+namespace store {
+
+class TransactionRunner {
+public:
+    /**
+     * @brief Executes the function in a fiber and blocks the calling thread until it finished
+     */
+    template <typename Context, typename Fun>
+    static void executeBlocking(ClientManager<Context>& manager, Fun fun) {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool done = false;
+        manager.execute([&mutex, &cond, &done, &fun] (ClientHandle& handle, Context& context) {
+            fun(handle, context);
+            std::unique_lock<decltype(mutex)> lock(mutex);
+            done = true;
+            cond.notify_one();
+        });
+        std::unique_lock<decltype(mutex)> lock(mutex);
+        cond.wait(lock, [&done] () {
+            return done;
+        });
+    }
+};
+
+/**
+ * @brief Runs a single transaction that can be blocked and unblocked from outside
+ */
+template <typename Context>
+class SingleTransactionRunner : crossbow::non_copyable, crossbow::non_movable {
+public:
+    SingleTransactionRunner(ClientManager<Context>& manager)
+            : mManager(manager),
+              mState(State::Idle),
+              mFiber(nullptr),
+              mProcessor(nullptr) {
+    }
+
+    template <typename Fun>
+    void execute(Fun fun) {
+        prepare();
+        mManager.execute(wrap(std::move(fun)));
+    }
+
+    template <typename Fun>
+    void execute(size_t num, Fun fun) {
+        prepare();
+        mManager.execute(num, wrap(std::move(fun)));
+    }
+
+    /**
+     * @brief Waits until the transaction completes or blocks
+     *
+     * @return True if the transaction completed, false if it blocked
+     */
+    bool wait() {
+        std::unique_lock<decltype(mMutex)> lock(mMutex);
+        mCond.wait(lock, [this] () {
+            return mState != State::Running;
+        });
+        return mState != State::Blocked;
+    }
+
+    /**
+     * @brief Blocks the transaction and notifies the waiting thread
+     *
+     * Must only be called from inside the transaction.
+     */
+    void block() {
+        {
+            std::unique_lock<decltype(mMutex)> lock(mMutex);
+            mState = State::Blocked;
+            mCond.notify_all();
+        }
+        mFiber->wait();
+    }
+
+    /**
+     * @brief Resumes a blocked transaction
+     *
+     * @return Whether the transaction was blocked
+     */
+    bool unblock() {
+        {
+            std::unique_lock<decltype(mMutex)> lock(mMutex);
+            if (mState != State::Blocked) {
+                return false;
+            }
+            mState = State::Running;
+        }
+        auto fiber = mFiber;
+        mProcessor->execute([fiber] () {
+            fiber->resume();
+        });
+        return true;
+    }
+
+private:
+    enum class State {
+        Idle,
+        Running,
+        Blocked,
+        Finished,
+    };
+
+    void prepare() {
+        std::unique_lock<decltype(mMutex)> lock(mMutex);
+        if (mState == State::Running || mState == State::Blocked) {
+            throw std::logic_error("Transaction is still running");
+        }
+        mState = State::Running;
+    }
+
+    template <typename Fun>
+    std::function<void(ClientHandle&, Context&)> wrap(Fun fun) {
+        return [this, fun] (ClientHandle& handle, Context& context) mutable {
+            mFiber = &handle.fiber();
+            mProcessor = &handle.processor();
+            fun(handle, context);
+            std::unique_lock<decltype(mMutex)> lock(mMutex);
+            mState = State::Finished;
+            mCond.notify_all();
+        };
+    }
+
+    ClientManager<Context>& mManager;
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    State mState;
+
+    crossbow::infinio::Fiber* mFiber;
+    local::Processor* mProcessor;
+};
+
+} // namespace store
+} // namespace tell
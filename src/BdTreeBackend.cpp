@@ -21,6 +21,9 @@
  *     Lucas Braun <braunl@inf.ethz.ch>
  */
 #include "BdTreeBackend.hpp"
+#include "Metrics.hpp"
+#include "NodeStats.hpp"
+#include "Timeline.hpp"
 
 #include <bdtree/error_code.h>
 
@@ -67,9 +70,13 @@ BdTreeNodeData::BdTreeNodeData(store::Table& table, store::Record::id_t id, std:
 }
 
 std::unique_ptr<store::Tuple> BdTreeBaseTable::doRead(uint64_t key, std::error_code& ec) {
+    impl::TimelineRequest request(mTimeline, "read", mTable.table().tableName(), key, WaitSite::IndexRead);
+    impl::NodeRequest nodeRequest(mNodes, NodeOperation::Get, mHandle, mTable.table(), key);
     auto getFuture = mHandle.get(mTable.table(), key);
     if (getFuture->waitForResult()) {
-        return getFuture->get();
+        auto tuple = getFuture->get();
+        nodeRequest.setBytes(tuple->size());
+        return tuple;
     } else if (getFuture->error() == store::error::not_found) {
         ec = make_error_code(bdtree::error::object_doesnt_exist);
         return {nullptr};
@@ -79,7 +86,9 @@ std::unique_ptr<store::Tuple> BdTreeBaseTable::doRead(uint64_t key, std::error_c
     }
 }
 
-bool BdTreeBaseTable::doInsert(uint64_t key, store::GenericTuple tuple, std::error_code& ec) {
+bool BdTreeBaseTable::doInsert(uint64_t key, store::GenericTuple tuple, size_t bytes, std::error_code& ec) {
+    impl::TimelineRequest request(mTimeline, "insert", mTable.table().tableName(), key, WaitSite::IndexWrite);
+    impl::NodeRequest nodeRequest(mNodes, NodeOperation::Insert, mHandle, mTable.table(), key, bytes);
     auto insertFuture = mHandle.insert(mTable.table(), key, 0x0u, std::move(tuple));
     if (insertFuture->waitForResult()) {
         return true;
@@ -92,7 +101,10 @@ bool BdTreeBaseTable::doInsert(uint64_t key, store::GenericTuple tuple, std::err
     return false;
 }
 
-bool BdTreeBaseTable::doUpdate(uint64_t key, store::GenericTuple tuple, uint64_t version, std::error_code& ec) {
+bool BdTreeBaseTable::doUpdate(uint64_t key, store::GenericTuple tuple, size_t bytes, uint64_t version,
+        std::error_code& ec) {
+    impl::TimelineRequest request(mTimeline, "update", mTable.table().tableName(), key, WaitSite::IndexWrite);
+    impl::NodeRequest nodeRequest(mNodes, NodeOperation::Update, mHandle, mTable.table(), key, bytes);
     auto updateFuture = mHandle.update(mTable.table(), key, version, std::move(tuple));
     if (updateFuture->waitForResult()) {
         return true;
@@ -108,6 +120,8 @@ bool BdTreeBaseTable::doUpdate(uint64_t key, store::GenericTuple tuple, uint64_t
 }
 
 bool BdTreeBaseTable::doRemove(uint64_t key, uint64_t version, std::error_code& ec) {
+    impl::TimelineRequest request(mTimeline, "remove", mTable.table().tableName(), key, WaitSite::IndexWrite);
+    impl::NodeRequest nodeRequest(mNodes, NodeOperation::Remove, mHandle, mTable.table(), key);
     auto removeFuture = mHandle.remove(mTable.table(), key, version);
     if (removeFuture->waitForResult()) {
         return true;
@@ -131,6 +145,7 @@ store::Table BdTreePointerTable::createTable(store::ClientHandle& handle, const
 
 std::tuple<bdtree::physical_pointer, uint64_t> BdTreePointerTable::read(bdtree::logical_pointer lptr,
         std::error_code& ec) {
+    mMetrics.increment(Metric::IndexPointerReads);
     auto tuple = doRead(lptr.value, ec);
     if (!tuple)
         return std::make_tuple(bdtree::physical_pointer{0x0u}, 0x0u);
@@ -140,12 +155,12 @@ std::tuple<bdtree::physical_pointer, uint64_t> BdTreePointerTable::read(bdtree::
 }
 
 uint64_t BdTreePointerTable::insert(bdtree::logical_pointer lptr, bdtree::physical_pointer pptr, std::error_code& ec) {
-    return (doInsert(lptr.value, createPtrTuple(pptr), ec) ? 0x1u : 0x0u);
+    return (doInsert(lptr.value, createPtrTuple(pptr), sizeof(int64_t), ec) ? 0x1u : 0x0u);
 }
 
 uint64_t BdTreePointerTable::update(bdtree::logical_pointer lptr, bdtree::physical_pointer pptr, uint64_t version,
         std::error_code& ec) {
-    return (doUpdate(lptr.value, createPtrTuple(pptr), version, ec) ? version + 1 : 0x0u);
+    return (doUpdate(lptr.value, createPtrTuple(pptr), sizeof(int64_t), version, ec) ? version + 1 : 0x0u);
 }
 
 void BdTreePointerTable::remove(bdtree::logical_pointer lptr, uint64_t version, std::error_code& ec) {
@@ -164,14 +179,16 @@ store::Table BdTreeNodeTable::createTable(store::ClientHandle& handle, const cro
     return handle.createTable(name, std::move(schema));
 }
 
-BdTreeNodeTable::BdTreeNodeTable(store::ClientHandle& handle, TableData& table)
-        : BdTreeBaseTable(handle, table) {
+BdTreeNodeTable::BdTreeNodeTable(store::ClientHandle& handle, TableData& table, impl::Metrics& metrics,
+        impl::NodeStatsRecorder& nodes, impl::TransactionTimeline* timeline)
+        : BdTreeBaseTable(handle, table, metrics, nodes, timeline) {
     if (!mTable.table().record().idOf(gNodeFieldName, mNodeDataId)) {
         throw std::logic_error("Node field not found");
     }
 }
 
 BdTreeNodeData BdTreeNodeTable::read(bdtree::physical_pointer pptr, std::error_code& ec) {
+    mMetrics.increment(Metric::IndexNodeReads);
     auto tuple = doRead(pptr.value, ec);
     if (!tuple)
         return BdTreeNodeData();
@@ -180,7 +197,7 @@ BdTreeNodeData BdTreeNodeTable::read(bdtree::physical_pointer pptr, std::error_c
 }
 
 void BdTreeNodeTable::insert(bdtree::physical_pointer pptr, const char* data, size_t length, std::error_code& ec) {
-    doInsert(pptr.value, createNodeTuple(data, length), ec);
+    doInsert(pptr.value, createNodeTuple(data, length), length, ec);
 }
 
 void BdTreeNodeTable::remove(bdtree::physical_pointer pptr, std::error_code& ec) {
@@ -38,6 +38,11 @@
 
 namespace tell {
 namespace db {
+namespace impl {
+class Metrics;
+class NodeStatsRecorder;
+class TransactionTimeline;
+} // namespace impl
 
 class BdTreeNodeData {
 public:
@@ -67,15 +72,19 @@ private:
  */
 class BdTreeBaseTable {
 protected:
-    BdTreeBaseTable(store::ClientHandle& handle, TableData& table)
+    BdTreeBaseTable(store::ClientHandle& handle, TableData& table, impl::Metrics& metrics,
+            impl::NodeStatsRecorder& nodes, impl::TransactionTimeline* timeline)
             : mTable(table),
+              mMetrics(metrics),
+              mNodes(nodes),
+              mTimeline(timeline),
               mHandle(handle) {
     }
 
     ~BdTreeBaseTable() = default;
 
     uint64_t nextKey() {
-        return mTable.nextKey(mHandle);
+        return mTable.nextKey(mHandle, mTimeline);
     }
 
     uint64_t remoteKey() {
@@ -84,14 +93,23 @@ protected:
 
     std::unique_ptr<store::Tuple> doRead(uint64_t key, std::error_code& ec);
 
-    bool doInsert(uint64_t key, store::GenericTuple tuple, std::error_code& ec);
+    /**
+     * @param bytes Size of the data in the tuple
+     */
+    bool doInsert(uint64_t key, store::GenericTuple tuple, size_t bytes, std::error_code& ec);
 
-    bool doUpdate(uint64_t key, store::GenericTuple tuple, uint64_t version, std::error_code& ec);
+    bool doUpdate(uint64_t key, store::GenericTuple tuple, size_t bytes, uint64_t version, std::error_code& ec);
 
     bool doRemove(uint64_t key, uint64_t version, std::error_code& ec);
 
     TableData& mTable;
 
+    impl::Metrics& mMetrics;
+
+    impl::NodeStatsRecorder& mNodes;
+
+    impl::TransactionTimeline* mTimeline;
+
 private:
     store::ClientHandle& mHandle;
 };
@@ -103,8 +121,9 @@ class BdTreePointerTable : public bdtree::base_ptr_table<BdTreePointerTable>, pr
 public:
     static store::Table createTable(store::ClientHandle& handle, const crossbow::string& name);
 
-    BdTreePointerTable(store::ClientHandle& handle, TableData& table)
-            : BdTreeBaseTable(handle, table) {
+    BdTreePointerTable(store::ClientHandle& handle, TableData& table, impl::Metrics& metrics,
+            impl::NodeStatsRecorder& nodes, impl::TransactionTimeline* timeline)
+            : BdTreeBaseTable(handle, table, metrics, nodes, timeline) {
     }
 
     bdtree::logical_pointer get_next_ptr() {
@@ -139,7 +158,8 @@ class BdTreeNodeTable : public bdtree::base_node_table<BdTreeNodeTable, BdTreeNo
 public:
     static store::Table createTable(store::ClientHandle& handle, const crossbow::string& name);
 
-    BdTreeNodeTable(store::ClientHandle& handle, TableData& table);
+    BdTreeNodeTable(store::ClientHandle& handle, TableData& table, impl::Metrics& metrics,
+            impl::NodeStatsRecorder& nodes, impl::TransactionTimeline* timeline);
 
     bdtree::physical_pointer get_next_ptr() {
         return bdtree::physical_pointer{nextKey()};
@@ -174,9 +194,11 @@ public:
 
     using node_table = BdTreeNodeTable;
 
-    BdTreeBackend(store::ClientHandle& handle, TableData& ptrTable, TableData& nodeTable)
-            : mPtr(handle, ptrTable),
-              mNode(handle, nodeTable) {
+    BdTreeBackend(store::ClientHandle& handle, TableData& ptrTable, TableData& nodeTable, impl::Metrics& metrics,
+            impl::NodeStatsRecorder& nodes, impl::TransactionTimeline* timeline)
+            : mPtr(handle, ptrTable, metrics, nodes, timeline),
+              mNode(handle, nodeTable, metrics, nodes, timeline),
+              mMetrics(metrics) {
     }
 
     ptr_table& get_ptr_table() {
@@ -187,9 +209,14 @@ public:
         return mNode;
     }
 
+    impl::Metrics& metrics() {
+        return mMetrics;
+    }
+
 private:
     ptr_table mPtr;
     node_table mNode;
+    impl::Metrics& mMetrics;
 };
 
 } // namespace db
@@ -0,0 +1,140 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "CommitBatcher.hpp"
+#include "Metrics.hpp"
+
+#include <telldb/TellDB.hpp>
+
+#include <tellstore/ClientManager.hpp>
+
+#include <commitmanager/SnapshotDescriptor.hpp>
+
+namespace tell {
+namespace db {
+namespace impl {
+
+CommitBatcher::CommitBatcher(const ClientTable& clientTable, Metrics& metrics)
+    : mClientTable(clientTable)
+    , mMetrics(metrics)
+    , mCollecting(false)
+    , mInFlight(false)
+{}
+
+std::unique_ptr<commitmanager::SnapshotDescriptor> CommitBatcher::startTransaction(store::ClientHandle& handle,
+        store::TransactionType type) {
+    if (type == store::TransactionType::READ_ONLY && mClientTable.commitBatchingEnabled()) {
+        return startShared(handle);
+    }
+    mMetrics.increment(Metric::CommitManagerRequests);
+    return handle.startTransaction(type);
+}
+
+std::unique_ptr<commitmanager::SnapshotDescriptor> CommitBatcher::startShared(store::ClientHandle& handle) {
+    StartRequest request{nullptr, nullptr, false};
+    if (mCollecting) {
+        mBatch.push_back(&request);
+    } else {
+        mPending.push_back(&request);
+    }
+    while (!request.done) {
+        if (mCollecting || mInFlight) {
+            mStarted.wait(handle.fiber(), [this, &request] () {
+                return request.done || (!mCollecting && !mInFlight);
+            });
+            continue;
+        }
+        // Lead the next batch: give the ready fibers of the thread the chance to join before sending the request
+        mCollecting = true;
+        mBatch.swap(mPending);
+        handle.fiber().yield();
+        mCollecting = false;
+        mInFlight = true;
+        // A failed request fails the whole batch, the waiting fibers must not wait for a request that never finishes
+        std::exception_ptr error;
+        try {
+            mMetrics.increment(Metric::CommitManagerRequests);
+            share(handle, handle.startTransaction(store::TransactionType::READ_ONLY));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        for (auto r : mBatch) {
+            r->error = error;
+            r->done = true;
+        }
+        mBatch.clear();
+        mInFlight = false;
+        mStarted.notify_all();
+    }
+    if (request.error) {
+        std::rethrow_exception(request.error);
+    }
+    return std::move(request.snapshot);
+}
+
+void CommitBatcher::share(store::ClientHandle& handle, std::unique_ptr<commitmanager::SnapshotDescriptor> snapshot) {
+    auto& original = *snapshot;
+    try {
+        if (mBatch.size() > 1) {
+            auto sharers = std::make_shared<size_t>(mBatch.size());
+            for (auto r : mBatch) {
+                if (r == mBatch.front()) {
+                    mSharers.emplace(&original, sharers);
+                    continue;
+                }
+                r->snapshot = commitmanager::SnapshotDescriptor::create(original.lowestActiveVersion(),
+                        original.baseVersion(), original.version(), original.data());
+                mSharers.emplace(r->snapshot.get(), sharers);
+            }
+        }
+    } catch (...) {
+        for (auto r : mBatch) {
+            if (r->snapshot) {
+                mSharers.erase(r->snapshot.get());
+                r->snapshot.reset();
+            }
+        }
+        mSharers.erase(&original);
+        mMetrics.increment(Metric::CommitManagerRequests);
+        handle.commit(original);
+        throw;
+    }
+    mBatch.front()->snapshot = std::move(snapshot);
+}
+
+void CommitBatcher::commit(store::ClientHandle& handle, const commitmanager::SnapshotDescriptor& snapshot) {
+    auto i = mSharers.find(&snapshot);
+    if (i != mSharers.end()) {
+        auto sharers = std::move(i->second);
+        mSharers.erase(i);
+        if (--*sharers != 0) {
+            // Other transactions still read from the snapshot
+            return;
+        }
+    }
+    mMetrics.increment(Metric::CommitManagerRequests);
+    handle.commit(snapshot);
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <tellstore/TransactionType.hpp>
+
+#include <crossbow/infinio/Fiber.hpp>
+
+#include <exception>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace tell {
+namespace commitmanager {
+class SnapshotDescriptor;
+} // namespace commitmanager
+namespace store {
+class ClientHandle;
+} // namespace store
+namespace db {
+namespace impl {
+
+class ClientTable;
+class Metrics;
+
+/**
+ * @brief Coalesces the snapshot requests of the read-only transactions of all fibers of a single thread
+ *
+ * The first fiber starting a read-only transaction yields once, so the other fibers of its thread which are ready to
+ * run can join, and then requests a single snapshot from the commit manager on behalf of all of them. Fibers asking
+ * while that request is in flight wait for the next batch. The snapshot is taken after every transaction of the batch
+ * asked for one, so the snapshot semantics are the same as without batching. Read-only transactions never write with
+ * their version, so they can share it - the commit manager is notified once the last of them committed. If the request
+ * fails, every transaction of the batch fails with the same error.
+ *
+ * Read-write transactions need a version of their own and the client handle can only start or commit one transaction
+ * per request, so they always send their requests on their own. Fibers of a thread never run concurrently, so no
+ * synchronization is needed.
+ */
+class CommitBatcher {
+public:
+    CommitBatcher(const ClientTable& clientTable, Metrics& metrics);
+
+    std::unique_ptr<commitmanager::SnapshotDescriptor> startTransaction(store::ClientHandle& handle,
+            store::TransactionType type);
+
+    void commit(store::ClientHandle& handle, const commitmanager::SnapshotDescriptor& snapshot);
+
+private:
+    struct StartRequest {
+        std::unique_ptr<commitmanager::SnapshotDescriptor> snapshot;
+        std::exception_ptr error;
+        bool done;
+    };
+
+    std::unique_ptr<commitmanager::SnapshotDescriptor> startShared(store::ClientHandle& handle);
+
+    /**
+     * @brief Hands the snapshot to all requests of the batch, releases it again if that fails
+     */
+    void share(store::ClientHandle& handle, std::unique_ptr<commitmanager::SnapshotDescriptor> snapshot);
+
+    const ClientTable& mClientTable;
+    Metrics& mMetrics;
+
+    // requests of the batch collected by the current leader and of the batch after it, swapped to reuse their memory
+    std::vector<StartRequest*> mBatch;
+    std::vector<StartRequest*> mPending;
+    bool mCollecting;
+    bool mInFlight;
+    crossbow::infinio::ConditionVariable mStarted;
+
+    // number of transactions still running on a shared snapshot, by the descriptor handed to each of them (read-only
+    // transactions started apart may get the same version)
+    std::unordered_map<const commitmanager::SnapshotDescriptor*, std::shared_ptr<size_t>> mSharers;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,152 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "CommitStats.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TELLDB_HAS_TSC
+#endif
+
+namespace tell {
+namespace db {
+
+const char* commitPhaseName(CommitPhase phase) {
+    switch (phase) {
+    case CommitPhase::UndoLog:
+        return "undo-log";
+    case CommitPhase::WriteUndoLog:
+        return "write-undo-log";
+    case CommitPhase::WriteBack:
+        return "write-back";
+    case CommitPhase::WriteIndexes:
+        return "write-indexes";
+    case CommitPhase::RemoveUndoLog:
+        return "remove-undo-log";
+    case CommitPhase::Commit:
+        return "commit";
+    case CommitPhase::Total:
+        return "total";
+    }
+    return "unknown";
+}
+
+void CommitStats::merge(const CommitStats& other) {
+    for (size_t i = 0; i < gCommitPhaseCount; ++i) {
+        phases[i].merge(other.phases[i]);
+    }
+    undoLogSize += other.undoLogSize;
+    undoLogChunks += other.undoLogChunks;
+}
+
+namespace impl {
+namespace {
+
+#ifdef TELLDB_HAS_TSC
+// Spins instead of sleeping as the first conversion might happen within a fiber
+double calibrateTicksPerNano() {
+    auto begin = std::chrono::steady_clock::now();
+    auto beginTicks = __rdtsc();
+    auto end = begin;
+    while (end - begin < std::chrono::milliseconds(1)) {
+        end = std::chrono::steady_clock::now();
+    }
+    auto endTicks = __rdtsc();
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    return double(endTicks - beginTicks) / double(nanos);
+}
+#endif
+
+} // anonymous namespace
+
+uint64_t CycleClock::now() {
+#ifdef TELLDB_HAS_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+CommitProfile::Duration CycleClock::toDuration(uint64_t ticks) {
+#ifdef TELLDB_HAS_TSC
+    static const double ticksPerNano = calibrateTicksPerNano();
+    return CommitProfile::Duration(static_cast<CommitProfile::Duration::rep>(double(ticks) / ticksPerNano));
+#else
+    return CommitProfile::Duration(ticks);
+#endif
+}
+
+HistogramRecorder::HistogramRecorder()
+    : mSum(0)
+{
+    for (auto& bucket : mBuckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void HistogramRecorder::snapshot(LatencyHistogram& histogram) const {
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        auto count = mBuckets[i].load(std::memory_order_relaxed);
+        if (count != 0) {
+            histogram.add(i, count);
+        }
+    }
+    histogram.addSum(mSum.load(std::memory_order_relaxed));
+}
+
+CommitStatsRecorder::CommitStatsRecorder()
+    : mUndoLogSize(0)
+    , mUndoLogChunks(0)
+{}
+
+void CommitStatsRecorder::record(CommitPhase phase, CommitProfile::Duration duration) {
+    auto value = static_cast<uint64_t>(std::max(duration.count(), CommitProfile::Duration::rep(0)));
+    mPhases[static_cast<size_t>(phase)].record(value);
+}
+
+void CommitStatsRecorder::record(const CommitProfile& profile, CommitProfile::Duration total) {
+    record(CommitPhase::UndoLog, profile.undoLog);
+    record(CommitPhase::WriteUndoLog, profile.writeUndoLog);
+    record(CommitPhase::WriteBack, profile.writeBack);
+    record(CommitPhase::WriteIndexes, profile.writeIndexes);
+    record(CommitPhase::RemoveUndoLog, profile.removeUndoLog);
+    record(CommitPhase::Commit, profile.commit);
+    record(CommitPhase::Total, total);
+    HistogramRecorder::increment(mUndoLogSize, profile.undoLogSize);
+    HistogramRecorder::increment(mUndoLogChunks, profile.undoLogChunks);
+}
+
+void CommitStatsRecorder::snapshot(CommitStats& stats) const {
+    for (size_t i = 0; i < gCommitPhaseCount; ++i) {
+        mPhases[i].snapshot(stats.phases[i]);
+    }
+    stats.undoLogSize += mUndoLogSize.load(std::memory_order_relaxed);
+    stats.undoLogChunks += mUndoLogChunks.load(std::memory_order_relaxed);
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
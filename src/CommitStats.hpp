@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include <telldb/CommitStats.hpp>
+#include <telldb/Transaction.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace tell {
+namespace db {
+namespace impl {
+
+/**
+ * @brief Cheap timestamps for the commit phases
+ *
+ * Reads the time stamp counter on x86 and converts ticks to nanoseconds with a factor calibrated against the steady
+ * clock on first use. Falls back to the steady clock on other architectures.
+ */
+class CycleClock {
+public:
+    static uint64_t now();
+
+    static CommitProfile::Duration toDuration(uint64_t ticks);
+};
+
+/**
+ * @brief Histogram recorded by a single thread
+ *
+ * Only the owning thread records, so plain loads and stores suffice. The counters are atomic so that snapshots can be
+ * taken from any thread at any time without locking.
+ */
+class HistogramRecorder {
+public:
+    HistogramRecorder();
+
+    void record(uint64_t value) {
+        increment(mBuckets[LatencyHistogram::indexOf(value)], 1);
+        increment(mSum, value);
+    }
+
+    /**
+     * @brief Adds the current state to the given histogram
+     */
+    void snapshot(LatencyHistogram& histogram) const;
+
+    static void increment(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, LatencyHistogram::BUCKET_COUNT> mBuckets;
+    std::atomic<uint64_t> mSum;
+};
+
+/**
+ * @brief Commit latencies recorded by a single thread
+ */
+class CommitStatsRecorder {
+public:
+    CommitStatsRecorder();
+
+    void record(const CommitProfile& profile, CommitProfile::Duration total);
+
+    /**
+     * @brief Adds the current state to the given stats
+     */
+    void snapshot(CommitStats& stats) const;
+
+private:
+    void record(CommitPhase phase, CommitProfile::Duration duration);
+
+    std::array<HistogramRecorder, gCommitPhaseCount> mPhases;
+    std::atomic<uint64_t> mUndoLogSize;
+    std::atomic<uint64_t> mUndoLogChunks;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,211 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "ConflictProfiler.hpp"
+
+#include <telldb/Exceptions.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace tell {
+namespace db {
+
+crossbow::string ConflictReport::toString() const {
+    std::ostringstream out;
+    for (auto& t : tables) {
+        out << t.first << ": " << t.second.conflicts << " conflicts in " << t.second.writes << " writes ("
+            << std::fixed << std::setprecision(2) << t.second.rate() * 100.0 << "%)" << std::endl;
+    }
+    for (auto& k : keys) {
+        out << "  " << k.table;
+        if (!k.index.empty()) {
+            out << '.' << k.index;
+        }
+        out << " key " << k.key << ": " << k.conflicts;
+        if (k.error != 0) {
+            out << " (+/- " << k.error << ")";
+        }
+        out << std::endl;
+    }
+    return crossbow::string(out.str());
+}
+
+namespace impl {
+namespace {
+
+void renderField(std::ostream& out, const Field& field) {
+    switch (field.type()) {
+    case store::FieldType::NULLTYPE:
+    case store::FieldType::NOTYPE:
+        out << "NULL";
+        break;
+    case store::FieldType::SMALLINT:
+        out << field.value<int16_t>();
+        break;
+    case store::FieldType::INT:
+        out << field.value<int32_t>();
+        break;
+    case store::FieldType::BIGINT:
+        out << field.value<int64_t>();
+        break;
+    case store::FieldType::FLOAT:
+        out << field.value<float>();
+        break;
+    case store::FieldType::DOUBLE:
+        out << field.value<double>();
+        break;
+    case store::FieldType::TEXT:
+    case store::FieldType::BLOB:
+        out << '"';
+        out.write(field.stringData(), field.stringSize());
+        out << '"';
+        break;
+    }
+}
+
+crossbow::string renderKey(const std::vector<Field>& key) {
+    std::ostringstream out;
+    out << '(';
+    for (size_t i = 0; i < key.size(); ++i) {
+        if (i != 0) {
+            out << ", ";
+        }
+        renderField(out, key[i]);
+    }
+    out << ')';
+    return crossbow::string(out.str());
+}
+
+} // anonymous namespace
+
+constexpr size_t ConflictProfiler::CAPACITY;
+
+void ConflictProfiler::written(const crossbow::string& table, uint64_t count) {
+    std::lock_guard<std::mutex> _(mMutex);
+    mTables[table].writes += count;
+}
+
+void ConflictProfiler::conflict(const crossbow::string& table, key_t key) {
+    std::lock_guard<std::mutex> _(mMutex);
+    ++mTables[table].conflicts;
+    record(table, crossbow::string(), boost::lexical_cast<crossbow::string>(key.value));
+}
+
+void ConflictProfiler::conflicts(const crossbow::string& table, const std::vector<key_t>& keys) {
+    std::lock_guard<std::mutex> _(mMutex);
+    mTables[table].conflicts += keys.size();
+    for (auto key : keys) {
+        record(table, crossbow::string(), boost::lexical_cast<crossbow::string>(key.value));
+    }
+}
+
+void ConflictProfiler::indexConflict(const crossbow::string& table, const IndexConflict& conflict) {
+    auto key = (conflict.indexKey().empty() ? boost::lexical_cast<crossbow::string>(conflict.key().value)
+            : renderKey(conflict.indexKey()));
+    std::lock_guard<std::mutex> _(mMutex);
+    ++mTables[table].conflicts;
+    record(table, conflict.indexName(), key);
+}
+
+void ConflictProfiler::record(const crossbow::string& table, const crossbow::string& index,
+        const crossbow::string& key) {
+    Id id(table, index, key);
+    auto i = mPositions.find(id);
+    if (i != mPositions.end()) {
+        ++mEntries[i->second].count;
+        return;
+    }
+    if (mEntries.size() < CAPACITY) {
+        mPositions.emplace(id, mEntries.size());
+        mEntries.emplace_back(Entry{std::move(id), 1, 0});
+        return;
+    }
+    // Replace the key with the lowest count, the new key might have been counted there
+    auto victim = std::min_element(mEntries.begin(), mEntries.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.count < rhs.count;
+    });
+    mPositions.erase(victim->id);
+    mPositions.emplace(id, static_cast<size_t>(victim - mEntries.begin()));
+    victim->error = victim->count;
+    victim->id = std::move(id);
+    ++victim->count;
+}
+
+ConflictReport ConflictProfiler::report(const std::vector<std::shared_ptr<ConflictProfiler>>& profilers,
+        size_t top) {
+    struct Merged {
+        uint64_t count = 0;
+        uint64_t error = 0;
+        // sum of the minimum counts of the full sketches that track the key
+        uint64_t trackedMinimum = 0;
+    };
+    ConflictReport report;
+    std::map<Id, Merged> merged;
+    // A key missing from a full sketch might have been counted up to the sketch's minimum count
+    uint64_t minimum = 0;
+    for (auto& profiler : profilers) {
+        std::lock_guard<std::mutex> _(profiler->mMutex);
+        for (auto& t : profiler->mTables) {
+            auto& table = report.tables[t.first];
+            table.writes += t.second.writes;
+            table.conflicts += t.second.conflicts;
+        }
+        uint64_t sketchMinimum = 0;
+        if (profiler->mEntries.size() == CAPACITY) {
+            sketchMinimum = std::min_element(profiler->mEntries.begin(), profiler->mEntries.end(),
+                    [](const Entry& lhs, const Entry& rhs) {
+                return lhs.count < rhs.count;
+            })->count;
+        }
+        minimum += sketchMinimum;
+        for (auto& entry : profiler->mEntries) {
+            auto& m = merged[entry.id];
+            m.count += entry.count;
+            m.error += entry.error;
+            m.trackedMinimum += sketchMinimum;
+        }
+    }
+    report.keys.reserve(merged.size());
+    for (auto& m : merged) {
+        auto missing = minimum - m.second.trackedMinimum;
+        ContendedKey key;
+        std::tie(key.table, key.index, key.key) = m.first;
+        key.conflicts = m.second.count + missing;
+        key.error = m.second.error + missing;
+        report.keys.emplace_back(std::move(key));
+    }
+    std::sort(report.keys.begin(), report.keys.end(), [](const ContendedKey& lhs, const ContendedKey& rhs) {
+        return lhs.conflicts > rhs.conflicts;
+    });
+    if (report.keys.size() > top) {
+        report.keys.resize(top);
+    }
+    return report;
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,93 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include <telldb/ConflictReport.hpp>
+#include <telldb/Types.hpp>
+
+#include <crossbow/string.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace tell {
+namespace db {
+
+class IndexConflict;
+
+namespace impl {
+
+/**
+ * @brief Conflicts seen by a single thread
+ *
+ * Keeps the number of written tuples and conflicts per table and a space-saving sketch of the conflicting keys: the
+ * sketch tracks up to CAPACITY keys, a new key replaces the key with the lowest count and inherits its count as error.
+ * Conflicts are rare compared to the requests they cost, so the profiler is protected by a mutex that is only
+ * contended while a report is taken.
+ */
+class ConflictProfiler {
+public:
+    /// Number of keys tracked by every thread
+    static constexpr size_t CAPACITY = 256;
+
+    ConflictProfiler() = default;
+
+    void written(const crossbow::string& table, uint64_t count);
+
+    /**
+     * @brief Records a conflict on the tuple with the given key
+     */
+    void conflict(const crossbow::string& table, key_t key);
+
+    void conflicts(const crossbow::string& table, const std::vector<key_t>& keys);
+
+    void indexConflict(const crossbow::string& table, const IndexConflict& conflict);
+
+    /**
+     * @brief Merges the profiles of all threads into a report with the given number of keys
+     */
+    static ConflictReport report(const std::vector<std::shared_ptr<ConflictProfiler>>& profilers, size_t top);
+
+private:
+    using Id = std::tuple<crossbow::string, crossbow::string, crossbow::string>;
+
+    struct Entry {
+        Id id;
+        uint64_t count;
+        uint64_t error;
+    };
+
+    void record(const crossbow::string& table, const crossbow::string& index, const crossbow::string& key);
+
+    mutable std::mutex mMutex;
+    std::vector<Entry> mEntries;
+    std::map<Id, size_t> mPositions;
+    std::map<crossbow::string, TableConflicts> mTables;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -88,9 +88,23 @@ Conflict::Conflict(key_t key)
 
 IndexConflict::IndexConflict(key_t key, const crossbow::string& idxName)
     : KeyException(key, "Index error on " + idxName)
+    , idxName(idxName)
+{}
+IndexConflict::IndexConflict(key_t key, const crossbow::string& idxName, std::vector<Field> indexKey)
+    : KeyException(key, "Index error on " + idxName)
+    , idxName(idxName)
+    , mIndexKey(std::move(indexKey))
 {}
 IndexConflict::~IndexConflict() {}
 
+const crossbow::string& IndexConflict::indexName() const noexcept {
+    return idxName;
+}
+
+const std::vector<Field>& IndexConflict::indexKey() const noexcept {
+    return mIndexKey;
+}
+
 void Conflicts::init() {
     std::stringstream ss;
     ss << "Conflicts on the following keys:";
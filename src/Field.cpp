@@ -25,6 +25,7 @@
 #include <crossbow/logger.hpp>
 
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 #include <stdexcept>
 
 
@@ -33,27 +34,35 @@ using namespace tell::store;
 namespace tell {
 namespace db {
 
+constexpr size_t Field::INLINE_SIZE;
+constexpr uint8_t Field::OUT_OF_LINE;
+
 bool Field::operator< (const Field& rhs) const {
     if (mType != rhs.mType) {
         throw std::invalid_argument("Can only compare fields of same type");
     }
-    switch (mType) {
+    switch (type()) {
     case FieldType::NULLTYPE:
         return false;
     case FieldType::NOTYPE:
         throw std::invalid_argument("Can not compare fields without types");
     case FieldType::SMALLINT:
-        return smallint < rhs.smallint;
+        return value<int16_t>() < rhs.value<int16_t>();
     case FieldType::INT:
-        return normalint < rhs.normalint;
+        return value<int32_t>() < rhs.value<int32_t>();
     case FieldType::BIGINT:
-        return bigint < rhs.bigint;
+        return value<int64_t>() < rhs.value<int64_t>();
     case FieldType::FLOAT:
-        return floatNr < rhs.floatNr;
+        return value<float>() < rhs.value<float>();
     case FieldType::DOUBLE:
-        return doubleNr < rhs.doubleNr;
-    case FieldType::TEXT:
-        return str < rhs.str;
+        return value<double>() < rhs.value<double>();
+    case FieldType::TEXT: {
+        // Same order as crossbow::string: bytewise, a prefix is smaller than the longer string
+        auto size = stringSize();
+        auto rhsSize = rhs.stringSize();
+        auto res = memcmp(stringData(), rhs.stringData(), std::min(size, rhsSize));
+        return (res < 0 || (res == 0 && size < rhsSize));
+    }
     case FieldType::BLOB:
         throw std::invalid_argument("Can not compare BLOBs");
     }
@@ -78,32 +87,49 @@ bool Field::operator==(const Field& rhs) const {
 }
 
 Field& Field::operator+= (const Field& rhs) {
-    if (mType != rhs.type()) {
+    if (mType != rhs.mType) {
         throw std::invalid_argument("Can only add Fields of same type");
     }
-    switch (mType) {
+    switch (type()) {
     case FieldType::NULLTYPE:
         return *this;
     case FieldType::NOTYPE:
         throw std::invalid_argument("Can not compare fields without types");
     case FieldType::SMALLINT:
-        smallint += rhs.smallint;
+        value<int16_t>() += rhs.value<int16_t>();
         return *this;
     case FieldType::INT:
-        normalint += rhs.normalint;
+        value<int32_t>() += rhs.value<int32_t>();
         return *this;
     case FieldType::BIGINT:
-        bigint += rhs.bigint;
+        value<int64_t>() += rhs.value<int64_t>();
         return *this;
     case FieldType::FLOAT:
-        floatNr += rhs.floatNr;
+        value<float>() += rhs.value<float>();
         return *this;
     case FieldType::DOUBLE:
-        doubleNr += rhs.doubleNr;
+        value<double>() += rhs.value<double>();
         return *this;
-    case FieldType::TEXT:
-        str += rhs.str;
+    case FieldType::TEXT: {
+        auto size = stringSize();
+        auto rhsSize = rhs.stringSize();
+        if (size + rhsSize <= INLINE_SIZE) {
+            memcpy(mData + size, rhs.stringData(), rhsSize);
+            mInlineSize = uint8_t(size + rhsSize);
+            return *this;
+        }
+        // rhs might be this field, so both parts are copied before the old string is freed
+        auto longStr = new char[size + rhsSize];
+        memcpy(longStr, stringData(), size);
+        memcpy(longStr + size, rhs.stringData(), rhsSize);
+        if (mInlineSize == OUT_OF_LINE) {
+            delete[] longData();
+        }
+        new (mData) char*(longStr);
+        new (mData + sizeof(char*)) uint32_t(uint32_t(size + rhsSize));
+        mInlineSize = OUT_OF_LINE;
         return *this;
+    }
     case FieldType::BLOB:
         throw std::invalid_argument("Can not calc minus on TEXT or BLOB");
     }
@@ -112,28 +138,28 @@ Field& Field::operator+= (const Field& rhs) {
 }
 
 Field& Field::operator-= (const Field& rhs) {
-    if (mType != rhs.type()) {
+    if (mType != rhs.mType) {
         throw std::invalid_argument("Can only add Fields of same type");
     }
-    switch (mType) {
+    switch (type()) {
     case FieldType::NULLTYPE:
         return *this;
     case FieldType::NOTYPE:
         throw std::invalid_argument("Can not compare fields without types");
     case FieldType::SMALLINT:
-        smallint -= rhs.smallint;
+        value<int16_t>() -= rhs.value<int16_t>();
         return *this;
     case FieldType::INT:
-        normalint -= rhs.normalint;
+        value<int32_t>() -= rhs.value<int32_t>();
         return *this;
     case FieldType::BIGINT:
-        bigint -= rhs.normalint;
+        value<int64_t>() -= rhs.value<int64_t>();
         return *this;
     case FieldType::FLOAT:
-        floatNr -= rhs.floatNr;
+        value<float>() -= rhs.value<float>();
         return *this;
     case FieldType::DOUBLE:
-        doubleNr -= rhs.doubleNr;
+        value<double>() -= rhs.value<double>();
         return *this;
     case FieldType::TEXT:
     case FieldType::BLOB:
@@ -143,6 +169,14 @@ Field& Field::operator-= (const Field& rhs) {
     throw std::runtime_error("This should be unreachable code - something went horribly wrong!!");
 }
 
+void Field::setString(const char* data, size_t size) {
+    if (type() != FieldType::TEXT && type() != FieldType::BLOB) {
+        throw std::invalid_argument("Can only set strings of TEXT or BLOB fields");
+    }
+    // data might point into this field, so it is copied before the old string is freed
+    *this = Field(type(), data, size);
+}
+
 Field Field::operator+(const Field& rhs) const {
     Field res = *this;
     res += rhs;
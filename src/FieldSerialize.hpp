@@ -25,6 +25,9 @@
 #include <telldb/Field.hpp>
 #include <crossbow/serializer/Serializer.hpp>
 
+#include <cstdint>
+#include <cstring>
+
 namespace crossbow {
 
 template<class Archiver>
@@ -50,7 +53,7 @@ struct size_policy<Archiver, tell::db::Field>
             return res + 8;
         case tell::store::FieldType::TEXT:
         case tell::store::FieldType::BLOB:
-            return res + 4 + field.value<crossbow::string>().size();
+            return res + 4 + field.stringSize();
         }
         assert(false);
         throw std::runtime_error("Unreachable code!");
@@ -83,7 +86,12 @@ struct serialize_policy<Archiver, tell::db::Field>
             break;
         case tell::store::FieldType::TEXT:
         case tell::store::FieldType::BLOB:
-            ar & field.value<crossbow::string>();
+            {
+                uint32_t size = uint32_t(field.stringSize());
+                ar & size;
+                memcpy(ar.pos, field.stringData(), size);
+                ar.pos += size;
+            }
             break;
         }
         return ar.pos;
@@ -140,9 +148,10 @@ struct deserialize_policy<Archiver, tell::db::Field>
         case tell::store::FieldType::TEXT:
         case tell::store::FieldType::BLOB:
             {
-                crossbow::string value;
-                ar & value;
-                field = tell::db::Field(value);
+                uint32_t size;
+                ar & size;
+                field = tell::db::Field(type, reinterpret_cast<const char*>(ar.pos), size);
+                ar.pos += size;
             }
             break;
         }
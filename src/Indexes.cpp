@@ -22,6 +22,8 @@
  */
 #include "Indexes.hpp"
 #include "FieldSerialize.hpp"
+#include "Metrics.hpp"
+#include "Probes.hpp"
 #include <telldb/Exceptions.hpp>
 #include <exception>
 
@@ -66,6 +68,7 @@ Iterator::Iterator(std::unique_ptr<IteratorImpl> impl)
 
 Iterator::Iterator(const Iterator& other)
     : mImpl(other.mImpl->copy())
+    , mTraceCount(other.mTraceCount)
 {
 }
 
@@ -73,6 +76,7 @@ Iterator::Iterator(Iterator&&) = default;
 
 Iterator& Iterator::operator=(const Iterator& other) {
     mImpl.reset(other.mImpl->copy());
+    mTraceCount = other.mTraceCount;
     return *this;
 }
 
@@ -84,6 +88,9 @@ bool Iterator::done() const {
 
 void Iterator::next() {
     mImpl->next();
+    if (mTraceCount) {
+        ++(*mTraceCount);
+    }
 }
 
 const KeyType& Iterator::key() const {
@@ -229,6 +236,8 @@ void IndexWrapper::remove(key_t key, const Tuple& tuple) {
 }
 
 auto IndexWrapper::lower_bound(const KeyType& key) -> tell::db::Iterator {
+    mBackend->metrics().increment(Metric::IndexLookups);
+    TELLDB_PROBE2(index__traverse, mName.c_str(), 0);
     std::unique_ptr<CacheIteratorImpl> cIter(new BdTree::StdIter<Cache::iterator>(
                 IteratorDirection::Forward,
                 mCache.lower_bound(key),
@@ -238,6 +247,8 @@ auto IndexWrapper::lower_bound(const KeyType& key) -> tell::db::Iterator {
 }
 
 auto IndexWrapper::reverse_lower_bound(const KeyType& key) -> tell::db::Iterator {
+    mBackend->metrics().increment(Metric::IndexLookups);
+    TELLDB_PROBE2(index__traverse, mName.c_str(), 1);
     auto iter = mCache.lower_bound(key);
     auto rIter = std::reverse_iterator<Cache::iterator>(iter);
     if (iter == mCache.end()) {
@@ -257,16 +268,19 @@ void IndexWrapper::writeBack() {
     for (auto& op : mCache) {
         bool res;
         if (std::get<2>(op.second)) continue;
+        mBackend->metrics().increment(Metric::IndexModifications);
         switch (std::get<0>(op.second)) {
         case IndexOperation::Insert:
+            TELLDB_PROBE2(index__traverse, mName.c_str(), 2);
             res = mBdTree->insert(op.first, std::get<1>(op.second));
             break;
         case IndexOperation::Delete:
+            TELLDB_PROBE2(index__traverse, mName.c_str(), 3);
             res = mBdTree->erase(op.first, std::get<1>(op.second));
             break;
         }
         if (!res) {
-            throw IndexConflict(std::get<1>(op.second), mName);
+            throw IndexConflict(std::get<1>(op.second), mName, op.first);
         }
         std::get<2>(op.second) = true;
     }
@@ -284,6 +298,7 @@ void IndexWrapper::undo() {
             mBdTree->revertErase(op.first, std::get<1>(op.second));
             break;
         }
+        std::get<2>(op.second) = false;
     }
 }
 
@@ -298,7 +313,10 @@ std::vector<Field> IndexWrapper::keyOf(const Tuple& tuple) {
 
 Indexes::IndexTables::~IndexTables() = default;
 
-Indexes::Indexes(store::ClientHandle& handle) {
+Indexes::Indexes(store::ClientHandle& handle, Metrics& metrics, NodeStatsRecorder& nodes)
+    : mMetrics(metrics)
+    , mNodes(nodes)
+{
     auto tableRes = handle.getTable("__counter");
     if (tableRes->error()) {
         mCounterTable = RemoteCounter::createTable(handle, "__counter");
@@ -308,7 +326,8 @@ Indexes::Indexes(store::ClientHandle& handle) {
 }
 
 std::unordered_map<crossbow::string, IndexWrapper>
-Indexes::openIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle& handle, const store::Table& table) {
+Indexes::openIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle& handle, const store::Table& table,
+        TransactionTimeline* timeline) {
     std::unordered_map<crossbow::string, IndexWrapper> res;
     auto iter = mIndexes.find(table_t{table.tableId()});
     if (iter != mIndexes.end()) {
@@ -321,7 +340,10 @@ Indexes::openIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle& ha
                         BdTreeBackend(
                             handle,
                             idx.second->ptrTable,
-                            idx.second->nodeTable),
+                            idx.second->nodeTable,
+                            mMetrics,
+                            mNodes,
+                            timeline),
                         snapshot,
                         false));
         }
@@ -359,8 +381,8 @@ Indexes::openIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle& ha
         auto insRes = indexMap.emplace(std::get<0>(*it),
                 new IndexTables{
                     *std::get<1>(*it),
-                    TableData(std::get<3>(*it)->get(), mCounterTable),
-                    TableData(std::get<2>(*it)->get(), mCounterTable)
+                    TableData(std::get<3>(*it)->get(), mCounterTable, mMetrics),
+                    TableData(std::get<2>(*it)->get(), mCounterTable, mMetrics)
                 });
         res.emplace(std::get<0>(*it),
                 IndexWrapper(
@@ -370,7 +392,10 @@ Indexes::openIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle& ha
                     BdTreeBackend(
                         handle,
                         insRes.first->second->ptrTable,
-                        insRes.first->second->nodeTable),
+                        insRes.first->second->nodeTable,
+                        mMetrics,
+                        mNodes,
+                        timeline),
                     snapshot,
                     false));
     }
@@ -379,7 +404,8 @@ Indexes::openIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle& ha
 }
 
 std::unordered_map<crossbow::string, IndexWrapper>
-Indexes::createIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle& handle, const store::Table& table) {
+Indexes::createIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle& handle, const store::Table& table,
+        TransactionTimeline* timeline) {
     std::unordered_map<crossbow::string, IndexWrapper> res;
     const auto& indexes = table.record().schema().indexes();
     std::unordered_map<crossbow::string, IndexTables*> indexMap;
@@ -388,8 +414,10 @@ Indexes::createIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle&
         crossbow::string ptrTableName = "__index_ptrs_" + idx.first;
         auto insRes = indexMap.emplace(idx.first,
                 new IndexTables{idx.second,
-                                TableData(BdTreePointerTable::createTable(handle, ptrTableName), mCounterTable),
-                                TableData(BdTreeNodeTable::createTable(handle, nodeTableName), mCounterTable)});
+                                TableData(BdTreePointerTable::createTable(handle, ptrTableName), mCounterTable,
+                                        mMetrics),
+                                TableData(BdTreeNodeTable::createTable(handle, nodeTableName), mCounterTable,
+                                        mMetrics)});
         res.emplace(idx.first,
                 IndexWrapper(
                     idx.first,
@@ -398,7 +426,10 @@ Indexes::createIndexes(const SnapshotDescriptor& snapshot, store::ClientHandle&
                     BdTreeBackend(
                         handle,
                         insRes.first->second->ptrTable,
-                        insRes.first->second->nodeTable),
+                        insRes.first->second->nodeTable,
+                        mMetrics,
+                        mNodes,
+                        timeline),
                     snapshot,
                     true));
     }
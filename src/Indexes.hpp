@@ -534,19 +534,23 @@ public: // types
         TableData nodeTable;
     };
 private: // members
+    Metrics& mMetrics;
+    NodeStatsRecorder& mNodes;
     std::shared_ptr<store::Table> mCounterTable;
     std::unordered_map<table_t, std::unordered_map<crossbow::string, IndexTables*>> mIndexes;
 public:
-    Indexes(store::ClientHandle& handle);
+    Indexes(store::ClientHandle& handle, Metrics& metrics, NodeStatsRecorder& nodes);
 public:
     std::unordered_map<crossbow::string, IndexWrapper> openIndexes(
             const commitmanager::SnapshotDescriptor& snapshot,
             store::ClientHandle& handle,
-            const store::Table& table);
+            const store::Table& table,
+            TransactionTimeline* timeline);
     std::unordered_map<crossbow::string, IndexWrapper> createIndexes(
             const commitmanager::SnapshotDescriptor& snapshot,
             store::ClientHandle& handle,
-            const store::Table& table);
+            const store::Table& table,
+            TransactionTimeline* timeline);
 };
 
 } // namespace impl
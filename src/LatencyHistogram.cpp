@@ -0,0 +1,142 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <telldb/LatencyHistogram.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace tell {
+namespace db {
+
+constexpr unsigned LatencyHistogram::SUB_BUCKET_BITS;
+constexpr size_t LatencyHistogram::SUB_BUCKET_COUNT;
+constexpr size_t LatencyHistogram::SUB_BUCKET_HALF;
+constexpr size_t LatencyHistogram::BUCKET_COUNT;
+
+size_t LatencyHistogram::indexOf(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    // Shift the value so that it falls into the upper half of the sub-buckets
+    auto shift = static_cast<unsigned>(64 - __builtin_clzll(value)) - SUB_BUCKET_BITS;
+    return SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF + static_cast<size_t>((value >> shift) - SUB_BUCKET_HALF);
+}
+
+uint64_t LatencyHistogram::lowestEquivalent(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    auto shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + 1;
+    uint64_t subBucket = (index - SUB_BUCKET_COUNT) % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+    return subBucket << shift;
+}
+
+uint64_t LatencyHistogram::highestEquivalent(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    auto shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + 1;
+    uint64_t subBucket = (index - SUB_BUCKET_COUNT) % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+LatencyHistogram::LatencyHistogram()
+    : mBuckets(BUCKET_COUNT, 0)
+    , mCount(0)
+    , mSum(0)
+    , mMin(std::numeric_limits<uint64_t>::max())
+    , mMax(0)
+{}
+
+void LatencyHistogram::record(uint64_t value) {
+    ++mBuckets[indexOf(value)];
+    ++mCount;
+    mSum += value;
+    mMin = std::min(mMin, value);
+    mMax = std::max(mMax, value);
+}
+
+void LatencyHistogram::recordCorrected(uint64_t value, uint64_t expectedInterval) {
+    record(value);
+    if (expectedInterval == 0) {
+        return;
+    }
+    for (auto missing = value - std::min(value, expectedInterval); missing >= expectedInterval;
+            missing -= expectedInterval) {
+        record(missing);
+    }
+}
+
+void LatencyHistogram::add(size_t index, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    mBuckets[index] += count;
+    mCount += count;
+    mMin = std::min(mMin, lowestEquivalent(index));
+    mMax = std::max(mMax, highestEquivalent(index));
+}
+
+void LatencyHistogram::addSum(uint64_t sum) {
+    mSum += sum;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        mBuckets[i] += other.mBuckets[i];
+    }
+    mCount += other.mCount;
+    mSum += other.mSum;
+    mMin = std::min(mMin, other.mMin);
+    mMax = std::max(mMax, other.mMax);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(mBuckets.begin(), mBuckets.end(), 0);
+    mCount = 0;
+    mSum = 0;
+    mMin = std::numeric_limits<uint64_t>::max();
+    mMax = 0;
+}
+
+double LatencyHistogram::mean() const {
+    return (mCount == 0 ? 0.0 : double(mSum) / double(mCount));
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (mCount == 0) {
+        return 0;
+    }
+    auto target = std::max(static_cast<uint64_t>(p / 100.0 * double(mCount) + 0.5), uint64_t(1));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += mBuckets[i];
+        if (seen >= target) {
+            return std::min(highestEquivalent(i), mMax);
+        }
+    }
+    return mMax;
+}
+
+} // namespace db
+} // namespace tell
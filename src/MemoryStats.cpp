@@ -0,0 +1,147 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "MemoryStats.hpp"
+#include "RemoteCounter.hpp"
+
+#include <telldb/TellDB.hpp>
+#include <telldb/Tuple.hpp>
+
+namespace tell {
+namespace db {
+
+const char* memoryCategoryName(MemoryCategory category) {
+    switch (category) {
+    case MemoryCategory::TupleCache:
+        return "tuple-cache";
+    case MemoryCategory::WriteSet:
+        return "write-set";
+    case MemoryCategory::IndexCache:
+        return "index-cache";
+    case MemoryCategory::UndoLog:
+        return "undo-log";
+    }
+    return "unknown";
+}
+
+size_t TransactionMemory::total() const {
+    size_t result = 0;
+    for (auto b : bytes) {
+        result += b;
+    }
+    return result;
+}
+
+uint64_t MemoryStats::contextBytes() const {
+    uint64_t result = 0;
+    for (auto& thread : threads) {
+        result += thread.contextBytes;
+    }
+    return result;
+}
+
+namespace impl {
+namespace {
+
+size_t fieldMemory(const Field& field) {
+    if (field.type() == store::FieldType::TEXT || field.type() == store::FieldType::BLOB) {
+        // Short strings are stored in the field itself
+        auto size = field.stringSize();
+        return sizeof(Field) + (size > Field::INLINE_SIZE ? size : 0);
+    }
+    return sizeof(Field);
+}
+
+} // anonymous namespace
+
+size_t tupleMemory(const Tuple& tuple) {
+    auto result = sizeof(Tuple);
+    for (Tuple::id_t i = 0; i < tuple.count(); ++i) {
+        result += fieldMemory(tuple[i]);
+    }
+    return result;
+}
+
+size_t keyMemory(const std::vector<Field>& key) {
+    size_t result = 0;
+    for (auto& field : key) {
+        result += fieldMemory(field);
+    }
+    return result;
+}
+
+size_t contextMemory(const TellDBContext& context) {
+    auto result = hashMapMemory(context.tables) + context.tables.size() * sizeof(store::Table);
+    result += hashMapMemory(context.counters) + context.counters.size() * sizeof(RemoteCounter);
+    result += hashMapMemory(context.tableNames);
+    for (auto& name : context.tableNames) {
+        result += name.first.capacity();
+    }
+    return result;
+}
+
+MemoryRecorder::MemoryRecorder()
+    : mContextBytes(0)
+    , mTransactions(0)
+    , mLargest(0)
+    , mWarnings(0)
+{
+    for (auto& total : mTotals) {
+        total.store(0, std::memory_order_relaxed);
+    }
+}
+
+void MemoryRecorder::record(const TransactionMemory& memory, size_t contextBytes, bool warned) {
+    auto peak = memory.total();
+    mPeak.record(peak);
+    for (size_t i = 0; i < gMemoryCategoryCount; ++i) {
+        HistogramRecorder::increment(mTotals[i], memory.bytes[i]);
+    }
+    mContextBytes.store(contextBytes, std::memory_order_relaxed);
+    HistogramRecorder::increment(mTransactions, 1);
+    if (peak > mLargest.load(std::memory_order_relaxed)) {
+        mLargest.store(peak, std::memory_order_relaxed);
+    }
+    if (warned) {
+        HistogramRecorder::increment(mWarnings, 1);
+    }
+}
+
+void MemoryRecorder::snapshot(MemoryStats& stats) const {
+    ThreadMemory thread;
+    thread.transactions = mTransactions.load(std::memory_order_relaxed);
+    if (thread.transactions == 0) {
+        return;
+    }
+    thread.contextBytes = mContextBytes.load(std::memory_order_relaxed);
+    thread.largestTransaction = mLargest.load(std::memory_order_relaxed);
+    stats.threads.push_back(thread);
+    mPeak.snapshot(stats.peak);
+    for (size_t i = 0; i < gMemoryCategoryCount; ++i) {
+        stats.totals[i] += mTotals[i].load(std::memory_order_relaxed);
+    }
+    stats.warnings += mWarnings.load(std::memory_order_relaxed);
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,105 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "CommitStats.hpp"
+
+#include <telldb/MemoryStats.hpp>
+#include <telldb/Field.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tell {
+namespace db {
+
+class Tuple;
+
+namespace impl {
+
+struct TellDBContext;
+
+/**
+ * @brief Estimated memory of a tuple including its variable sized values
+ */
+size_t tupleMemory(const Tuple& tuple);
+
+/**
+ * @brief Estimated memory of an index key including its variable sized values
+ */
+size_t keyMemory(const std::vector<Field>& key);
+
+/**
+ * @brief Estimated memory of the entries and buckets of an unordered map (without the mapped objects)
+ */
+template<class Map>
+size_t hashMapMemory(const Map& map) {
+    // Every node holds the value, the next pointer and the cached hash
+    return map.size() * (sizeof(typename Map::value_type) + 2 * sizeof(void*)) + map.bucket_count() * sizeof(void*);
+}
+
+/**
+ * @brief Estimated memory of the entries of an ordered map (without the mapped objects)
+ */
+template<class Map>
+size_t treeMapMemory(const Map& map) {
+    // Every node holds the value, the parent, left and right pointers and the color
+    return map.size() * (sizeof(typename Map::value_type) + 4 * sizeof(void*));
+}
+
+/**
+ * @brief Estimated memory of the tables and counters opened by the thread
+ */
+size_t contextMemory(const TellDBContext& context);
+
+/**
+ * @brief Memory of the transactions of a single thread
+ *
+ * Only the owning thread records, so plain loads and stores suffice. The counters are atomic so that snapshots can be
+ * taken from any thread at any time without locking.
+ */
+class MemoryRecorder {
+public:
+    MemoryRecorder();
+
+    void record(const TransactionMemory& memory, size_t contextBytes, bool warned);
+
+    /**
+     * @brief Adds the current state to the given stats
+     */
+    void snapshot(MemoryStats& stats) const;
+
+private:
+    HistogramRecorder mPeak;
+    std::array<std::atomic<uint64_t>, gMemoryCategoryCount> mTotals;
+    std::atomic<uint64_t> mContextBytes;
+    std::atomic<uint64_t> mTransactions;
+    std::atomic<uint64_t> mLargest;
+    std::atomic<uint64_t> mWarnings;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,167 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Metrics.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+namespace tell {
+namespace db {
+
+const char* metricName(Metric metric) {
+    switch (metric) {
+    case Metric::TableCacheHits:
+        return "table_cache_hits";
+    case Metric::RemoteGets:
+        return "remote_gets";
+    case Metric::IndexLookups:
+        return "index_lookups";
+    case Metric::IndexModifications:
+        return "index_modifications";
+    case Metric::IndexPointerReads:
+        return "index_pointer_reads";
+    case Metric::IndexNodeReads:
+        return "index_node_reads";
+    case Metric::CounterRefills:
+        return "counter_refills";
+    case Metric::CounterStalls:
+        return "counter_stalls";
+    case Metric::CounterRetries:
+        return "counter_retries";
+    case Metric::UndoLogBytes:
+        return "undo_log_bytes";
+    case Metric::UndoLogChunks:
+        return "undo_log_chunks";
+    case Metric::UndoLogsSkipped:
+        return "undo_logs_skipped";
+    case Metric::CommitManagerRequests:
+        return "commit_manager_requests";
+    case Metric::Conflicts:
+        return "conflicts";
+    case Metric::Scans:
+        return "scans";
+    case Metric::ScanRequestBytes:
+        return "scan_request_bytes";
+    }
+    return "unknown";
+}
+
+double MetricsSnapshot::indexReadsPerTraversal() const {
+    auto traversals = (*this)[Metric::IndexLookups] + (*this)[Metric::IndexModifications];
+    if (traversals == 0) {
+        return 0.0;
+    }
+    return double((*this)[Metric::IndexPointerReads] + (*this)[Metric::IndexNodeReads]) / double(traversals);
+}
+
+void MetricsSnapshot::merge(const MetricsSnapshot& other) {
+    for (size_t i = 0; i < gMetricCount; ++i) {
+        values[i] += other.values[i];
+    }
+    for (auto& c : other.conflicts) {
+        conflicts[c.first] += c.second;
+    }
+}
+
+crossbow::string MetricsSnapshot::toString() const {
+    crossbow::string result;
+    for (size_t i = 0; i < gMetricCount; ++i) {
+        result += "telldb_";
+        result += metricName(static_cast<Metric>(i));
+        result += ' ';
+        result += boost::lexical_cast<crossbow::string>(values[i]);
+        result += '\n';
+    }
+    for (auto& c : conflicts) {
+        result += "telldb_conflicts{table=\"";
+        result += c.first;
+        result += "\"} ";
+        result += boost::lexical_cast<crossbow::string>(c.second);
+        result += '\n';
+    }
+    return result;
+}
+
+namespace impl {
+namespace {
+
+const crossbow::string gOtherTables = "<other>";
+
+} // anonymous namespace
+
+constexpr size_t Metrics::CONFLICT_SLOTS;
+
+Metrics::Metrics()
+    : mConflictTables(0)
+{
+    for (auto& value : mValues) {
+        value.store(0, std::memory_order_relaxed);
+    }
+    for (auto& slot : mConflicts) {
+        slot.table.store(nullptr, std::memory_order_relaxed);
+        slot.count.store(0, std::memory_order_relaxed);
+    }
+    mConflicts.back().table.store(&gOtherTables, std::memory_order_release);
+}
+
+Metrics::~Metrics() {
+    for (size_t i = 0; i < mConflictTables; ++i) {
+        delete mConflicts[i].table.load(std::memory_order_relaxed);
+    }
+}
+
+void Metrics::conflict(const crossbow::string& table, uint64_t count) {
+    increment(Metric::Conflicts, count);
+    for (size_t i = 0; i < mConflictTables; ++i) {
+        if (*mConflicts[i].table.load(std::memory_order_relaxed) == table) {
+            increment(mConflicts[i].count, count);
+            return;
+        }
+    }
+    if (mConflictTables == CONFLICT_SLOTS - 1) {
+        increment(mConflicts.back().count, count);
+        return;
+    }
+    auto& slot = mConflicts[mConflictTables++];
+    slot.count.store(count, std::memory_order_relaxed);
+    slot.table.store(new crossbow::string(table), std::memory_order_release);
+}
+
+void Metrics::snapshot(MetricsSnapshot& snapshot) const {
+    for (size_t i = 0; i < gMetricCount; ++i) {
+        snapshot.values[i] += mValues[i].load(std::memory_order_relaxed);
+    }
+    for (auto& slot : mConflicts) {
+        auto table = slot.table.load(std::memory_order_acquire);
+        if (table == nullptr) {
+            continue;
+        }
+        auto count = slot.count.load(std::memory_order_relaxed);
+        if (count != 0) {
+            snapshot.conflicts[*table] += count;
+        }
+    }
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
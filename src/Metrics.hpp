@@ -0,0 +1,84 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include <telldb/Metrics.hpp>
+
+#include <crossbow/string.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace tell {
+namespace db {
+namespace impl {
+
+/**
+ * @brief Counters of a single thread
+ *
+ * Only the owning thread writes the counters, so plain loads and stores suffice and no cache lines are shared between
+ * threads. The counters are atomic so that snapshots can be taken from any thread without locking.
+ */
+class Metrics {
+public:
+    /// Number of tables conflicts are counted for individually, the last slot collects all other tables
+    static constexpr size_t CONFLICT_SLOTS = 64;
+
+    Metrics();
+
+    ~Metrics();
+
+    void increment(Metric metric, uint64_t value = 1) {
+        increment(mValues[static_cast<size_t>(metric)], value);
+    }
+
+    /**
+     * @brief Counts conflicting writes on the given table
+     */
+    void conflict(const crossbow::string& table, uint64_t count);
+
+    /**
+     * @brief Adds the current state to the given snapshot
+     */
+    void snapshot(MetricsSnapshot& snapshot) const;
+
+private:
+    struct ConflictSlot {
+        /// Published by the owning thread after the slot was initialized
+        std::atomic<const crossbow::string*> table;
+        std::atomic<uint64_t> count;
+    };
+
+    static void increment(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, gMetricCount> mValues;
+    std::array<ConflictSlot, CONFLICT_SLOTS> mConflicts;
+    /// Number of slots in use (only accessed by the owning thread)
+    size_t mConflictTables;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,249 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "NodeStats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace tell {
+namespace db {
+namespace {
+
+/// Nodes with more requests than this times the mean are reported as hot
+constexpr double gHotFactor = 1.5;
+
+/// Nodes with a p99 latency higher than this times the median are reported as slow
+constexpr double gSlowFactor = 2.0;
+
+double micros(uint64_t nanos) {
+    return double(nanos) / 1000.0;
+}
+
+} // anonymous namespace
+
+const char* nodeOperationName(NodeOperation op) {
+    switch (op) {
+    case NodeOperation::Get:
+        return "get";
+    case NodeOperation::Insert:
+        return "insert";
+    case NodeOperation::Update:
+        return "update";
+    case NodeOperation::Remove:
+        return "remove";
+    case NodeOperation::Revert:
+        return "revert";
+    case NodeOperation::Scan:
+        return "scan";
+    }
+    return "unknown";
+}
+
+void NodeOperationStats::merge(const NodeOperationStats& other) {
+    requests += other.requests;
+    bytes += other.bytes;
+    latency.merge(other.latency);
+}
+
+uint64_t StorageNodeStats::requests() const {
+    uint64_t result = 0;
+    for (auto& op : operations) {
+        result += op.requests;
+    }
+    return result;
+}
+
+uint64_t StorageNodeStats::bytes() const {
+    uint64_t result = 0;
+    for (auto& op : operations) {
+        result += op.bytes;
+    }
+    return result;
+}
+
+LatencyHistogram StorageNodeStats::latency() const {
+    LatencyHistogram result;
+    for (auto& op : operations) {
+        result.merge(op.latency);
+    }
+    return result;
+}
+
+double NodeStats::loadSkew() const {
+    uint64_t total = 0;
+    uint64_t busiest = 0;
+    for (auto& node : nodes) {
+        auto requests = node.requests();
+        total += requests;
+        busiest = std::max(busiest, requests);
+    }
+    if (total == 0) {
+        return 1.0;
+    }
+    return double(busiest) * double(nodes.size()) / double(total);
+}
+
+double NodeStats::latencySkew(double percentile) const {
+    std::vector<uint64_t> latencies;
+    for (auto& node : nodes) {
+        auto latency = node.latency();
+        if (latency.count() != 0) {
+            latencies.push_back(latency.percentile(percentile));
+        }
+    }
+    if (latencies.empty()) {
+        return 1.0;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto median = latencies[latencies.size() / 2];
+    if (median == 0) {
+        return 1.0;
+    }
+    return double(latencies.back()) / double(median);
+}
+
+crossbow::string NodeStats::toString() const {
+    uint64_t total = 0;
+    std::vector<uint64_t> latencies;
+    for (auto& node : nodes) {
+        total += node.requests();
+        auto latency = node.latency();
+        if (latency.count() != 0) {
+            latencies.push_back(latency.percentile(99.0));
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto mean = (nodes.empty() ? 0.0 : double(total) / double(nodes.size()));
+    auto median = (latencies.empty() ? 0 : latencies[latencies.size() / 2]);
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        auto& node = nodes[i];
+        auto requests = node.requests();
+        auto latency = node.latency();
+        out << "node " << i << ": " << requests << " requests ("
+            << (total == 0 ? 0.0 : double(requests) * 100.0 / double(total)) << "%), " << node.bytes() << " bytes";
+        if (latency.count() != 0) {
+            out << ", p50 " << micros(latency.percentile(50.0)) << "us, p99 " << micros(latency.percentile(99.0))
+                << "us";
+        }
+        if (mean != 0.0 && double(requests) > gHotFactor * mean) {
+            out << " [hot]";
+        }
+        if (median != 0 && latency.count() != 0 && double(latency.percentile(99.0)) > gSlowFactor * double(median)) {
+            out << " [slow]";
+        }
+        out << std::endl;
+        for (size_t j = 0; j < gNodeOperationCount; ++j) {
+            auto& op = node.operations[j];
+            if (op.requests == 0) {
+                continue;
+            }
+            out << "  " << nodeOperationName(static_cast<NodeOperation>(j)) << ": " << op.requests << " requests, "
+                << op.bytes << " bytes, p99 " << micros(op.latency.percentile(99.0)) << "us" << std::endl;
+        }
+    }
+    out << "load skew " << loadSkew() << ", p99 latency skew " << latencySkew() << std::endl;
+    return crossbow::string(out.str());
+}
+
+namespace impl {
+
+constexpr size_t NodeStatsRecorder::NODE_SLOTS;
+
+NodeStatsRecorder::OperationRecorder::OperationRecorder()
+    : requests(0)
+    , bytes(0)
+{}
+
+NodeStatsRecorder::NodeStatsRecorder()
+    : mNodes(0)
+{
+    for (auto& recorder : mRecorders) {
+        recorder.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+NodeStatsRecorder::~NodeStatsRecorder() {
+    for (auto& recorder : mRecorders) {
+        delete recorder.load(std::memory_order_relaxed);
+    }
+}
+
+size_t NodeStatsRecorder::nodeOf(store::ClientHandle& handle, const store::Table& table, uint64_t key) const {
+#ifdef TELLDB_LOCAL_STORE
+    return handle.processor().storage().nodeOf(table.tableId(), key);
+#else
+    // The TellStore client sends every request to the shard key % nodes
+    auto nodes = mNodes.load(std::memory_order_relaxed);
+    return (nodes == 0 ? 0 : key % nodes);
+#endif
+}
+
+void NodeStatsRecorder::record(NodeOperation op, size_t node, uint64_t begin, size_t bytes) {
+    auto& slot = mRecorders[std::min(node, NODE_SLOTS - 1)];
+    auto recorder = slot.load(std::memory_order_relaxed);
+    if (recorder == nullptr) {
+        recorder = new NodeRecorder();
+        slot.store(recorder, std::memory_order_release);
+    }
+    auto& opRecorder = (*recorder)[static_cast<size_t>(op)];
+    HistogramRecorder::increment(opRecorder.requests, 1);
+    HistogramRecorder::increment(opRecorder.bytes, bytes);
+    opRecorder.latency.record(static_cast<uint64_t>(CycleClock::toDuration(CycleClock::now() - begin).count()));
+}
+
+void NodeStatsRecorder::endScan(uint64_t begin, size_t bytes) {
+    if (begin == 0) {
+        return;
+    }
+    auto nodes = std::max<size_t>(mNodes.load(std::memory_order_relaxed), 1);
+    for (size_t node = 0; node < nodes; ++node) {
+        record(NodeOperation::Scan, node, begin, bytes);
+    }
+}
+
+void NodeStatsRecorder::snapshot(NodeStats& stats) const {
+    for (size_t i = 0; i < NODE_SLOTS; ++i) {
+        auto recorder = mRecorders[i].load(std::memory_order_acquire);
+        if (recorder == nullptr) {
+            continue;
+        }
+        if (stats.nodes.size() <= i) {
+            stats.nodes.resize(i + 1);
+        }
+        auto& node = stats.nodes[i];
+        for (size_t j = 0; j < gNodeOperationCount; ++j) {
+            auto& op = node.operations[j];
+            op.requests += (*recorder)[j].requests.load(std::memory_order_relaxed);
+            op.bytes += (*recorder)[j].bytes.load(std::memory_order_relaxed);
+            (*recorder)[j].latency.snapshot(op.latency);
+        }
+    }
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,153 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "CommitStats.hpp"
+
+#include <telldb/NodeStats.hpp>
+#include <tellstore/ClientManager.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace tell {
+namespace db {
+namespace impl {
+
+/**
+ * @brief Requests a single thread sent to the storage nodes
+ *
+ * The statistics of a node are allocated when the thread sends the first request to it. Only the owning thread
+ * records, the client table enables and disables the recorder by setting the number of storage nodes.
+ */
+class NodeStatsRecorder {
+public:
+    /// Number of storage nodes recorded individually, the last slot collects all other nodes
+    static constexpr size_t NODE_SLOTS = 256;
+
+    NodeStatsRecorder();
+
+    ~NodeStatsRecorder();
+
+    /**
+     * @brief Sets the number of storage nodes requests are distributed over (0 disables the recorder)
+     */
+    void setNodes(size_t nodes) {
+        mNodes.store(nodes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Starts a request
+     *
+     * @return The start of the request to pass to end (0 if the recorder is disabled)
+     */
+    uint64_t begin() const {
+        return (mNodes.load(std::memory_order_relaxed) == 0 ? 0 : CycleClock::now());
+    }
+
+    /**
+     * @brief Records a request on the given key when its response was consumed, does nothing if begin returned 0
+     *
+     * @param bytes Size of the tuple sent or received
+     */
+    void end(NodeOperation op, store::ClientHandle& handle, const store::Table& table, uint64_t key, uint64_t begin,
+            size_t bytes = 0) {
+        if (begin != 0) {
+            record(op, nodeOf(handle, table, key), begin, bytes);
+        }
+    }
+
+    /**
+     * @brief Records a scan on all storage nodes
+     *
+     * @param bytes Size of the selection and query sent to every node
+     */
+    void endScan(uint64_t begin, size_t bytes);
+
+    /**
+     * @brief Adds the current state to the given stats
+     */
+    void snapshot(NodeStats& stats) const;
+
+private:
+    struct OperationRecorder {
+        OperationRecorder();
+
+        std::atomic<uint64_t> requests;
+        std::atomic<uint64_t> bytes;
+        HistogramRecorder latency;
+    };
+
+    using NodeRecorder = std::array<OperationRecorder, gNodeOperationCount>;
+
+    size_t nodeOf(store::ClientHandle& handle, const store::Table& table, uint64_t key) const;
+
+    void record(NodeOperation op, size_t node, uint64_t begin, size_t bytes);
+
+    std::atomic<size_t> mNodes;
+
+    /// Published by the owning thread after the recorder was initialized
+    std::array<std::atomic<NodeRecorder*>, NODE_SLOTS> mRecorders;
+};
+
+/**
+ * @brief Records a synchronous request on a storage node when it goes out of scope
+ */
+class NodeRequest {
+public:
+    NodeRequest(NodeStatsRecorder& nodes, NodeOperation op, store::ClientHandle& handle, const store::Table& table,
+            uint64_t key, size_t bytes = 0)
+        : mNodes(nodes)
+        , mOperation(op)
+        , mHandle(handle)
+        , mTable(table)
+        , mKey(key)
+        , mBytes(bytes)
+        , mBegin(nodes.begin())
+    {}
+
+    ~NodeRequest() {
+        mNodes.end(mOperation, mHandle, mTable, mKey, mBegin, mBytes);
+    }
+
+    /**
+     * @brief Sets the size of the tuple received
+     */
+    void setBytes(size_t bytes) {
+        mBytes = bytes;
+    }
+
+private:
+    NodeStatsRecorder& mNodes;
+    NodeOperation mOperation;
+    store::ClientHandle& mHandle;
+    const store::Table& mTable;
+    uint64_t mKey;
+    size_t mBytes;
+    uint64_t mBegin;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,64 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+/**
+ * @file
+ * @brief Static tracepoints (USDT) for perf, bpftrace and SystemTap
+ *
+ * All probes are in the "telldb" provider. A probe compiles to a single nop, its location and the location of its
+ * arguments are recorded in the ELF notes for the tracer. Without sys/sdt.h the probes and their arguments are
+ * compiled away.
+ *
+ * Probes and their arguments:
+ *   transaction__start   (snapshot version, transaction type)
+ *   transaction__commit  (snapshot version, latency [ns], undo log size [bytes])
+ *   transaction__abort   (snapshot version, latency [ns])
+ *   cache__hit           (table id, key)
+ *   cache__miss          (table id, key)
+ *   index__traverse      (index name, operation [0 = lower bound, 1 = reverse lower bound, 2 = insert, 3 = erase])
+ *   undolog__write       (snapshot version, size [bytes], chunks, latency [ns])
+ *   counter__refill      (counter table id, counter id, first reserved value)
+ *   scan__start          (table id, query size [bytes])
+ *   scan__end            (table id, latency [ns])
+ */
+
+#ifdef TELLDB_HAVE_SDT
+
+#include <sys/sdt.h>
+
+#define TELLDB_PROBE1(name, a1) DTRACE_PROBE1(telldb, name, a1)
+#define TELLDB_PROBE2(name, a1, a2) DTRACE_PROBE2(telldb, name, a1, a2)
+#define TELLDB_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(telldb, name, a1, a2, a3)
+#define TELLDB_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(telldb, name, a1, a2, a3, a4)
+
+#else
+
+// The arguments are not evaluated but still count as used
+#define TELLDB_PROBE1(name, a1) do { (void) sizeof(a1); } while (false)
+#define TELLDB_PROBE2(name, a1, a2) do { (void) sizeof(a1); (void) sizeof(a2); } while (false)
+#define TELLDB_PROBE3(name, a1, a2, a3) do { (void) sizeof(a1); (void) sizeof(a2); (void) sizeof(a3); } while (false)
+#define TELLDB_PROBE4(name, a1, a2, a3, a4) \
+    do { (void) sizeof(a1); (void) sizeof(a2); (void) sizeof(a3); (void) sizeof(a4); } while (false)
+
+#endif
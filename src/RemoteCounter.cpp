@@ -21,6 +21,11 @@
  *     Lucas Braun <braunl@inf.ethz.ch>
  */
 #include "RemoteCounter.hpp"
+#include "Metrics.hpp"
+#include "Timeline.hpp"
+#include "Probes.hpp"
+
+#include <algorithm>
 
 namespace tell {
 namespace db {
@@ -43,35 +48,46 @@ std::shared_ptr<store::Table> RemoteCounter::createTable(store::ClientHandle& ha
     return std::make_shared<store::Table>(handle.createTable(name, std::move(schema)));
 }
 
-RemoteCounter::RemoteCounter(std::shared_ptr<store::Table> counterTable, uint64_t counterId)
+constexpr uint64_t RemoteCounter::DEFAULT_BATCH;
+
+RemoteCounter::RemoteCounter(std::shared_ptr<store::Table> counterTable, uint64_t counterId, impl::Metrics& metrics,
+        uint64_t batchSize)
         : mCounterTable(std::move(counterTable)),
           mCounterId(counterId),
+          mMetrics(metrics),
+          mBatchSize(std::max<uint64_t>(batchSize, 1)),
+          // At least one key has to be left when the next batch is requested, except for batches of one key
+          mThreshold(std::min(std::max<uint64_t>(mBatchSize / 10, 1), mBatchSize - 1)),
           mInit(false),
           mCounter(0x0u),
           mReserved(0x0u),
           mNextCounter(0x0u) {
 }
 
-uint64_t RemoteCounter::incrementAndGet(store::ClientHandle& handle) {
+uint64_t RemoteCounter::incrementAndGet(store::ClientHandle& handle, impl::TransactionTimeline* timeline) {
     if (mCounter == 0x0u && !mInit) {
         mInit = true;
-        requestNewBatch(handle);
+        requestNewBatch(handle, timeline);
     }
 
-    mFreshKeys.wait(handle.fiber(), [this] () {
-        return (mCounter != mReserved) || (mNextCounter != 0x0u);
-    });
+    if (mCounter == mReserved && mNextCounter == 0x0u) {
+        mMetrics.increment(Metric::CounterStalls);
+        impl::TimelineWait wait(timeline, WaitSite::Counter);
+        mFreshKeys.wait(handle.fiber(), [this] () {
+            return (mCounter != mReserved) || (mNextCounter != 0x0u);
+        });
+    }
 
     if (mCounter == mReserved) {
         LOG_ASSERT(mNextCounter != 0x0u, "Next counter must be non 0");
         mCounter = mNextCounter;
-        mReserved = mNextCounter + RESERVED_BATCH;
+        mReserved = mNextCounter + mBatchSize;
         mNextCounter = 0x0u;
     }
 
     auto key = ++mCounter;
-    if (mCounter + THRESHOLD == mReserved) {
-        requestNewBatch(handle);
+    if (mCounter + mThreshold == mReserved) {
+        requestNewBatch(handle, timeline);
     }
     return key;
 }
@@ -85,34 +101,51 @@ uint64_t RemoteCounter::remoteValue(store::ClientHandle& handle) const {
     return static_cast<uint64_t>(mCounterTable->field<int64_t>(gCounterFieldName, tuple->data()));
 }
 
-void RemoteCounter::requestNewBatch(store::ClientHandle& handle) {
+void RemoteCounter::requestNewBatch(store::ClientHandle& handle, impl::TransactionTimeline* timeline) {
+    mMetrics.increment(Metric::CounterRefills);
     uint64_t nextCounter;
     while (true) {
+        auto getSpan = impl::beginRequest(timeline, "counter-read", mCounterTable->tableName(), mCounterId);
         auto getFuture = handle.get(*mCounterTable, mCounterId);
 
         std::shared_ptr<store::ModificationResponse> counterFuture;
-        if (getFuture->waitForResult()) {
+        bool found;
+        {
+            impl::TimelineWait wait(timeline, WaitSite::CounterRefill);
+            found = getFuture->waitForResult();
+        }
+        impl::endRequest(timeline, getSpan);
+        auto updateSpan = impl::beginRequest(timeline, "counter-update", mCounterTable->tableName(), mCounterId);
+        if (found) {
             auto tuple = getFuture->get();
             nextCounter = static_cast<uint64_t>(mCounterTable->field<int64_t>(gCounterFieldName, tuple->data()));
             counterFuture = handle.update(*mCounterTable, mCounterId, tuple->version(),
-                    createCounterTuple(nextCounter + RESERVED_BATCH));
+                    createCounterTuple(nextCounter + mBatchSize));
         } else if (getFuture->error() == store::error::not_found) {
             nextCounter = 0x0u;
-            counterFuture = handle.insert(*mCounterTable, mCounterId, 0x0u, createCounterTuple(RESERVED_BATCH));
+            counterFuture = handle.insert(*mCounterTable, mCounterId, 0x0u, createCounterTuple(mBatchSize));
         } else {
             throw std::system_error(getFuture->error());
         }
 
-        if (counterFuture->waitForResult()) {
+        bool updated;
+        {
+            impl::TimelineWait wait(timeline, WaitSite::CounterRefill);
+            updated = counterFuture->waitForResult();
+        }
+        impl::endRequest(timeline, updateSpan);
+        if (updated) {
             break;
         } else if (counterFuture->error() != store::error::not_in_snapshot) {
             throw std::system_error(counterFuture->error());
         }
+        mMetrics.increment(Metric::CounterRetries);
     }
 
+    TELLDB_PROBE3(counter__refill, mCounterTable->tableId(), mCounterId, nextCounter);
     if (mCounter == mReserved) {
         mCounter = nextCounter;
-        mReserved = nextCounter + RESERVED_BATCH;
+        mReserved = nextCounter + mBatchSize;
     } else {
         mNextCounter = nextCounter;
     }
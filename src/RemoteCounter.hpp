@@ -34,6 +34,10 @@
 
 namespace tell {
 namespace db {
+namespace impl {
+class Metrics;
+class TransactionTimeline;
+} // namespace impl
 
 /**
  * @brief Provdes a remote counter assigning unique values
@@ -47,12 +51,22 @@ public:
      */
     static std::shared_ptr<store::Table> createTable(store::ClientHandle& handle, const crossbow::string& name);
 
-    RemoteCounter(std::shared_ptr<store::Table> counterTable, uint64_t counterId);
+    /// Number of values reserved at once unless configured otherwise
+    static constexpr uint64_t DEFAULT_BATCH = 1000;
+
+    /**
+     * @param batchSize Number of values reserved at once, the next batch is requested when a tenth of the batch is
+     *      left
+     */
+    RemoteCounter(std::shared_ptr<store::Table> counterTable, uint64_t counterId, impl::Metrics& metrics,
+            uint64_t batchSize = DEFAULT_BATCH);
 
     /**
      * @brief Increments the counter value by one and returns the value
+     *
+     * Requests for new batches are recorded in the timeline of the calling transaction (if it is sampled).
      */
-    uint64_t incrementAndGet(store::ClientHandle& handle);
+    uint64_t incrementAndGet(store::ClientHandle& handle, impl::TransactionTimeline* timeline = nullptr);
 
     /**
      * @brief Reads the counter's remote value from the database
@@ -60,16 +74,14 @@ public:
     uint64_t remoteValue(store::ClientHandle& handle) const;
 
 private:
-    static constexpr uint64_t RESERVED_BATCH = 1000;
-
-    static constexpr uint64_t THRESHOLD = 100;
-
-    static_assert(RESERVED_BATCH > THRESHOLD, "Number of reserved keys must be larger than the threshold");
-
-    void requestNewBatch(store::ClientHandle& handle);
+    void requestNewBatch(store::ClientHandle& handle, impl::TransactionTimeline* timeline);
 
     std::shared_ptr<store::Table> mCounterTable;
     uint64_t mCounterId;
+    impl::Metrics& mMetrics;
+
+    uint64_t mBatchSize;
+    uint64_t mThreshold;
 
     bool mInit;
     uint64_t mCounter;
@@ -117,7 +117,7 @@ void ScanQuery::serializeSelection(std::unique_ptr<char[]>& result, uint32_t& si
                 break;
             case store::FieldType::BLOB:
             case store::FieldType::TEXT:
-                size += field.value<crossbow::string>().size();
+                size += field.stringSize();
                 size += (size % 8 == 0 ? 0 : 8 - (size % 8));
                 break;
             case store::FieldType::NULLTYPE:
@@ -169,10 +169,9 @@ void ScanQuery::serializeSelection(std::unique_ptr<char[]>& result, uint32_t& si
             case store::FieldType::TEXT:
                 w.set(0, 2);
                 {
-                    auto& str = field.value<crossbow::string>();
-                    auto strLen = str.size();
+                    auto strLen = field.stringSize();
                     w.write(uint32_t(strLen));
-                    w.write(str.data(), strLen);
+                    w.write(field.stringData(), strLen);
                     if (strLen % 8 != 0) {
                         w.set(0, 8 - (strLen % 8));
                     }
@@ -21,6 +21,12 @@
  *     Lucas Braun <braunl@inf.ethz.ch>
  */
 #include "TableCache.hpp"
+#include "Metrics.hpp"
+#include "ConflictProfiler.hpp"
+#include "NodeStats.hpp"
+#include "MemoryStats.hpp"
+#include "Timeline.hpp"
+#include "Probes.hpp"
 #include <tellstore/ClientManager.hpp>
 #include <telldb/Exceptions.hpp>
 
@@ -29,65 +35,104 @@
 
 namespace tell {
 namespace db {
+namespace {
+
+const char* operationName(TableCache::Operation operation) {
+    switch (operation) {
+    case TableCache::Operation::Insert:
+        return "insert";
+    case TableCache::Operation::Update:
+        return "update";
+    case TableCache::Operation::Delete:
+        return "remove";
+    }
+    return "unknown";
+}
+
+NodeOperation nodeOperation(TableCache::Operation operation) {
+    switch (operation) {
+    case TableCache::Operation::Insert:
+        return NodeOperation::Insert;
+    case TableCache::Operation::Update:
+        return NodeOperation::Update;
+    case TableCache::Operation::Delete:
+        return NodeOperation::Remove;
+    }
+    return NodeOperation::Update;
+}
+
+} // anonymous namespace
 
 TableCache::TableCache(const tell::store::Table& table,
         tell::store::ClientHandle& handle,
         const commitmanager::SnapshotDescriptor& snapshot,
         crossbow::ChunkMemoryPool& pool,
-        std::unordered_map<crossbow::string, impl::IndexWrapper>&& indexes)
+        impl::Metrics& metrics,
+        impl::ConflictProfiler& conflicts,
+        impl::NodeStatsRecorder& nodes,
+        impl::TransactionTimeline* timeline,
+        std::unordered_map<crossbow::string, impl::IndexWrapper>&& indexes,
+        bool indexesOpened)
     : mTable(table)
     , mHandle(handle)
     , mSnapshot(snapshot)
     , mPool(pool)
+    , mMetrics(metrics)
+    , mConflicts(conflicts)
+    , mNodes(nodes)
+    , mTimeline(timeline)
     , mCache(&pool)
-    , mChanges(&pool)
-    , mSchema(&pool)
+    , mReverts(&pool)
     , mIndexes(std::move(indexes))
-{
-    id_t currId = 0;
-    const auto& schema = table.record().schema();
-    {
-        const auto& fields = schema.fixedSizeFields();
-        for (const auto& field : fields) {
-            mSchema.emplace(field.name(), currId++);
-        }
-    }
-    {
-        const auto& fields = schema.varSizeFields();
-        for (const auto& field : fields) {
-            mSchema.emplace(field.name(), currId++);
-        }
-    }
-}
+    , mIndexesOpened(indexesOpened)
+{}
 
 TableCache::~TableCache() {
     for (auto& p : mCache) {
         delete p.second.first;
     }
-    for (auto& p : mChanges) {
-        if (std::get<1>(p.second) != Operation::Delete) {
-            delete std::get<0>(p.second);
+    if (mChanges) {
+        for (auto& p : *mChanges) {
+            if (std::get<1>(p.second) != Operation::Delete) {
+                delete std::get<0>(p.second);
+            }
         }
+        mChanges->~ChangesMap();
     }
 }
 
+TableCache::ChangesMap& TableCache::writeSet() {
+    if (!mChanges) {
+        mChanges = new (mPool.allocate(sizeof(ChangesMap))) ChangesMap(&mPool);
+    }
+    return *mChanges;
+}
+
 Future<Tuple> TableCache::get(key_t key) {
-    {
-        auto iter = mChanges.find(key);
-        if (iter != mChanges.end()) {
+    if (mChanges) {
+        auto iter = mChanges->find(key);
+        if (iter != mChanges->end()) {
             if (std::get<1>(iter->second) == Operation::Delete) {
                 throw TupleExistsException(key);
             }
+            mMetrics.increment(Metric::TableCacheHits);
+            TELLDB_PROBE2(cache__hit, mTable.tableId(), key.value);
             return Future<Tuple>(key, std::get<0>(iter->second));
         }
     }
     {
         auto iter = mCache.find(key);
         if (iter != mCache.end()) {
+            mMetrics.increment(Metric::TableCacheHits);
+            TELLDB_PROBE2(cache__hit, mTable.tableId(), key.value);
             return Future<Tuple>(key, iter->second.first);
         }
     }
-    return Future<Tuple>(key, this, mHandle.get(mTable, key.value, mSnapshot));
+    mMetrics.increment(Metric::RemoteGets);
+    TELLDB_PROBE2(cache__miss, mTable.tableId(), key.value);
+    auto span = impl::beginRequest(mTimeline, "get", mTable.tableName(), key.value);
+    auto begin = mNodes.begin();
+    return Future<Tuple>(key, this, mHandle.get(mTable, key.value, mSnapshot), span, begin);
 }
 
 Iterator TableCache::lower_bound(const crossbow::string& name, const KeyType& key) {
@@ -99,12 +144,13 @@ Iterator TableCache::reverse_lower_bound(const crossbow::string& name, const Key
 }
 
 void TableCache::insert(key_t key, const Tuple& tuple) {
-    auto c = mChanges.find(key);
-    if (c == mChanges.end()) {
+    auto& changes = writeSet();
+    auto c = changes.find(key);
+    if (c == changes.end()) {
         if (mCache.count(key) != 0) {
             throw TupleExistsException(key);
         }
-        mChanges.emplace(key, std::make_tuple(new (&mPool) Tuple(tuple), Operation::Insert, false));
+        changes.emplace(key, std::make_tuple(new (&mPool) Tuple(tuple), Operation::Insert, false));
     } else if (std::get<1>(c->second) == Operation::Delete) {
         std::get<1>(c->second) = Operation::Update;
         std::get<0>(c->second) = new (&mPool) Tuple(tuple);
@@ -117,9 +163,10 @@ void TableCache::insert(key_t key, const Tuple& tuple) {
 }
 
 void TableCache::update(key_t key, const Tuple& from, const Tuple& to) {
+    auto& changes = writeSet();
     {
-        auto i = mChanges.find(key);
-        if (i != mChanges.end()) {
+        auto i = changes.find(key);
+        if (i != changes.end()) {
             if (std::get<1>(i->second) == Operation::Delete) {
                 throw TupleDoesNotExist(key);
             }
@@ -132,12 +179,13 @@ void TableCache::update(key_t key, const Tuple& from, const Tuple& to) {
         auto i = mCache.find(key);
         if (i != mCache.end()) {
             if (!i->second.second) {
+                mConflicts.conflict(mTable.tableName(), key);
                 throw Conflict(key);
             }
         } 
         // We do an optimistic update - if the tuple is not cached, we assume that there
         // won't be an update
-        mChanges.emplace(key, std::make_tuple(new (&mPool) Tuple(to), Operation::Update, false));
+        changes.emplace(key, std::make_tuple(new (&mPool) Tuple(to), Operation::Update, false));
     }
 END:
     for (auto& idx : mIndexes) {
@@ -146,15 +194,16 @@ END:
 }
 
 void TableCache::remove(key_t key, const Tuple& tuple) {
+    auto& changes = writeSet();
     {
-        auto i = mChanges.find(key);
-        if (i != mChanges.end()) {
+        auto i = changes.find(key);
+        if (i != changes.end()) {
             if (std::get<1>(i->second) == Operation::Delete) {
                 throw TupleDoesNotExist(key);
             }
             delete std::get<0>(i->second);
             if (std::get<1>(i->second) == Operation::Insert) {
-                mChanges.erase(i);
+                changes.erase(i);
             } else {
                 std::get<0>(i->second) = nullptr;
                 std::get<1>(i->second) = Operation::Delete;
@@ -166,12 +215,13 @@ void TableCache::remove(key_t key, const Tuple& tuple) {
         auto i = mCache.find(key);
         if (i != mCache.end()) {
             if (!i->second.second) {
+                mConflicts.conflict(mTable.tableName(), key);
                 throw Conflict(key);
             }
         } 
         // We do an optimistic update - if the tuple is not cached, we assume that there
         // won't be an update
-        mChanges.emplace(key, std::make_tuple(nullptr, Operation::Delete, false));
+        changes.emplace(key, std::make_tuple(nullptr, Operation::Delete, false));
     }
 END:
     for (auto& idx : mIndexes) {
@@ -180,15 +230,26 @@ END:
 }
 
 void TableCache::writeBack() {
+    if (!mChanges) {
+        return;
+    }
     using Resp = std::shared_ptr<store::ModificationResponse>;
     using ChangeResp = std::pair<Resp, ChangesMap::iterator>;
     std::vector<ChangeResp, crossbow::ChunkAllocator<ChangeResp>> responses(&mPool);
-    responses.reserve(mChanges.size());
-    for (auto iter = mChanges.begin(); iter != mChanges.end(); ++iter) {
+    responses.reserve(mChanges->size());
+    // only filled if the transaction is sampled for the timeline
+    std::vector<uint32_t, crossbow::ChunkAllocator<uint32_t>> spans(&mPool);
+    // all requests are issued without blocking, so they share the same start
+    auto begin = mNodes.begin();
+    for (auto iter = mChanges->begin(); iter != mChanges->end(); ++iter) {
         auto& change = *iter;
         bool& didChange = std::get<2>(change.second);
         if (didChange) continue;
         auto tuple = std::get<0>(change.second);
+        if (mTimeline) {
+            spans.push_back(mTimeline->begin(operationName(std::get<1>(change.second)), mTable.tableName(),
+                    change.first.value));
+        }
         switch (std::get<1>(change.second)) {
         case Operation::Insert:
             responses.emplace_back(std::make_pair(mHandle.insert(mTable, change.first, mSnapshot, *tuple), iter));
@@ -200,46 +261,114 @@ void TableCache::writeBack() {
             responses.emplace_back(std::make_pair(mHandle.remove(mTable, change.first, mSnapshot), iter));
         }
     }
+    mConflicts.written(mTable.tableName(), responses.size());
     bool hadError = false;
     // we put this into the stack, because in normal case the vector should stay
     // empty (and we optimise for the normal case). The unique pointer makes sure
     // that the object gets deleted after moving it into the exception object
     std::unique_ptr<std::vector<key_t>> conflicts = nullptr;
+    impl::TimelineWait wait(mTimeline, WaitSite::WriteBack);
     for (auto i = responses.rbegin(); i != responses.rend(); ++i) {
         if (i->first->error()) {
-            hadError = true;
+            if (!hadError) {
+                // The transaction can not commit anymore, start undoing what already reached the storage
+                hadError = true;
+                startRollback();
+            }
             if (conflicts.get() == nullptr) {
                 conflicts.reset(new std::vector<key_t>());
             }
             conflicts->push_back(i->second->first);
+        } else if (hadError) {
+            revert(i->second);
         } else {
             std::get<2>(i->second->second) = true;
         }
+        if (begin != 0) {
+            auto tuple = std::get<0>(i->second->second);
+            mNodes.end(nodeOperation(std::get<1>(i->second->second)), mHandle, mTable, i->second->first.value, begin,
+                    (tuple ? tuple->size() : 0));
+        }
+        if (mTimeline) {
+            mTimeline->end(spans[responses.rend() - i - 1]);
+        }
     }
     if (hadError) {
+        mMetrics.conflict(mTable.tableName(), conflicts->size());
+        mConflicts.conflicts(mTable.tableName(), *conflicts);
         throw Conflicts(std::move(*conflicts));
     }
 }
 
-void TableCache::rollback() {
-    using Resp = std::shared_ptr<store::ModificationResponse>;
-    std::vector<Resp, crossbow::ChunkAllocator<Resp>> responses(&mPool);
-    responses.reserve(mCache.size());
-    for (auto& change : mChanges) {
-        if (!std::get<2>(change.second)) continue;
-        responses.emplace_back(mHandle.revert(mTable, change.first, mSnapshot));
+void TableCache::startRollback() {
+    if (!mChanges) {
+        return;
     }
-    for (auto iter = responses.rbegin(); iter != responses.rend(); ++iter) {
-        if ((*iter)->error()) {
+    for (auto iter = mChanges->begin(); iter != mChanges->end(); ++iter) {
+        if (!std::get<2>(iter->second)) continue;
+        std::get<2>(iter->second) = false;
+        revert(iter);
+    }
+}
+
+void TableCache::finishRollback() {
+    impl::TimelineWait wait(mTimeline, WaitSite::Revert);
+    for (auto iter = mReverts.rbegin(); iter != mReverts.rend(); ++iter) {
+        if (iter->response->error()) {
             // TODO: not clear what to do in this case
             assert(false);
         }
+        if (iter->begin != 0) {
+            mNodes.end(NodeOperation::Revert, mHandle, mTable, iter->key, iter->begin);
+        }
+        if (mTimeline) {
+            mTimeline->end(iter->span);
+        }
     }
+    mReverts.clear();
+}
+
+void TableCache::revert(ChangesMap::iterator iter) {
+    auto key = iter->first.value;
+    uint32_t span = (mTimeline ? mTimeline->begin("revert", mTable.tableName(), key) : 0);
+    auto begin = mNodes.begin();
+    mReverts.emplace_back(PendingRevert{mHandle.revert(mTable, iter->first, mSnapshot), key, span, begin});
 }
 
 void TableCache::writeIndexes() {
+    try {
+        for (auto& idx : mIndexes) {
+            idx.second.writeBack();
+        }
+    } catch (IndexConflict& e) {
+        mMetrics.conflict(mTable.tableName(), 1);
+        mConflicts.indexConflict(mTable.tableName(), e);
+        throw;
+    }
+}
+
+void TableCache::memoryUsage(TransactionMemory& memory) const {
+    auto& tupleCache = memory.bytes[static_cast<size_t>(MemoryCategory::TupleCache)];
+    tupleCache += impl::hashMapMemory(mCache);
+    for (auto& p : mCache) {
+        tupleCache += impl::tupleMemory(*p.second.first);
+    }
+    auto& writeSet = memory.bytes[static_cast<size_t>(MemoryCategory::WriteSet)];
+    if (mChanges) {
+        writeSet += impl::hashMapMemory(*mChanges);
+        for (auto& p : *mChanges) {
+            if (std::get<0>(p.second) != nullptr) {
+                writeSet += impl::tupleMemory(*std::get<0>(p.second));
+            }
+        }
+    }
+    auto& indexCache = memory.bytes[static_cast<size_t>(MemoryCategory::IndexCache)];
     for (auto& idx : mIndexes) {
-        idx.second.writeBack();
+        auto& cache = idx.second.cache();
+        indexCache += impl::treeMapMemory(cache);
+        for (auto& entry : cache) {
+            indexCache += impl::keyMemory(entry.first);
+        }
     }
 }
 
@@ -261,11 +390,14 @@ Future<Tuple>::Future(key_t key, const Tuple* result)
     , cache(nullptr)
 {}
 
-Future<Tuple>::Future(key_t key, TableCache* cache, std::shared_ptr<store::GetResponse>&& response)
+Future<Tuple>::Future(key_t key, TableCache* cache, std::shared_ptr<store::GetResponse>&& response, uint32_t span,
+        uint64_t requestBegin)
     : key(key)
     , result(nullptr)
     , cache(cache)
     , response(std::move(response))
+    , span(span)
+    , requestBegin(requestBegin)
 {}
 
 bool Future<Tuple>::done() const {
@@ -281,13 +413,26 @@ bool Future<Tuple>::wait() const {
 const Tuple& Future<Tuple>::get() {
     if (result) return *result;
     else {
-        if (!response->waitForResult() && response->error() == store::error::not_found) {
+        bool valid;
+        {
+            impl::TimelineWait wait(cache->mTimeline, WaitSite::Get);
+            valid = response->waitForResult();
+        }
+        impl::endRequest(cache->mTimeline, span);
+        if (!valid && requestBegin != 0) {
+            cache->mNodes.end(NodeOperation::Get, cache->mHandle, cache->mTable, key.value, requestBegin);
+        }
+        if (!valid && response->error() == store::error::not_found) {
             crossbow::string msg = "Tuple with key ";
             msg += boost::lexical_cast<crossbow::string>(key);
             msg += " does not exist";
             throw std::range_error(msg.data());
         }
         auto resp = response->get();
+        if (requestBegin != 0) {
+            cache->mNodes.end(NodeOperation::Get, cache->mHandle, cache->mTable, key.value, requestBegin,
+                    resp->size());
+        }
         result = &cache->addTuple(key, *resp);
         return *result;
     }
@@ -25,6 +25,9 @@
 #include <bdtree/logical_table_cache.h>
 #include <crossbow/ChunkAllocator.hpp>
 
+#include <memory>
+#include <vector>
+
 #include "ChunkUnorderedMap.hpp"
 #include "Indexes.hpp"
 
@@ -32,11 +35,16 @@ namespace tell {
 namespace store {
 class Table;
 class Tuple;
+class ModificationResponse;
 } // namespace store
 namespace db {
 namespace impl {
 
 struct TellDBContext;
+class Metrics;
+class ConflictProfiler;
+class NodeStatsRecorder;
+class TransactionTimeline;
 
 } // namespace impl
 
@@ -52,21 +60,40 @@ public: // public types
 private: // private types
     using id_t = tell::store::Schema::id_t;
     friend class Future<Tuple>;
+    struct PendingRevert {
+        std::shared_ptr<tell::store::ModificationResponse> response;
+        uint64_t key;
+        uint32_t span;
+        uint64_t begin;
+    };
 private: // members
     const tell::store::Table& mTable;
     tell::store::ClientHandle& mHandle;
     const commitmanager::SnapshotDescriptor& mSnapshot;
     crossbow::ChunkMemoryPool& mPool;
+    impl::Metrics& mMetrics;
+    impl::ConflictProfiler& mConflicts;
+    impl::NodeStatsRecorder& mNodes;
+    impl::TransactionTimeline* mTimeline;
     ChunkUnorderedMap<key_t, std::pair<Tuple*, bool>> mCache;
-    ChangesMap mChanges;
-    ChunkUnorderedMap<crossbow::string, id_t> mSchema;
+    // allocated from the pool on the first write, tables only read from never allocate it
+    ChangesMap* mChanges = nullptr;
+    // reverts issued but not yet acknowledged by the storage
+    std::vector<PendingRevert, crossbow::ChunkAllocator<PendingRevert>> mReverts;
     std::unordered_map<crossbow::string, impl::IndexWrapper> mIndexes;
+    // false until the indexes were opened, a table without indexes has none even then
+    bool mIndexesOpened;
 public: // Construction and Destruction
     TableCache(const tell::store::Table& table,
             tell::store::ClientHandle& handle,
             const commitmanager::SnapshotDescriptor& snapshot,
             crossbow::ChunkMemoryPool& pool,
-            std::unordered_map<crossbow::string, impl::IndexWrapper>&& indexes);
+            impl::Metrics& metrics,
+            impl::ConflictProfiler& conflicts,
+            impl::NodeStatsRecorder& nodes,
+            impl::TransactionTimeline* timeline,
+            std::unordered_map<crossbow::string, impl::IndexWrapper>&& indexes,
+            bool indexesOpened = true);
     ~TableCache();
 public: // operations
     Future<Tuple> get(key_t key);
@@ -75,12 +102,44 @@ public: // operations
     void insert(key_t key, const Tuple& tuple);
     void update(key_t key, const Tuple& from, const Tuple& to);
     void remove(key_t key, const Tuple& tuple);
+    /**
+     * @brief Writes all changes to the storage
+     *
+     * On the first conflict the transaction is doomed, so the changes already written are reverted right away and the
+     * remaining writes are reverted as soon as they are acknowledged. The reverts are only awaited by finishRollback.
+     */
     void writeBack();
-    void rollback();
+    /**
+     * @brief Issues a revert for every change written to the storage without waiting for the responses
+     */
+    void startRollback();
+    /**
+     * @brief Waits until all reverts issued by startRollback or a failed writeBack are acknowledged
+     */
+    void finishRollback();
     void writeIndexes();
     void undoIndexes();
+    /**
+     * @brief Adds the estimated memory of the cached tuples, changes and index entries
+     */
+    void memoryUsage(TransactionMemory& memory) const;
+    /**
+     * @brief Sets the indexes of a table opened without them
+     *
+     * Read-only transactions only open the indexes of a table when they are first queried.
+     */
+    void setIndexes(std::unordered_map<crossbow::string, impl::IndexWrapper>&& indexes) {
+        mIndexes = std::move(indexes);
+        mIndexesOpened = true;
+    }
 public: // state access
-    const ChangesMap& changes() const {
+    bool hasChanges() const {
+        return (mChanges != nullptr && !mChanges->empty());
+    }
+    /**
+     * @brief The changes of the table (nullptr if the table was never written)
+     */
+    const ChangesMap* changes() const {
         return mChanges;
     }
     const store::Table& table() const {
@@ -89,8 +148,13 @@ public: // state access
     const std::unordered_map<crossbow::string, impl::IndexWrapper>& indexes() const {
         return mIndexes;
     }
+    bool indexesOpened() const {
+        return mIndexesOpened;
+    }
 private:
     const Tuple& addTuple(key_t key, const tell::store::Tuple& tuple);
+    ChangesMap& writeSet();
+    void revert(ChangesMap::iterator iter);
 };
 
 } // namespace db
@@ -43,17 +43,17 @@ namespace db {
  */
 class TableData {
 public:
-    TableData(store::Table table, std::shared_ptr<store::Table> counterTable)
+    TableData(store::Table table, std::shared_ptr<store::Table> counterTable, impl::Metrics& metrics)
             : mTable(std::move(table)),
-              mKeyCounter(std::move(counterTable), mTable.tableId()) {
+              mKeyCounter(std::move(counterTable), mTable.tableId(), metrics) {
     }
 
     operator const store::Table&() const {
         return mTable;
     }
 
-    uint64_t nextKey(store::ClientHandle& handle) {
-        return mKeyCounter.incrementAndGet(handle);
+    uint64_t nextKey(store::ClientHandle& handle, impl::TransactionTimeline* timeline) {
+        return mKeyCounter.incrementAndGet(handle, timeline);
     }
 
     uint64_t remoteKey(store::ClientHandle& handle) const {
@@ -21,20 +21,83 @@
  *     Lucas Braun <braunl@inf.ethz.ch>
  */
 #include <telldb/TellDB.hpp>
+#include <telldb/Exceptions.hpp>
 #include <random>
 #include <boost/lexical_cast.hpp>
 #include "Indexes.hpp"
+#include "Trace.hpp"
+#include "CommitStats.hpp"
+#include "Metrics.hpp"
+#include "Timeline.hpp"
+#include "TransactionStats.hpp"
+#include "ConflictProfiler.hpp"
+#include "MemoryStats.hpp"
+#include "WaitStats.hpp"
+#include "NodeStats.hpp"
+#include "CommitBatcher.hpp"
 
 namespace tell {
 namespace db {
 namespace impl {
 
-Indexes* createIndexes(store::ClientHandle& handle) {
-    return new Indexes(handle);
+Indexes* createIndexes(store::ClientHandle& handle, TellDBContext& context) {
+    return new Indexes(handle, *context.metrics, *context.nodes);
+}
+
+template<>
+std::shared_ptr<CommitStatsRecorder> ClientTable::registerRecorder() {
+    return mCommitStatsRecorders.create();
+}
+
+template<>
+std::shared_ptr<Metrics> ClientTable::registerRecorder() {
+    return mMetrics.create();
+}
+
+template<>
+std::shared_ptr<TransactionStatsRecorder> ClientTable::registerRecorder() {
+    return mTransactionStatsRecorders.create();
+}
+
+template<>
+std::shared_ptr<ConflictProfiler> ClientTable::registerRecorder() {
+    return mConflictProfilers.create();
+}
+
+template<>
+std::shared_ptr<MemoryRecorder> ClientTable::registerRecorder() {
+    return mMemoryRecorders.create();
+}
+
+template<>
+std::shared_ptr<WaitRecorder> ClientTable::registerRecorder() {
+    return mWaitRecorders.create();
+}
+
+template<>
+std::shared_ptr<NodeStatsRecorder> ClientTable::registerRecorder() {
+    // Under the lock of setNodeStatsEnabled, so the new recorder does not miss a change
+    std::lock_guard<std::mutex> _(mStatsMutex);
+    auto recorder = mNodeStatsRecorders.create();
+    recorder->setNodes(mNodeStatsEnabled ? mStorageNodes : 0);
+    return recorder;
+}
+
+std::unique_ptr<commitmanager::SnapshotDescriptor> startSnapshot(store::ClientHandle& handle, TellDBContext& context,
+        store::TransactionType type) {
+    return context.commitBatcher->startTransaction(handle, type);
 }
 
 TellDBContext::TellDBContext(ClientTable* table)
     : clientTable(table)
+    , commitStats(table->registerRecorder<CommitStatsRecorder>())
+    , metrics(table->registerRecorder<Metrics>())
+    , transactionStats(table->registerRecorder<TransactionStatsRecorder>())
+    , conflictProfiler(table->registerRecorder<ConflictProfiler>())
+    , memory(table->registerRecorder<MemoryRecorder>())
+    , waits(table->registerRecorder<WaitRecorder>())
+    , nodes(table->registerRecorder<NodeStatsRecorder>())
+    , commitBatcher(new CommitBatcher(*table, *metrics))
 {}
 
 void TellDBContext::setIndexes(Indexes* idxs) {
@@ -78,6 +141,142 @@ void ClientTable::init(store::ClientHandle& handle) {
                     schema)));
 }
 
+void ClientTable::startTrace(const crossbow::string& path) {
+    std::atomic_store(&mTracer, std::make_shared<TraceWriter>(path));
+}
+
+void ClientTable::stopTrace() {
+    std::atomic_store(&mTracer, std::shared_ptr<TraceWriter>());
+}
+
+void ClientTable::startTimeline(const crossbow::string& path, uint64_t sampleInterval) {
+    std::atomic_store(&mTimeline, std::make_shared<TimelineWriter>(path, sampleInterval));
+}
+
+void ClientTable::stopTimeline() {
+    std::atomic_store(&mTimeline, std::shared_ptr<TimelineWriter>());
+}
+
+CommitStats ClientTable::commitStats() {
+    CommitStats stats;
+    mCommitStatsRecorders.snapshot(stats);
+    return stats;
+}
+
+MetricsSnapshot ClientTable::metrics() {
+    MetricsSnapshot snapshot;
+    mMetrics.snapshot(snapshot);
+    return snapshot;
+}
+
+uint32_t ClientTable::transactionType(const crossbow::string& name) {
+    if (auto types = std::atomic_load(&mTransactionTypes)) {
+        auto i = types->find(name);
+        if (i != types->end()) {
+            return i->second;
+        }
+    }
+    std::lock_guard<std::mutex> _(mStatsMutex);
+    auto types = std::atomic_load(&mTransactionTypes);
+    if (types) {
+        auto i = types->find(name);
+        if (i != types->end()) {
+            return i->second;
+        }
+    }
+    // The last slot collects all names that do not fit
+    if (mTransactionTypeNames.size() == TransactionStatsRecorder::TYPE_SLOTS - 1) {
+        return TransactionStatsRecorder::TYPE_SLOTS - 1;
+    }
+    auto id = static_cast<uint32_t>(mTransactionTypeNames.size());
+    mTransactionTypeNames.push_back(name);
+    auto next = (types ? std::make_shared<std::unordered_map<crossbow::string, uint32_t>>(*types)
+            : std::make_shared<std::unordered_map<crossbow::string, uint32_t>>());
+    next->emplace(name, id);
+    std::atomic_store(&mTransactionTypes, std::shared_ptr<const std::unordered_map<crossbow::string, uint32_t>>(next));
+    return id;
+}
+
+TransactionStats ClientTable::transactionStats() {
+    TransactionStats stats;
+    stats.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mCreated);
+    std::lock_guard<std::mutex> _(mStatsMutex);
+    mTransactionStatsRecorders.snapshot(stats, mTransactionTypeNames);
+    return stats;
+}
+
+ConflictReport ClientTable::conflictReport(size_t top) {
+    return ConflictProfiler::report(mConflictProfilers.recorders(), top);
+}
+
+MemoryStats ClientTable::memoryStats() {
+    MemoryStats stats;
+    mMemoryRecorders.snapshot(stats);
+    return stats;
+}
+
+WaitStats ClientTable::waitStats() {
+    WaitStats stats;
+    mWaitRecorders.snapshot(stats);
+    return stats;
+}
+
+void ClientTable::setNodeStatsEnabled(bool enabled) {
+    std::lock_guard<std::mutex> _(mStatsMutex);
+    mNodeStatsEnabled = enabled;
+    mNodeStatsRecorders.forEach([this, enabled](NodeStatsRecorder& recorder) {
+        recorder.setNodes(enabled ? mStorageNodes : 0);
+    });
+}
+
+NodeStats ClientTable::nodeStats() {
+    NodeStats stats;
+    std::lock_guard<std::mutex> _(mStatsMutex);
+    stats.nodes.resize(mStorageNodes);
+    mNodeStatsRecorders.snapshot(stats);
+    return stats;
+}
+
+void runNamedTransaction(store::ClientHandle& handle, TellDBContext& context, store::TransactionType type,
+        uint32_t typeId, uint32_t maxRetries, const std::function<void(Transaction&)>& fun) {
+    auto begin = CycleClock::now();
+    uint32_t retries = 0;
+    auto finish = [&context, typeId, begin, &retries]() {
+        context.transactionStats->recordTransaction(typeId, CycleClock::toDuration(CycleClock::now() - begin),
+                retries);
+    };
+    while (true) {
+        // The transaction is rolled back when leaving the scope, so the attempt is recorded before the handlers run
+        try {
+            Transaction transaction(handle, context, startSnapshot(handle, context, type), type);
+            transaction.mStats = context.transactionStats.get();
+            transaction.mStatsType = typeId;
+            fun(transaction);
+            break;
+        } catch (Conflict&) {
+            if (retries == maxRetries) {
+                finish();
+                throw;
+            }
+        } catch (Conflicts&) {
+            if (retries == maxRetries) {
+                finish();
+                throw;
+            }
+        } catch (IndexConflict&) {
+            if (retries == maxRetries) {
+                finish();
+                throw;
+            }
+        } catch (...) {
+            finish();
+            throw;
+        }
+        ++retries;
+    }
+    finish();
+}
+
 void ClientTable::destroy(store::ClientHandle& handle) {
     // TODO: drop table
     // TODO: delete entry from ClientTable
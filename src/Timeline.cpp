@@ -0,0 +1,155 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Timeline.hpp"
+#include "WaitStats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace tell {
+namespace db {
+namespace impl {
+namespace {
+
+const char* typeName(store::TransactionType type) {
+    switch (type) {
+    case store::TransactionType::READ_WRITE:
+        return "read-write";
+    case store::TransactionType::READ_ONLY:
+        return "read-only";
+    case store::TransactionType::ANALYTICAL:
+        return "analytical";
+    }
+    return "unknown";
+}
+
+void writeString(std::ostream& out, const crossbow::string& str) {
+    out << '"';
+    for (auto c : str) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+/**
+ * @brief Writes the common fields of an event, timestamps are in microseconds
+ */
+void writeEvent(std::ostream& out, const char* name, const char* phase, uint64_t tid, int64_t ts) {
+    out << ",\n{\"name\":\"" << name << "\",\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << tid
+        << ",\"ts\":" << (double(ts) / 1000.0);
+}
+
+} // anonymous namespace
+
+TimelineWriter::TimelineWriter(const crossbow::string& path, uint64_t sampleInterval)
+    : mOut(path.c_str(), std::ios::trunc)
+    , mStart(Clock::now())
+    , mSampleInterval(sampleInterval == 0 ? 1 : sampleInterval)
+    , mTransactions(0)
+{
+    if (!mOut) {
+        throw std::runtime_error("Unable to open timeline file");
+    }
+    // Every event starts with a separating comma, the first entry is a metadata event naming the process
+    mOut << "[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"TellDB\"}}";
+}
+
+TimelineWriter::~TimelineWriter() {
+    mOut << "\n]\n";
+}
+
+void TimelineWriter::write(const std::string& events) {
+    std::lock_guard<std::mutex> _(mMutex);
+    mOut << events;
+    mOut.flush();
+}
+
+TransactionTimeline::TransactionTimeline(std::shared_ptr<TimelineWriter> writer, uint64_t id,
+        store::TransactionType type, WaitRecorder* waits)
+    : mWriter(std::move(writer))
+    , mId(id)
+    , mType(type)
+    , mRecorder(waits)
+    , mWaitSite(WaitSite::Get)
+    , mWaitBegin(0)
+{
+    mBegin = (mWriter ? now() : 0);
+}
+
+void TransactionTimeline::endWait(uint32_t span) {
+    auto duration = CycleClock::toDuration(CycleClock::now() - mWaitBegin);
+    auto& site = mWaits.sites[static_cast<size_t>(mWaitSite)];
+    ++site.waits;
+    site.total += duration;
+    site.longest = std::max(site.longest, duration);
+    if (mRecorder) {
+        mRecorder->record(mWaitSite, duration);
+    }
+    end(span);
+}
+
+uint32_t TransactionTimeline::add(const char* name, const crossbow::string* table, uint64_t key, bool wait) {
+    mSpans.emplace_back(Span{name, (table ? *table : crossbow::string()), key, now(), -1, wait});
+    return static_cast<uint32_t>(mSpans.size());
+}
+
+void TransactionTimeline::finish(const char* outcome) {
+    if (!mWriter) {
+        return;
+    }
+    auto end = now();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << mId << ",\"args\":{\"name\":\"transaction "
+        << mId << " (" << typeName(mType) << ")\"}}";
+    writeEvent(out, "transaction", "X", mId, mBegin);
+    out << ",\"dur\":" << (double(end - mBegin) / 1000.0) << ",\"args\":{\"outcome\":\"" << outcome << "\"}}";
+    for (size_t i = 0; i < mSpans.size(); ++i) {
+        auto& span = mSpans[i];
+        // Requests whose result was never consumed end with the transaction
+        auto spanEnd = (span.end < 0 ? end : span.end);
+        if (span.wait) {
+            writeEvent(out, "wait", "X", mId, span.begin);
+            out << ",\"dur\":" << (double(spanEnd - span.begin) / 1000.0) << ",\"args\":{\"for\":\"" << span.name
+                << "\"}}";
+            continue;
+        }
+        // Requests overlap, async events get a row of their own when they do
+        writeEvent(out, span.name, "b", mId, span.begin);
+        out << ",\"cat\":\"request\",\"id\":\"" << mId << '.' << i << "\",\"args\":{\"table\":";
+        writeString(out, span.table);
+        out << ",\"key\":" << span.key << "}}";
+        writeEvent(out, span.name, "e", mId, spanEnd);
+        out << ",\"cat\":\"request\",\"id\":\"" << mId << '.' << i << "\"}";
+    }
+    mWriter->write(out.str());
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
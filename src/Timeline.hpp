@@ -0,0 +1,232 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "CommitStats.hpp"
+
+#include <telldb/WaitStats.hpp>
+#include <tellstore/ClientManager.hpp>
+
+#include <crossbow/string.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tell {
+namespace db {
+namespace impl {
+
+class WaitRecorder;
+
+/**
+ * @brief Writes the timelines of sampled transactions as Chrome trace events
+ *
+ * The file is a JSON array of trace events that can be loaded into chrome://tracing or Perfetto. Every sampled
+ * transaction gets its own track, requests to the storage and the commit manager are shown as async spans from the
+ * time they were issued until their result was consumed, the times the fiber blocked as nested spans on the track.
+ */
+class TimelineWriter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param sampleInterval Every n-th transaction is recorded
+     */
+    TimelineWriter(const crossbow::string& path, uint64_t sampleInterval);
+
+    ~TimelineWriter();
+
+    Clock::time_point start() const {
+        return mStart;
+    }
+
+    /**
+     * @brief Assigns an id to a new transaction
+     *
+     * @return The id or 0 if the transaction is not sampled
+     */
+    uint64_t sample() {
+        auto id = mTransactions.fetch_add(1) + 1;
+        return (id % mSampleInterval == 0 ? id : 0);
+    }
+
+    /**
+     * @brief Appends already formatted events (each one starting with a separating comma)
+     */
+    void write(const std::string& events);
+
+private:
+    std::mutex mMutex;
+    std::ofstream mOut;
+    Clock::time_point mStart;
+    uint64_t mSampleInterval;
+    std::atomic<uint64_t> mTransactions;
+};
+
+/**
+ * @brief Requests and blocking times of a transaction
+ *
+ * Only used by the fiber running the transaction. The times the fiber blocked are accounted for every transaction
+ * while wait profiling is enabled. The spans of the requests and waits are only kept for transactions sampled for the
+ * timeline (with a writer), they are buffered and written when the transaction finishes.
+ */
+class TransactionTimeline {
+public:
+    /**
+     * @param writer The timeline the spans are written to (nullptr if the transaction is not sampled)
+     * @param waits The recorder every wait is recorded with (nullptr if wait profiling is disabled)
+     */
+    TransactionTimeline(std::shared_ptr<TimelineWriter> writer, uint64_t id, store::TransactionType type,
+            WaitRecorder* waits);
+
+    /**
+     * @brief Starts the span of a request on the given table and key
+     *
+     * @return The id of the span to pass to end (0 if the transaction is not sampled)
+     */
+    uint32_t begin(const char* operation, const crossbow::string& table, uint64_t key) {
+        return (mWriter ? add(operation, &table, key, false) : 0);
+    }
+
+    void end(uint32_t span) {
+        if (span != 0) {
+            mSpans[span - 1].end = now();
+        }
+    }
+
+    /**
+     * @brief Starts a wait during which the fiber is blocked
+     *
+     * The fiber can only block at one site at a time.
+     *
+     * @return The id of the span to pass to endWait
+     */
+    uint32_t beginWait(WaitSite site) {
+        mWaitSite = site;
+        mWaitBegin = CycleClock::now();
+        return (mWriter ? add(waitSiteName(site), nullptr, 0, true) : 0);
+    }
+
+    void endWait(uint32_t span);
+
+    const TransactionWaits& waits() const {
+        return mWaits;
+    }
+
+    /**
+     * @brief Writes the transaction with all its spans to the timeline if it was sampled
+     */
+    void finish(const char* outcome);
+
+private:
+    struct Span {
+        const char* name;
+        crossbow::string table;
+        uint64_t key;
+        int64_t begin;
+        int64_t end;
+        bool wait;
+    };
+
+    int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(TimelineWriter::Clock::now() - mWriter->start())
+                .count();
+    }
+
+    uint32_t add(const char* name, const crossbow::string* table, uint64_t key, bool wait);
+
+    std::shared_ptr<TimelineWriter> mWriter;
+    uint64_t mId;
+    store::TransactionType mType;
+    int64_t mBegin;
+    std::vector<Span> mSpans;
+    WaitRecorder* mRecorder;
+    TransactionWaits mWaits;
+    WaitSite mWaitSite;
+    uint64_t mWaitBegin;
+};
+
+/**
+ * @brief Starts the span of an asynchronous request, does nothing if the transaction is not instrumented
+ */
+inline uint32_t beginRequest(TransactionTimeline* timeline, const char* operation, const crossbow::string& table,
+        uint64_t key) {
+    return (timeline ? timeline->begin(operation, table, key) : 0);
+}
+
+inline void endRequest(TransactionTimeline* timeline, uint32_t span) {
+    if (timeline) {
+        timeline->end(span);
+    }
+}
+
+/**
+ * @brief Records the time the fiber is blocked until the object is destroyed
+ */
+class TimelineWait {
+public:
+    TimelineWait(TransactionTimeline* timeline, WaitSite site)
+        : mTimeline(timeline)
+        , mSpan(timeline ? timeline->beginWait(site) : 0)
+    {}
+
+    ~TimelineWait() {
+        if (mTimeline) {
+            mTimeline->endWait(mSpan);
+        }
+    }
+
+private:
+    TransactionTimeline* mTimeline;
+    uint32_t mSpan;
+};
+
+/**
+ * @brief Records a request the fiber waits for until the object is destroyed
+ */
+class TimelineRequest {
+public:
+    TimelineRequest(TransactionTimeline* timeline, const char* operation, const crossbow::string& table,
+            uint64_t key, WaitSite site)
+        : mTimeline(timeline)
+        , mSpan(beginRequest(timeline, operation, table, key))
+        , mWait(timeline, site)
+    {}
+
+    ~TimelineRequest() {
+        endRequest(mTimeline, mSpan);
+    }
+
+private:
+    TransactionTimeline* mTimeline;
+    uint32_t mSpan;
+    TimelineWait mWait;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
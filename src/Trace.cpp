@@ -0,0 +1,188 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "Trace.hpp"
+#include "FieldSerialize.hpp"
+
+#include <telldb/Tuple.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace tell {
+namespace db {
+namespace {
+
+constexpr size_t gMagicLength = 8;
+
+template<class A>
+void applyForEntry(A& ar, TraceEntry& entry) {
+    ar & entry.operation;
+    ar & entry.time;
+    ar & entry.table;
+    ar & entry.key;
+    ar & entry.advanced;
+    ar & entry.index;
+    uint32_t numValues = entry.values.size();
+    ar & numValues;
+    entry.values.resize(numValues);
+    for (auto& value : entry.values) {
+        ar & value;
+    }
+}
+
+template<class A>
+void applyForTrace(A& ar, TraceTransaction& transaction) {
+    ar & transaction.start;
+    ar & transaction.duration;
+    ar & transaction.type;
+    ar & transaction.outcome;
+    uint32_t numTables = transaction.tables.size();
+    ar & numTables;
+    transaction.tables.resize(numTables);
+    for (auto& table : transaction.tables) {
+        ar & table;
+    }
+    uint32_t numEntries = transaction.entries.size();
+    ar & numEntries;
+    transaction.entries.resize(numEntries);
+    for (auto& entry : transaction.entries) {
+        applyForEntry(ar, entry);
+    }
+}
+
+} // anonymous namespace
+
+TraceReader::TraceReader(const crossbow::string& path)
+    : mIn(path.c_str(), std::ios::binary)
+{
+    char magic[gMagicLength];
+    if (!mIn.read(magic, gMagicLength) || memcmp(magic, impl::TraceWriter::MAGIC, gMagicLength) != 0) {
+        throw std::runtime_error("Not a TellDB trace");
+    }
+}
+
+bool TraceReader::next(TraceTransaction& transaction) {
+    uint32_t size;
+    if (!mIn.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+        return false;
+    }
+    mBuffer.resize(size);
+    if (!mIn.read(mBuffer.data(), size)) {
+        throw std::runtime_error("Trace is truncated");
+    }
+    crossbow::deserializer des(reinterpret_cast<const uint8_t*>(mBuffer.data()));
+    applyForTrace(des, transaction);
+    return true;
+}
+
+namespace impl {
+
+constexpr const char* TraceWriter::MAGIC;
+
+TraceWriter::TraceWriter(const crossbow::string& path)
+    : mOut(path.c_str(), std::ios::binary | std::ios::trunc)
+    , mStart(Clock::now())
+{
+    if (!mOut) {
+        throw std::runtime_error("Unable to open trace file");
+    }
+    mOut.write(MAGIC, gMagicLength);
+}
+
+void TraceWriter::write(const TraceTransaction& transaction) {
+    // The archivers only read from the transaction when serializing
+    auto& t = const_cast<TraceTransaction&>(transaction);
+    crossbow::sizer s;
+    applyForTrace(s, t);
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[s.size]);
+    crossbow::serializer ser(buffer.get());
+    applyForTrace(ser, t);
+    ser.buffer.release();
+
+    uint32_t size = s.size;
+    std::lock_guard<std::mutex> _(mMutex);
+    mOut.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    mOut.write(reinterpret_cast<const char*>(buffer.get()), size);
+}
+
+TransactionTrace::TransactionTrace(std::shared_ptr<TraceWriter> writer, store::TransactionType type)
+    : mWriter(std::move(writer))
+    , mBegin(TraceWriter::Clock::now())
+{
+    mTransaction.start = std::chrono::duration_cast<std::chrono::nanoseconds>(mBegin - mWriter->start()).count();
+    mTransaction.duration = 0;
+    mTransaction.type = type;
+    mTransaction.outcome = TraceOutcome::RolledBack;
+}
+
+TraceEntry& TransactionTrace::add(TraceOperation operation, const crossbow::string& table, uint64_t key) {
+    uint32_t tableIdx = 0;
+    while (tableIdx < mTransaction.tables.size() && mTransaction.tables[tableIdx] != table) {
+        ++tableIdx;
+    }
+    if (tableIdx == mTransaction.tables.size()) {
+        mTransaction.tables.push_back(table);
+    }
+    mEntries.emplace_back();
+    auto& entry = mEntries.back();
+    entry.operation = operation;
+    entry.time = std::chrono::duration_cast<std::chrono::nanoseconds>(TraceWriter::Clock::now() - mBegin).count();
+    entry.table = tableIdx;
+    entry.key = key;
+    entry.advanced = 0;
+    return entry;
+}
+
+std::shared_ptr<uint64_t> TransactionTrace::addRange(TraceOperation operation, const crossbow::string& table,
+        const crossbow::string& index, const KeyType& key) {
+    auto& entry = add(operation, table, 0);
+    entry.index = index;
+    entry.values = key;
+    auto advanced = std::make_shared<uint64_t>(0);
+    mRanges.emplace_back(&entry, advanced);
+    return advanced;
+}
+
+void TransactionTrace::addTuple(TraceOperation operation, const crossbow::string& table, uint64_t key,
+        const Tuple& tuple) {
+    auto& entry = add(operation, table, key);
+    entry.values.reserve(tuple.count());
+    for (Tuple::id_t i = 0; i < tuple.count(); ++i) {
+        entry.values.push_back(tuple[i]);
+    }
+}
+
+void TransactionTrace::finish(TraceOutcome outcome) {
+    mTransaction.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            TraceWriter::Clock::now() - mBegin).count();
+    mTransaction.outcome = outcome;
+    for (auto& range : mRanges) {
+        range.first->advanced = *range.second;
+    }
+    mTransaction.entries.assign(mEntries.begin(), mEntries.end());
+    mWriter->write(mTransaction);
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,119 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include <telldb/Iterator.hpp>
+#include <telldb/Trace.hpp>
+
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace tell {
+namespace db {
+
+class Tuple;
+
+namespace impl {
+
+/**
+ * @brief Appends finished transactions to a trace file
+ *
+ * Every transaction is written as a 32 bit length followed by the serialized TraceTransaction. Writing is serialized
+ * with a mutex, transactions only write once when they finish.
+ */
+class TraceWriter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr const char* MAGIC = "TELLTRC1";
+
+    TraceWriter(const crossbow::string& path);
+
+    Clock::time_point start() const {
+        return mStart;
+    }
+
+    void write(const TraceTransaction& transaction);
+
+private:
+    std::mutex mMutex;
+    std::ofstream mOut;
+    Clock::time_point mStart;
+};
+
+/**
+ * @brief Operations of a running transaction that get written to the trace when it finishes
+ */
+class TransactionTrace {
+public:
+    TransactionTrace(std::shared_ptr<TraceWriter> writer, store::TransactionType type);
+
+    /**
+     * @brief Adds an operation on the given table
+     *
+     * @return The entry, its address stays valid until the trace is written
+     */
+    TraceEntry& add(TraceOperation operation, const crossbow::string& table, uint64_t key);
+
+    void addTuple(TraceOperation operation, const crossbow::string& table, uint64_t key, const Tuple& tuple);
+
+    /**
+     * @brief Adds a range query on the given index
+     *
+     * @return Counter for the iterator of the range query, its value is recorded when the trace is written
+     */
+    std::shared_ptr<uint64_t> addRange(TraceOperation operation, const crossbow::string& table,
+            const crossbow::string& index, const KeyType& key);
+
+    /**
+     * @brief Sets the outcome of the transaction without finishing it (used before the commit is attempted)
+     */
+    void setOutcome(TraceOutcome outcome) {
+        mTransaction.outcome = outcome;
+    }
+
+    TraceOutcome outcome() const {
+        return mTransaction.outcome;
+    }
+
+    /**
+     * @brief Writes the transaction to the trace
+     */
+    void finish(TraceOutcome outcome);
+
+private:
+    std::shared_ptr<TraceWriter> mWriter;
+    TraceWriter::Clock::time_point mBegin;
+    TraceTransaction mTransaction;
+    std::deque<TraceEntry> mEntries;
+    // range queries and the counters shared with their iterators
+    std::vector<std::pair<TraceEntry*, std::shared_ptr<uint64_t>>> mRanges;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
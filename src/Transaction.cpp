@@ -22,6 +22,16 @@
  */
 #include "TransactionCache.hpp"
 #include "RemoteCounter.hpp"
+#include "Trace.hpp"
+#include "CommitStats.hpp"
+#include "Metrics.hpp"
+#include "Timeline.hpp"
+#include "TransactionStats.hpp"
+#include "MemoryStats.hpp"
+#include "WaitStats.hpp"
+#include "NodeStats.hpp"
+#include "CommitBatcher.hpp"
+#include "Probes.hpp"
 
 #include <telldb/TellDB.hpp>
 #include <telldb/ScanQuery.hpp>
@@ -29,6 +39,10 @@
 #include <telldb/Exceptions.hpp>
 #include <tellstore/ClientManager.hpp>
 
+#include <crossbow/logger.hpp>
+
+#include <string>
+
 using namespace tell::store;
 
 namespace tell {
@@ -37,6 +51,29 @@ namespace {
 
 constexpr size_t gMaxUndoLogSize = 16*1024;
 
+using impl::CycleClock;
+
+CommitProfile::Duration elapsedSince(uint64_t& begin) {
+    auto now = CycleClock::now();
+    auto duration = CycleClock::toDuration(now - begin);
+    begin = now;
+    return duration;
+}
+
+std::shared_ptr<impl::TransactionTimeline> sampleTimeline(impl::TellDBContext& context,
+        store::TransactionType type) {
+    auto writer = context.clientTable->timeline();
+    auto id = (writer ? writer->sample() : 0);
+    if (id == 0) {
+        writer.reset();
+    }
+    auto waits = (context.clientTable->waitProfilingEnabled() ? context.waits.get() : nullptr);
+    if (!writer && !waits) {
+        return nullptr;
+    }
+    return std::make_shared<impl::TransactionTimeline>(std::move(writer), id, type, waits);
+}
+
 } // anonymous namespace
 
 using namespace impl;
@@ -48,20 +85,21 @@ public:
     CounterImpl(RemoteCounter&& counter)
         : remoteCounter(std::move(counter))
     {}
-    uint64_t next(store::ClientHandle& handle) {
-        return remoteCounter.incrementAndGet(handle);
+    uint64_t next(store::ClientHandle& handle, TransactionTimeline* timeline) {
+        return remoteCounter.incrementAndGet(handle, timeline);
     }
 };
 
-Counter::Counter(CounterImpl* impl, store::ClientHandle& handle)
+Counter::Counter(CounterImpl* impl, store::ClientHandle& handle, std::shared_ptr<TransactionTimeline> timeline)
     : impl(impl)
     , mHandle(handle)
+    , mTimeline(std::move(timeline))
 {}
 Counter::Counter(Counter&&) = default;
 Counter::~Counter() = default;
 
 uint64_t Counter::next() {
-    return impl->next(mHandle);
+    return impl->next(mHandle, mTimeline.get());
 }
 
 TellDBContext::~TellDBContext() {
@@ -78,9 +116,14 @@ Transaction::Transaction(ClientHandle& handle, TellDBContext& context,
     : mHandle(handle)
     , mContext(context)
     , mSnapshot(std::move(snapshot))
-    , mCache(new (&mPool) TransactionCache(context, mHandle, *mSnapshot, mPool))
+    , mTimeline(sampleTimeline(context, type))
     , mType(type)
+    , mBeginTicks(CycleClock::now())
 {
+    TELLDB_PROBE2(transaction__start, mSnapshot->version(), static_cast<int>(type));
+    if (auto tracer = context.clientTable->tracer()) {
+        mTrace.reset(new TransactionTrace(std::move(tracer), type));
+    }
 }
 
 crossbow::ChunkMemoryPool& Transaction::pool() {
@@ -94,11 +137,11 @@ Transaction::~Transaction() {
 }
 
 Future<table_t> Transaction::openTable(const crossbow::string& name) {
-    return mCache->openTable(name);
+    return cache().openTable(name);
 }
 
 table_t Transaction::createTable(const crossbow::string& name, const store::Schema& schema) {
-    return mCache->createTable(name, schema);
+    return cache().createTable(name, schema);
 }
 
 const tell::store::Schema& Transaction::getSchema(table_t table) {
@@ -123,26 +166,45 @@ Counter Transaction::getCounter(const crossbow::string& name) {
         auto counterName = globalCounterName(name);
         auto tId = openTable(counterName).get();
         auto table = std::make_shared<store::Table>(*mContext.tables.at(tId));
-        counterImpl = new CounterImpl(RemoteCounter(std::move(table), 1));
+        auto batchSize = mContext.clientTable->counterBatchSize();
+        counterImpl = new CounterImpl(RemoteCounter(std::move(table), 1, *mContext.metrics,
+                batchSize == 0 ? RemoteCounter::DEFAULT_BATCH : batchSize));
         auto res = mContext.counters.emplace(name, counterImpl);
         if (!res.second) {
             delete counterImpl;
             counterImpl = res.first->second;
         }
     }
-    return Counter(counterImpl, mHandle);
+    return Counter(counterImpl, mHandle, mTimeline);
 }
 
 Future<Tuple> Transaction::get(table_t table, key_t key) {
-    return mCache->get(table, key);
+    if (mTrace) {
+        mTrace->add(TraceOperation::Get, tableName(table), key);
+    }
+    return cache().get(table, key);
 }
 
 Iterator Transaction::lower_bound(table_t tableId, const crossbow::string& idxName, const KeyType& key) {
-    return mCache->lower_bound(tableId, idxName, key);
+    auto iter = cache().lower_bound(tableId, idxName, key);
+    if (mTrace) {
+        return traceRange(std::move(iter), TraceOperation::LowerBound, tableId, idxName, key);
+    }
+    return iter;
 }
 
 Iterator Transaction::reverse_lower_bound(table_t tableId, const crossbow::string& idxName, const KeyType& key) {
-    return mCache->reverse_lower_bound(tableId, idxName, key);
+    auto iter = cache().reverse_lower_bound(tableId, idxName, key);
+    if (mTrace) {
+        return traceRange(std::move(iter), TraceOperation::ReverseLowerBound, tableId, idxName, key);
+    }
+    return iter;
+}
+
+Iterator Transaction::traceRange(Iterator iter, TraceOperation operation, table_t tableId,
+        const crossbow::string& idxName, const KeyType& key) {
+    iter.mTraceCount = mTrace->addRange(operation, tableName(tableId), idxName, key);
+    return iter;
 }
 
 Tuple Transaction::newTuple(table_t table) {
@@ -183,19 +245,31 @@ void Transaction::insert(table_t table, key_t key, const std::unordered_map<cros
     for (; i < numVarSize + numFixedSize; ++i) {
         setField(i, varSizeFields[i - numFixedSize]);
     }
-    mCache->insert(table, key, tuple);
+    insert(table, key, tuple);
 }
 
 void Transaction::insert(table_t table, key_t key, const Tuple& tuple) {
-    mCache->insert(table, key, tuple);
+    checkWritable();
+    if (mTrace) {
+        mTrace->addTuple(TraceOperation::Insert, tableName(table), key, tuple);
+    }
+    cache().insert(table, key, tuple);
 }
 
 void Transaction::update(table_t table, key_t key, const Tuple& from, const Tuple& to) {
-    mCache->update(table, key, from, to);
+    checkWritable();
+    if (mTrace) {
+        mTrace->addTuple(TraceOperation::Update, tableName(table), key, to);
+    }
+    cache().update(table, key, from, to);
 }
 
 void Transaction::remove(table_t table, key_t key, const Tuple& tuple) {
-    mCache->remove(table, key, tuple);
+    checkWritable();
+    if (mTrace) {
+        mTrace->add(TraceOperation::Remove, tableName(table), key);
+    }
+    cache().remove(table, key, tuple);
 }
 
 std::shared_ptr<store::ScanIterator> Transaction::scan(const ScanQuery& scanQuery, store::ScanMemoryManager& memoryManager) {
@@ -204,34 +278,165 @@ std::shared_ptr<store::ScanIterator> Transaction::scan(const ScanQuery& scanQuer
     }
     const auto& t = mContext.tables.at(scanQuery.table());
     scanQuery.verify(t->record().schema());
+    if (mTrace) {
+        mTrace->add(TraceOperation::Scan, t->tableName(), 0);
+    }
     uint32_t selectionLength, queryLength;
     std::unique_ptr<char[]> selection, query;
     scanQuery.serializeQuery(query, queryLength);
     scanQuery.serializeSelection(selection, selectionLength);
-    return mHandle.scan(*mContext.tables[scanQuery.table()],
+    mContext.metrics->increment(Metric::Scans);
+    mContext.metrics->increment(Metric::ScanRequestBytes, selectionLength + queryLength);
+    // The scan's results are consumed by the caller, only issuing the scan is recorded
+    TimelineRequest request(mTimeline.get(), "scan", t->tableName(), 0, WaitSite::Scan);
+    TELLDB_PROBE2(scan__start, t->tableId(), selectionLength + queryLength);
+    auto nodesBegin = mContext.nodes->begin();
+    auto scan = mHandle.scan(*mContext.tables[scanQuery.table()],
             *mSnapshot,
             memoryManager,
             scanQuery.queryType(),
             selectionLength, selection.get(),
             queryLength, query.get());
+    mContext.nodes->endScan(nodesBegin, selectionLength + queryLength);
+#ifdef TELLDB_HAVE_SDT
+    // The scan ends when the caller releases the iterator
+    auto tableId = t->tableId();
+    auto begin = CycleClock::now();
+    auto iter = scan.get();
+    return std::shared_ptr<store::ScanIterator>(iter, [scan, tableId, begin](store::ScanIterator*) mutable {
+        scan.reset();
+        TELLDB_PROBE2(scan__end, tableId, CycleClock::toDuration(CycleClock::now() - begin).count());
+    });
+#else
+    return scan;
+#endif
 }
 
 void Transaction::commit() {
-    writeBack();
-    mHandle.commit(*mSnapshot);
+    // Checked before the read-only path, releasing the snapshot twice would release a shared snapshot for its sharers
+    if (mCommitted) {
+        throw std::logic_error("Transaction has already committed");
+    }
+    if (mTrace) {
+        // A rollback after a failed commit records the transaction as aborted
+        mTrace->setOutcome(TraceOutcome::Aborted);
+    }
+    auto start = CycleClock::now();
+    if (mCommitTicks == 0) {
+        mCommitTicks = start;
+    }
+    // Read-only transactions can not have changes, they only release their snapshot
+    auto hasChanges = (mCache && mCache->hasChanges());
+    if (hasChanges) {
+        writeBack();
+    }
+    auto begin = CycleClock::now();
+    {
+        TimelineRequest request(mTimeline.get(), "commit", "commitmanager", mSnapshot->version(), WaitSite::Commit);
+        mContext.commitBatcher->commit(mHandle, *mSnapshot);
+    }
+    mProfile.commit = elapsedSince(begin);
     mCommitted = true;
+    TELLDB_PROBE3(transaction__commit, mSnapshot->version(), CycleClock::toDuration(begin - mBeginTicks).count(),
+            mProfile.undoLogSize);
+    if (hasChanges && mContext.clientTable->commitStatsEnabled()) {
+        mContext.commitStats->record(mProfile, CycleClock::toDuration(begin - start));
+    }
+    if (mStats) {
+        mStats->recordAttempt(mStatsType, true, CycleClock::toDuration(start - mBeginTicks),
+                CycleClock::toDuration(begin - start));
+    }
+    accountMemory();
+    if (mTrace) {
+        mTrace->finish(TraceOutcome::Committed);
+        mTrace.reset();
+    }
+    finishTimeline("committed");
 }
 
 void Transaction::rollback() {
     if (mCommitted) {
         throw std::logic_error("Transaction has already committed");
     }
-    mCache->rollback();
-    mHandle.commit(*mSnapshot);
+    // A failed commit counts towards the rollback
+    auto start = (mCommitTicks == 0 ? CycleClock::now() : mCommitTicks);
+    if (mCache && mType == store::TransactionType::READ_WRITE) {
+        mCache->rollback();
+    }
+    {
+        TimelineRequest request(mTimeline.get(), "commit", "commitmanager", mSnapshot->version(), WaitSite::Commit);
+        mContext.commitBatcher->commit(mHandle, *mSnapshot);
+    }
     mCommitted = true;
+    // Once the changes are reverted the undo log is not needed for recovery anymore, so it is removed after the
+    // snapshot was released
+    if (mUndoLogSize != 0) {
+        removeUndoLog(std::make_pair(mUndoLogSize, nullptr));
+        mUndoLogSize = 0;
+    }
+    auto end = CycleClock::now();
+    TELLDB_PROBE2(transaction__abort, mSnapshot->version(), CycleClock::toDuration(end - mBeginTicks).count());
+    if (mStats) {
+        mStats->recordAttempt(mStatsType, false, CycleClock::toDuration(start - mBeginTicks),
+                CycleClock::toDuration(end - start));
+    }
+    accountMemory();
+    if (mTrace) {
+        mTrace->finish(mTrace->outcome());
+        mTrace.reset();
+    }
+    finishTimeline("rolled back");
+}
+
+void Transaction::finishTimeline(const char* outcome) {
+    if (!mTimeline) {
+        return;
+    }
+    if (mContext.clientTable->waitProfilingEnabled()) {
+        mContext.waits->record(mTimeline->waits(), CycleClock::toDuration(CycleClock::now() - mBeginTicks));
+    }
+    mTimeline->finish(outcome);
+}
+
+TransactionWaits Transaction::waits() const {
+    return (mTimeline ? mTimeline->waits() : TransactionWaits());
+}
+
+TransactionMemory Transaction::memoryUsage() const {
+    TransactionMemory memory;
+    if (mCache) {
+        mCache->memoryUsage(memory);
+    }
+    memory.bytes[static_cast<size_t>(MemoryCategory::UndoLog)] = mProfile.undoLogSize;
+    return memory;
+}
+
+void Transaction::accountMemory() {
+    if (!mContext.clientTable->memoryAccountingEnabled()) {
+        return;
+    }
+    // Nothing is freed before the transaction is destroyed, so the memory at the end is the peak
+    auto memory = memoryUsage();
+    auto peak = memory.total();
+    auto threshold = mContext.clientTable->memoryWarningThreshold();
+    auto warn = (threshold != 0 && peak > threshold);
+    if (warn) {
+        std::string categories;
+        for (size_t i = 0; i < gMemoryCategoryCount; ++i) {
+            categories += (i == 0 ? "" : ", ");
+            categories += memoryCategoryName(static_cast<MemoryCategory>(i));
+            categories += ": " + std::to_string(memory.bytes[i]);
+        }
+        LOG_WARN("Transaction %1% used %2% bytes (%3%)", mSnapshot->version(), peak, categories);
+    }
+    mContext.memory->record(memory, contextMemory(mContext), warn);
+    if (mStats) {
+        mStats->recordMemory(mStatsType, peak);
+    }
 }
 
 void Transaction::writeUndoLog(std::pair<size_t, uint8_t*> log) {
+    mContext.metrics->increment(Metric::UndoLogBytes, log.first);
     uint64_t key = mSnapshot->version() & ~(std::numeric_limits<uint64_t>::max() << 48);
     if (log.first > gMaxUndoLogSize) {
         if ((log.first / gMaxUndoLogSize) >= static_cast<decltype(log.first)>(std::numeric_limits<uint16_t>::max())) {
@@ -240,20 +445,31 @@ void Transaction::writeUndoLog(std::pair<size_t, uint8_t*> log) {
         size_t sizeWritten = 0;
         std::vector<std::shared_ptr<tell::store::ModificationResponse>> responses;
         responses.reserve((log.first / gMaxUndoLogSize) + 1);
+        std::vector<uint32_t> spans;
         for (uint64_t chunkNum = 0; sizeWritten < log.first; ++chunkNum) {
+            ++mProfile.undoLogChunks;
+            mContext.metrics->increment(Metric::UndoLogChunks);
             auto chunkKey = (key | (chunkNum << 48));
             auto toWrite = std::min(log.first - sizeWritten, gMaxUndoLogSize);
+            spans.push_back(beginRequest(mTimeline.get(), "undo-log-insert",
+                    mContext.clientTable->txTable().tableName(), chunkKey));
             responses.emplace_back(mHandle.insert(mContext.clientTable->txTable(), chunkKey, 0, {
                         std::make_pair("value", crossbow::string(reinterpret_cast<char*>(log.second) + sizeWritten,
                                 toWrite))
                     }));
             sizeWritten += toWrite;
         }
+        TimelineWait wait(mTimeline.get(), WaitSite::UndoLog);
         for (auto i = responses.rbegin(); i != responses.rend(); ++i) {
             __attribute__((unused)) auto res = (*i)->waitForResult();
             LOG_ASSERT(res, "Writeback did not succeed");
+            endRequest(mTimeline.get(), spans[responses.rend() - i - 1]);
         }
     } else {
+        ++mProfile.undoLogChunks;
+        mContext.metrics->increment(Metric::UndoLogChunks);
+        TimelineRequest request(mTimeline.get(), "undo-log-insert", mContext.clientTable->txTable().tableName(),
+                key, WaitSite::UndoLog);
         auto resp = mHandle.insert(mContext.clientTable->txTable(), key, 0, {
                 std::make_pair("value", crossbow::string(reinterpret_cast<char*>(log.second), log.first))
                 });
@@ -271,17 +487,24 @@ void Transaction::removeUndoLog(std::pair<size_t, uint8_t*> log) {
         size_t sizeWritten = 0;
         std::vector<std::shared_ptr<tell::store::ModificationResponse>> responses;
         responses.reserve((log.first / gMaxUndoLogSize) + 1);
+        std::vector<uint32_t> spans;
         for (uint64_t chunkNum = 0; sizeWritten < log.first; ++chunkNum) {
             auto chunkKey = (key | (chunkNum << 48));
             auto segSize = std::min(log.first - sizeWritten, gMaxUndoLogSize);
+            spans.push_back(beginRequest(mTimeline.get(), "undo-log-remove",
+                    mContext.clientTable->txTable().tableName(), chunkKey));
             responses.emplace_back(mHandle.remove(mContext.clientTable->txTable(), chunkKey, 1));
             sizeWritten += segSize;
         }
+        TimelineWait wait(mTimeline.get(), WaitSite::UndoLog);
         for (auto i = responses.rbegin(); i != responses.rend(); ++i) {
             __attribute__((unused)) auto res = (*i)->waitForResult();
             LOG_ASSERT(res, "Could not delete undo log");
+            endRequest(mTimeline.get(), spans[responses.rend() - i - 1]);
         }
     } else {
+        TimelineRequest request(mTimeline.get(), "undo-log-remove", mContext.clientTable->txTable().tableName(),
+                key, WaitSite::UndoLog);
         auto resp = mHandle.remove(mContext.clientTable->txTable(), key, 1);
         __attribute__((unused)) auto res = resp->waitForResult();
         LOG_ASSERT(res, "Could not delete undo log");
@@ -292,23 +515,56 @@ void Transaction::writeBack(bool withIndexes) {
     if (mCommitted) {
         throw std::logic_error("Transaction has already committed");
     }
-    if (!mCache->hasChanges()) {
+    if (!mCache || !mCache->hasChanges()) {
         return;
     }
-    if (mType != store::TransactionType::READ_WRITE) {
-        throw std::logic_error("Transaction is read only");
+    auto begin = CycleClock::now();
+    std::pair<size_t, uint8_t*> undoLog(0, nullptr);
+    if (mCache->needsUndoLog()) {
+        undoLog = mCache->undoLog(withIndexes);
+        mProfile.undoLog = elapsedSince(begin);
+        mProfile.undoLogSize = undoLog.first;
+        writeUndoLog(undoLog);
+        mUndoLogSize = undoLog.first;
+        mProfile.writeUndoLog = elapsedSince(begin);
+        TELLDB_PROBE4(undolog__write, mSnapshot->version(), undoLog.first, mProfile.undoLogChunks,
+                mProfile.writeUndoLog.count());
+    } else {
+        mContext.metrics->increment(Metric::UndoLogsSkipped);
     }
-    auto undoLog = mCache->undoLog(withIndexes);
-    writeUndoLog(undoLog);
     mCache->writeBack();
+    mProfile.writeBack = elapsedSince(begin);
     if (withIndexes) {
         mCache->writeIndexes();
+        mProfile.writeIndexes = elapsedSince(begin);
+    }
+    if (undoLog.first != 0) {
+        removeUndoLog(undoLog);
+        mUndoLogSize = 0;
+    }
+    mProfile.removeUndoLog = elapsedSince(begin);
+}
+
+TransactionCache& Transaction::cache() {
+    if (!mCache) {
+        mCache.reset(new (&mPool) TransactionCache(mContext, mHandle, *mSnapshot, mPool, mTimeline.get(),
+                mType != store::TransactionType::READ_WRITE));
+    }
+    return *mCache;
+}
+
+void Transaction::checkWritable() const {
+    if (mType != store::TransactionType::READ_WRITE) {
+        throw std::logic_error("Transaction is read only");
     }
-    removeUndoLog(undoLog);
 }
 
 const store::Record& Transaction::getRecord(table_t table) const {
-    return mCache->record(table);
+    return mContext.tables.at(table)->record();
+}
+
+const crossbow::string& Transaction::tableName(table_t table) const {
+    return mContext.tables.at(table)->tableName();
 }
 
 } // namespace db
@@ -34,7 +34,6 @@ using namespace tell::store;
 namespace tell {
 namespace db {
 using namespace impl;
-
 Future<table_t>::Future(std::shared_ptr<GetTableResponse>&& resp, TransactionCache& cache)
     : resp(resp)
     , cache(cache)
@@ -66,21 +65,33 @@ table_t Future<table_t>::get() {
 }
 
 Iterator TransactionCache::lower_bound(table_t tableId, const crossbow::string& idxName, const KeyType& key) {
-    return mTables[tableId]->lower_bound(idxName, key);
+    return indexedTable(tableId)->lower_bound(idxName, key);
 }
 
 Iterator TransactionCache::reverse_lower_bound(table_t tableId, const crossbow::string& idxName, const KeyType& key) {
-    return mTables[tableId]->reverse_lower_bound(idxName, key);
+    return indexedTable(tableId)->reverse_lower_bound(idxName, key);
+}
+
+TableCache* TransactionCache::indexedTable(table_t tableId) {
+    auto cache = mTables[tableId];
+    if (!cache->indexesOpened()) {
+        cache->setIndexes(context.indexes->openIndexes(mSnapshot, mHandle, cache->table(), mTimeline));
+    }
+    return cache;
 }
 
 TransactionCache::TransactionCache(TellDBContext& context,
         store::ClientHandle& handle,
         const commitmanager::SnapshotDescriptor& snapshot,
-        crossbow::ChunkMemoryPool& pool)
+        crossbow::ChunkMemoryPool& pool,
+        impl::TransactionTimeline* timeline,
+        bool readOnly)
     : context(context)
     , mHandle(handle)
     , mSnapshot(snapshot)
     , mPool(pool)
+    , mTimeline(timeline)
+    , mReadOnly(readOnly)
     , mTables(&pool)
 {}
 
@@ -92,7 +103,7 @@ Future<table_t> TransactionCache::openTable(const crossbow::string& name) {
         res.result.value = tableId.value;
         if (mTables.find(tableId) == mTables.end()) {
             const auto& t = *context.tables[res.result];
-            addTable(t, context.indexes->openIndexes(mSnapshot, mHandle, t));
+            addTable(t, openIndexes(t));
         }
         return res;
     }
@@ -110,7 +121,11 @@ table_t TransactionCache::createTable(const crossbow::string& name, const store:
                 mHandle,
                 mSnapshot,
                 mPool,
-                context.indexes->createIndexes(mSnapshot, mHandle, table)));
+                *context.metrics,
+                *context.conflictProfiler,
+                *context.nodes,
+                mTimeline,
+                context.indexes->createIndexes(mSnapshot, mHandle, table, mTimeline)));
     return tableId;
 }
 
@@ -141,12 +156,13 @@ table_t TransactionCache::addTable(const tell::store::Table& table,
         std::unordered_map<crossbow::string,
         impl::IndexWrapper>&& indexes) {
     table_t id { table.tableId() };
-    mTables.emplace(id, new (&mPool) TableCache(table, mHandle, mSnapshot, mPool, std::move(indexes)));
+    mTables.emplace(id, new (&mPool) TableCache(table, mHandle, mSnapshot, mPool, *context.metrics,
+                *context.conflictProfiler, *context.nodes, mTimeline, std::move(indexes), !mReadOnly));
     return id;
 }
 
 table_t TransactionCache::addTable(tell::store::Table table) {
-    auto indexes = context.indexes->openIndexes(mSnapshot, mHandle, table);
+    auto indexes = openIndexes(table);
     table_t res{table.tableId()};
     Table* t = nullptr;
     auto iter = context.tables.find(res);
@@ -160,9 +176,25 @@ table_t TransactionCache::addTable(tell::store::Table table) {
     return addTable(*t, std::move(indexes));
 }
 
+std::unordered_map<crossbow::string, IndexWrapper> TransactionCache::openIndexes(const tell::store::Table& table) {
+    if (mReadOnly) {
+        // Opened by the first range query on the table
+        return {};
+    }
+    return context.indexes->openIndexes(mSnapshot, mHandle, table, mTimeline);
+}
+
 void TransactionCache::rollback() {
+    // Issue the reverts of all tables first so they are processed by the storage nodes in parallel, the index entries
+    // are undone while the reverts are in flight
     for (auto p : mTables) {
-        p.second->rollback();
+        p.second->startRollback();
+    }
+    for (auto p : mTables) {
+        p.second->undoIndexes();
+    }
+    for (auto p : mTables) {
+        p.second->finishRollback();
     }
 }
 
@@ -180,22 +212,30 @@ void TransactionCache::writeIndexes() {
 
 bool TransactionCache::hasChanges() const {
     for (const auto& t : mTables) {
-        if (t.second->changes().size() != 0) {
+        if (t.second->hasChanges()) {
             return true;
         }
     }
     return false;
 }
 
+void TransactionCache::memoryUsage(TransactionMemory& memory) const {
+    for (const auto& t : mTables) {
+        t.second->memoryUsage(memory);
+    }
+}
+
 template<class A>
 void TransactionCache::applyForLog(A& ar, bool withIndexes) const {
     for (const auto& t : mTables) {
         ar & t.first;
-        const auto& cs = t.second->changes();
-        uint32_t numChanges = cs.size();
+        auto cs = t.second->changes();
+        uint32_t numChanges = (cs ? cs->size() : 0);
         ar & numChanges;
-        for (const auto& c : cs) {
-            ar & c.first;
+        if (cs) {
+            for (const auto& c : *cs) {
+                ar & c.first;
+            }
         }
         if (withIndexes) {
             const auto& indexes = t.second->indexes();
@@ -218,6 +258,27 @@ std::pair<size_t, uint8_t*> TransactionCache::undoLog(bool withIndexes) const {
     return std::make_pair(s.size, res);
 }
 
+bool TransactionCache::needsUndoLog() const {
+    if (!context.clientTable->undoLogSkippingEnabled()) {
+        return true;
+    }
+    // The undo log is the only record recovery reads to revert the writes of a client crashing before its commit.
+    // Without it the row of such a client stays in the storage under a version that never commits and is never
+    // reverted, so every later write to the key conflicts with it for good.
+    size_t rows = 0;
+    for (const auto& t : mTables) {
+        if (!t.second->hasChanges()) {
+            continue;
+        }
+        // Index updates are further writes, even if they are written back separately
+        if (!t.second->indexes().empty()) {
+            return true;
+        }
+        rows += t.second->changes()->size();
+    }
+    return rows > 1;
+}
+
 const store::Record& TransactionCache::record(table_t table) const {
     return mTables.at(table)->table().record();
 }
@@ -34,6 +34,7 @@ namespace tell {
 namespace db {
 namespace impl {
 struct TellDBContext;
+class TransactionTimeline;
 } // namespace impl
 
 class TableCache;
@@ -44,12 +45,17 @@ class TransactionCache : public crossbow::ChunkObject {
     store::ClientHandle& mHandle;
     const commitmanager::SnapshotDescriptor& mSnapshot;
     crossbow::ChunkMemoryPool& mPool;
+    impl::TransactionTimeline* mTimeline;
+    // read-only transactions never write, so they only open the indexes of a table used by a range query
+    bool mReadOnly;
     ChunkUnorderedMap<table_t, TableCache*> mTables;
 public:
     TransactionCache(impl::TellDBContext& context,
             store::ClientHandle& handle,
             const commitmanager::SnapshotDescriptor& snapshot,
-            crossbow::ChunkMemoryPool& pool);
+            crossbow::ChunkMemoryPool& pool,
+            impl::TransactionTimeline* timeline,
+            bool readOnly);
     ~TransactionCache();
 public: // Schema operations
     Future<table_t> openTable(const crossbow::string& name);
@@ -63,17 +69,27 @@ public: // Get/Put
     void remove(table_t table, key_t key, const Tuple& tuple);
 public:
     std::pair<size_t, uint8_t*> undoLog(bool withIndexes = true) const;
+    /**
+     * @brief Whether writing back the changes needs an undo log
+     *
+     * A single storage write is atomic, so a write set of exactly one row in a table without indexes can not be left
+     * half written. Such write sets skip the log only if enabled with ClientManager::enableUndoLogSkipping.
+     */
+    bool needsUndoLog() const;
     void writeBack();
     void writeIndexes();
     void rollback();
 public: // Helpers
     const store::Record& record(table_t table) const;
     bool hasChanges() const;
+    void memoryUsage(TransactionMemory& memory) const;
     template<class A>
     void applyForLog(A& ar, bool withIndexes) const;
 private:
     table_t addTable(const tell::store::Table& table, std::unordered_map<crossbow::string, impl::IndexWrapper>&& indexes);
     table_t addTable(tell::store::Table table);
+    std::unordered_map<crossbow::string, impl::IndexWrapper> openIndexes(const tell::store::Table& table);
+    TableCache* indexedTable(table_t tableId);
 };
 
 } // namespace db
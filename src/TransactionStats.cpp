@@ -0,0 +1,120 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "TransactionStats.hpp"
+
+#include <algorithm>
+
+namespace tell {
+namespace db {
+
+void TransactionTypeStats::merge(const TransactionTypeStats& other) {
+    latency.merge(other.latency);
+    execution.merge(other.execution);
+    commit.merge(other.commit);
+    retries.merge(other.retries);
+    memory.merge(other.memory);
+    committed += other.committed;
+    aborted += other.aborted;
+}
+
+double TransactionStats::throughput(const crossbow::string& name) const {
+    auto i = types.find(name);
+    auto seconds = std::chrono::duration<double>(elapsed).count();
+    if (i == types.end() || seconds == 0.0) {
+        return 0.0;
+    }
+    return double(i->second.committed) / seconds;
+}
+
+namespace impl {
+namespace {
+
+uint64_t nanos(CommitProfile::Duration duration) {
+    return static_cast<uint64_t>(std::max(duration.count(), CommitProfile::Duration::rep(0)));
+}
+
+} // anonymous namespace
+
+constexpr size_t TransactionStatsRecorder::TYPE_SLOTS;
+
+TransactionStatsRecorder::TypeRecorder::TypeRecorder()
+    : committed(0)
+    , aborted(0)
+{}
+
+TransactionStatsRecorder::TransactionStatsRecorder() {
+    for (auto& type : mTypes) {
+        type.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+TransactionStatsRecorder::~TransactionStatsRecorder() {
+    for (auto& type : mTypes) {
+        delete type.load(std::memory_order_relaxed);
+    }
+}
+
+auto TransactionStatsRecorder::typeRecorder(uint32_t type) -> TypeRecorder& {
+    auto& slot = mTypes[std::min(static_cast<size_t>(type), TYPE_SLOTS - 1)];
+    auto recorder = slot.load(std::memory_order_relaxed);
+    if (recorder == nullptr) {
+        recorder = new TypeRecorder();
+        slot.store(recorder, std::memory_order_release);
+    }
+    return *recorder;
+}
+
+void TransactionStatsRecorder::recordAttempt(uint32_t type, bool committed, CommitProfile::Duration execution,
+        CommitProfile::Duration commit) {
+    auto& recorder = typeRecorder(type);
+    recorder.execution.record(nanos(execution));
+    recorder.commit.record(nanos(commit));
+    HistogramRecorder::increment(committed ? recorder.committed : recorder.aborted, 1);
+}
+
+void TransactionStatsRecorder::recordTransaction(uint32_t type, CommitProfile::Duration latency, uint32_t retries) {
+    auto& recorder = typeRecorder(type);
+    recorder.latency.record(nanos(latency));
+    recorder.retries.record(retries);
+}
+
+void TransactionStatsRecorder::snapshot(const std::vector<crossbow::string>& names, TransactionStats& stats) const {
+    for (size_t i = 0; i < TYPE_SLOTS; ++i) {
+        auto recorder = mTypes[i].load(std::memory_order_acquire);
+        if (recorder == nullptr) {
+            continue;
+        }
+        auto& type = stats.types[i < names.size() ? names[i] : crossbow::string("<other>")];
+        recorder->latency.snapshot(type.latency);
+        recorder->execution.snapshot(type.execution);
+        recorder->commit.snapshot(type.commit);
+        recorder->retries.snapshot(type.retries);
+        recorder->memory.snapshot(type.memory);
+        type.committed += recorder->committed.load(std::memory_order_relaxed);
+        type.aborted += recorder->aborted.load(std::memory_order_relaxed);
+    }
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -0,0 +1,98 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "CommitStats.hpp"
+
+#include <telldb/TransactionStats.hpp>
+#include <telldb/Transaction.hpp>
+
+#include <crossbow/string.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace tell {
+namespace db {
+namespace impl {
+
+/**
+ * @brief Statistics of the named transactions run by a single thread
+ *
+ * The statistics of a transaction type are allocated when the thread runs the first transaction of this type. Types
+ * are identified by the index the client table assigned to their name.
+ */
+class TransactionStatsRecorder {
+public:
+    /// Number of transaction types recorded individually, the last slot collects all other types
+    static constexpr size_t TYPE_SLOTS = 64;
+
+    TransactionStatsRecorder();
+
+    ~TransactionStatsRecorder();
+
+    /**
+     * @brief Records a single attempt of a transaction that committed or rolled back
+     */
+    void recordAttempt(uint32_t type, bool committed, CommitProfile::Duration execution,
+            CommitProfile::Duration commit);
+
+    /**
+     * @brief Records a transaction after its last attempt
+     */
+    void recordTransaction(uint32_t type, CommitProfile::Duration latency, uint32_t retries);
+
+    void recordMemory(uint32_t type, size_t bytes) {
+        typeRecorder(type).memory.record(bytes);
+    }
+
+    /**
+     * @brief Adds the current state to the given stats
+     *
+     * @param names The names of the types by index
+     */
+    void snapshot(const std::vector<crossbow::string>& names, TransactionStats& stats) const;
+
+private:
+    struct TypeRecorder {
+        TypeRecorder();
+
+        HistogramRecorder latency;
+        HistogramRecorder execution;
+        HistogramRecorder commit;
+        HistogramRecorder retries;
+        HistogramRecorder memory;
+        std::atomic<uint64_t> committed;
+        std::atomic<uint64_t> aborted;
+    };
+
+    TypeRecorder& typeRecorder(uint32_t type);
+
+    /// Published by the owning thread after the recorder was initialized
+    std::array<std::atomic<TypeRecorder*>, TYPE_SLOTS> mTypes;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
@@ -60,7 +60,7 @@ Field deserialize(const char* data, tell::store::FieldType type, const char* fie
         auto offsetData = reinterpret_cast<const uint32_t*>(field);
         auto offset = offsetData[0];
         auto length = offsetData[1] - offset;
-        return crossbow::string(data + offset, length);
+        return Field(type, data + offset, length);
     }
     case FieldType::NOTYPE:
         LOG_ASSERT(false, "One should never use a field of type NOTYPE");
@@ -107,8 +107,7 @@ size_t Tuple::size() const {
     const auto& schema = mRecord.schema();
     for (decltype(mFields.size()) i = schema.fixedSizeFields().size(); i < mFields.size(); ++i) {
         if (mFields[i].type() != store::FieldType::NULLTYPE) {
-            const auto& v = mFields[i].value<crossbow::string>();
-            result += v.size();
+            result += mFields[i].stringSize();
         }
     }
     return crossbow::align(result, 8u);
@@ -185,9 +184,8 @@ void Tuple::serialize(char* dest) const {
                         "Pointer to field must be aligned");
                 *reinterpret_cast<uint32_t*>(current) = varHeapOffset;
 
-                auto& data = value.value<crossbow::string>();
-                memcpy(dest + varHeapOffset, data.c_str(), data.size());
-                varHeapOffset += data.size();
+                memcpy(dest + varHeapOffset, value.stringData(), value.stringSize());
+                varHeapOffset += value.stringSize();
             } break;
 
             default: {
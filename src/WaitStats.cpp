@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "WaitStats.hpp"
+
+#include <algorithm>
+
+namespace tell {
+namespace db {
+
+const char* waitSiteName(WaitSite site) {
+    switch (site) {
+    case WaitSite::Get:
+        return "get";
+    case WaitSite::Counter:
+        return "counter";
+    case WaitSite::CounterRefill:
+        return "counter-refill";
+    case WaitSite::IndexRead:
+        return "index-read";
+    case WaitSite::IndexWrite:
+        return "index-write";
+    case WaitSite::WriteBack:
+        return "write-back";
+    case WaitSite::Revert:
+        return "revert";
+    case WaitSite::UndoLog:
+        return "undo-log";
+    case WaitSite::Commit:
+        return "commit";
+    case WaitSite::Scan:
+        return "scan";
+    }
+    return "unknown";
+}
+
+uint64_t TransactionWaits::waits() const {
+    uint64_t result = 0;
+    for (auto& site : sites) {
+        result += site.waits;
+    }
+    return result;
+}
+
+auto TransactionWaits::total() const -> Duration {
+    auto result = Duration::zero();
+    for (auto& site : sites) {
+        result += site.total;
+    }
+    return result;
+}
+
+auto TransactionWaits::longest() const -> Duration {
+    auto result = Duration::zero();
+    for (auto& site : sites) {
+        result = std::max(result, site.longest);
+    }
+    return result;
+}
+
+namespace impl {
+namespace {
+
+uint64_t nanos(TransactionWaits::Duration duration) {
+    return static_cast<uint64_t>(std::max(duration.count(), TransactionWaits::Duration::rep(0)));
+}
+
+} // anonymous namespace
+
+WaitRecorder::WaitRecorder() {
+    for (auto& longest : mLongest) {
+        longest.store(0, std::memory_order_relaxed);
+    }
+}
+
+void WaitRecorder::record(WaitSite site, TransactionWaits::Duration duration) {
+    auto i = static_cast<size_t>(site);
+    auto value = nanos(duration);
+    mSites[i].record(value);
+    if (value > mLongest[i].load(std::memory_order_relaxed)) {
+        mLongest[i].store(value, std::memory_order_relaxed);
+    }
+}
+
+void WaitRecorder::record(const TransactionWaits& waits, TransactionWaits::Duration lifetime) {
+    auto blocked = waits.total();
+    mBlocked.record(nanos(blocked));
+    mRunnable.record(nanos(lifetime - blocked));
+    mWaits.record(waits.waits());
+    mLongestWait.record(nanos(waits.longest()));
+}
+
+void WaitRecorder::snapshot(WaitStats& stats) const {
+    for (size_t i = 0; i < gWaitSiteCount; ++i) {
+        mSites[i].snapshot(stats.sites[i]);
+        stats.longest[i] = std::max(stats.longest[i], mLongest[i].load(std::memory_order_relaxed));
+    }
+    mBlocked.snapshot(stats.blocked);
+    mRunnable.snapshot(stats.runnable);
+    mWaits.snapshot(stats.waits);
+    mLongestWait.snapshot(stats.longestWait);
+}
+
+} // namespace impl
+} // namespace db
+} // namespace tell
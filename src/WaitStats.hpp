@@ -0,0 +1,74 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "CommitStats.hpp"
+
+#include <telldb/WaitStats.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace tell {
+namespace db {
+namespace impl {
+
+/**
+ * @brief Waits of the transactions of a single thread
+ *
+ * Only the owning thread records, so plain loads and stores suffice. The counters are atomic so that snapshots can be
+ * taken from any thread at any time without locking.
+ */
+class WaitRecorder {
+public:
+    WaitRecorder();
+
+    /**
+     * @brief Records a single wait when it ends
+     */
+    void record(WaitSite site, TransactionWaits::Duration duration);
+
+    /**
+     * @brief Records the waits of a transaction when it finishes
+     *
+     * @param lifetime Time from the start of the transaction until it finished
+     */
+    void record(const TransactionWaits& waits, TransactionWaits::Duration lifetime);
+
+    /**
+     * @brief Adds the current state to the given stats
+     */
+    void snapshot(WaitStats& stats) const;
+
+private:
+    std::array<HistogramRecorder, gWaitSiteCount> mSites;
+    std::array<std::atomic<uint64_t>, gWaitSiteCount> mLongest;
+    HistogramRecorder mBlocked;
+    HistogramRecorder mRunnable;
+    HistogramRecorder mWaits;
+    HistogramRecorder mLongestWait;
+};
+
+} // namespace impl
+} // namespace db
+} // namespace tell
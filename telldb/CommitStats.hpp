@@ -0,0 +1,77 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include "LatencyHistogram.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tell {
+namespace db {
+
+/**
+ * @brief Phases of Transaction::commit
+ */
+enum class CommitPhase : uint8_t {
+    UndoLog = 0,
+    WriteUndoLog,
+    WriteBack,
+    WriteIndexes,
+    RemoveUndoLog,
+    Commit,
+    /// The whole commit including all phases
+    Total,
+};
+
+constexpr size_t gCommitPhaseCount = static_cast<size_t>(CommitPhase::Total) + 1;
+
+const char* commitPhaseName(CommitPhase phase);
+
+/**
+ * @brief Commit latencies of all threads of a ClientManager
+ *
+ * Only transactions committing changes are recorded, read-only commits and rollbacks are not.
+ */
+struct CommitStats {
+    /**
+     * @brief Histogram of the given phase
+     */
+    const LatencyHistogram& phase(CommitPhase phase) const {
+        return phases[static_cast<size_t>(phase)];
+    }
+
+    void merge(const CommitStats& other);
+
+    std::array<LatencyHistogram, gCommitPhaseCount> phases;
+
+    /// Total size of all undo logs written
+    uint64_t undoLogSize = 0;
+
+    /// Total number of tuples all undo logs were split into
+    uint64_t undoLogChunks = 0;
+};
+
+} // namespace db
+} // namespace tell
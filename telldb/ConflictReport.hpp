@@ -0,0 +1,91 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/string.hpp>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace tell {
+namespace db {
+
+/**
+ * @brief A tuple or index entry that caused conflicts
+ */
+struct ContendedKey {
+    crossbow::string table;
+
+    /// Name of the index for conflicts on index entries, empty for conflicts on tuples
+    crossbow::string index;
+
+    /// Key of the tuple or the fields of the index entry
+    crossbow::string key;
+
+    /// Estimated number of conflicts, overestimated by at most error
+    uint64_t conflicts = 0;
+
+    uint64_t error = 0;
+};
+
+/**
+ * @brief Conflicts on a single table
+ */
+struct TableConflicts {
+    /**
+     * @brief Conflicts per tuple written
+     */
+    double rate() const {
+        return (writes == 0 ? 0.0 : double(conflicts) / double(writes));
+    }
+
+    /// Tuples written back to the storage
+    uint64_t writes = 0;
+
+    /// Conflicts on the table's tuples and index entries
+    uint64_t conflicts = 0;
+};
+
+/**
+ * @brief The most contended keys of all threads of a ClientManager
+ *
+ * Every thread tracks the keys it saw conflicts on in a space-saving sketch of bounded size, so the counts of rarely
+ * contended keys are estimates. The counts of the most contended keys are exact as long as each thread sees fewer
+ * distinct conflicting keys than the sketch holds.
+ */
+struct ConflictReport {
+    /**
+     * @brief Text report with the conflict rate of every table followed by the most contended keys
+     */
+    crossbow::string toString() const;
+
+    /// Most contended keys first
+    std::vector<ContendedKey> keys;
+
+    /// Conflicts by table name
+    std::map<crossbow::string, TableConflicts> tables;
+};
+
+} // namespace db
+} // namespace tell
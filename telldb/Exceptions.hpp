@@ -123,9 +123,16 @@ public:
 
 class IndexConflict : public KeyException {
     crossbow::string idxName;
+    std::vector<Field> mIndexKey;
 public:
     IndexConflict(key_t key, const crossbow::string& idxName);
+    IndexConflict(key_t key, const crossbow::string& idxName, std::vector<Field> indexKey);
     ~IndexConflict();
+    const crossbow::string& indexName() const noexcept;
+    /**
+     * @brief The fields of the conflicting index entry (empty if not known)
+     */
+    const std::vector<Field>& indexKey() const noexcept;
 };
 
 class UniqueViolation : public Exception {
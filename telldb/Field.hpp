@@ -25,6 +25,9 @@
 
 #include <crossbow/string.hpp>
 #include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
 
 namespace tell {
 namespace db {
@@ -41,112 +44,114 @@ namespace db {
  * between two types of integers will fail. To do these kind of
  * operations the user has to cast them to the correct type explicitely.
  * Field provides a function to cast values to other types.
+ *
+ * A field takes 16 bytes. TEXT and BLOB values of up to INLINE_SIZE bytes
+ * are stored within the field, only longer values are allocated on the heap.
  */
 class Field {
     friend class Tuple;
-    store::FieldType mType;
-    union {
-        crossbow::string str;
-        int16_t smallint;
-        int32_t normalint;
-        int64_t bigint;
-        float floatNr;
-        double doubleNr;
-    };
 public:
-    Field() : mType(store::FieldType::NULLTYPE) {}
-    Field(int16_t value)
-        : mType(store::FieldType::SMALLINT)
-        , smallint(value)
+    /**
+     * @brief Maximum length of a TEXT or BLOB value stored without allocation
+     */
+    static constexpr size_t INLINE_SIZE = 14;
+private:
+    // Value of mInlineSize for strings allocated on the heap
+    static constexpr uint8_t OUT_OF_LINE = 0xFF;
+    // Holds the number, the inline string or the pointer and length of a heap allocated string
+    alignas(8) char mData[INLINE_SIZE];
+    uint8_t mInlineSize;
+    uint8_t mType;
+public:
+    Field()
+        : mInlineSize(0)
+        , mType(uint8_t(store::FieldType::NULLTYPE))
     {}
+    Field(int16_t value)
+        : mInlineSize(0)
+        , mType(uint8_t(store::FieldType::SMALLINT))
+    {
+        new (mData) int16_t(value);
+    }
     Field(int32_t value)
-        : mType(store::FieldType::INT)
-        , normalint(value)
-    {}
+        : mInlineSize(0)
+        , mType(uint8_t(store::FieldType::INT))
+    {
+        new (mData) int32_t(value);
+    }
     Field(int64_t value)
-        : mType(store::FieldType::BIGINT)
-        , bigint(value)
-    {}
+        : mInlineSize(0)
+        , mType(uint8_t(store::FieldType::BIGINT))
+    {
+        new (mData) int64_t(value);
+    }
     Field(float value)
-        : mType(store::FieldType::FLOAT)
-        , floatNr(value)
-    {}
+        : mInlineSize(0)
+        , mType(uint8_t(store::FieldType::FLOAT))
+    {
+        new (mData) float(value);
+    }
     Field(double value)
-        : mType(store::FieldType::DOUBLE)
-        , doubleNr(value)
-    {}
+        : mInlineSize(0)
+        , mType(uint8_t(store::FieldType::DOUBLE))
+    {
+        new (mData) double(value);
+    }
     Field(const crossbow::string& value)
-        : mType(store::FieldType::TEXT)
+        : Field(store::FieldType::TEXT, value.data(), value.size())
+    {}
+    /**
+     * @brief Creates a TEXT or BLOB field holding a copy of the given bytes
+     */
+    Field(store::FieldType type, const char* data, size_t size)
+        : mType(uint8_t(type))
     {
-        new (&str) crossbow::string(value);
+        initString(data, size);
     }
     Field(std::nullptr_t)
-        : mType(store::FieldType::NULLTYPE)
+        : mInlineSize(0)
+        , mType(uint8_t(store::FieldType::NULLTYPE))
     {}
     Field(const Field& other)
         : mType(other.mType)
     {
-        switch (mType) {
-        case store::FieldType::NULLTYPE:
-        case store::FieldType::NOTYPE:
-            return;
-        case store::FieldType::TEXT:
-        case store::FieldType::BLOB:
-            new (&str) crossbow::string(other.str);
-            return;
-        case store::FieldType::SMALLINT:
-            smallint = other.smallint;
-            return;
-        case store::FieldType::INT:
-            normalint = other.normalint;
-            return;
-        case store::FieldType::BIGINT:
-            bigint = other.bigint;
-            return;
-        case store::FieldType::FLOAT:
-            floatNr = other.floatNr;
-            return;
-        case store::FieldType::DOUBLE:
-            doubleNr = other.doubleNr;
+        if (other.mInlineSize == OUT_OF_LINE) {
+            initString(other.longData(), other.longSize());
+        } else {
+            memcpy(mData, other.mData, INLINE_SIZE);
+            mInlineSize = other.mInlineSize;
         }
     }
+    Field(Field&& other) noexcept
+        : mInlineSize(other.mInlineSize)
+        , mType(other.mType)
+    {
+        memcpy(mData, other.mData, INLINE_SIZE);
+        other.mInlineSize = 0;
+        other.mType = uint8_t(store::FieldType::NULLTYPE);
+    }
     ~Field() {
-        if (mType == store::FieldType::TEXT || mType == store::FieldType::BLOB) {
-            str.~basic_string();
+        if (mInlineSize == OUT_OF_LINE) {
+            delete[] longData();
         }
     }
-    
+
     Field& operator= (const Field& other) {
-        if (mType == tell::store::FieldType::TEXT || mType == tell::store::FieldType::BLOB) {
-            if (other.mType == mType) {
-                str = other.str;
-                return *this;
-            }
-            str.~basic_string();
+        if (this != &other) {
+            *this = Field(other);
         }
-        mType = other.mType;
-        switch (mType) {
-        case store::FieldType::NULLTYPE:
-        case store::FieldType::NOTYPE:
-            break;
-        case store::FieldType::TEXT:
-        case store::FieldType::BLOB:
-            new (&str) crossbow::string(other.str);
-            break;
-        case store::FieldType::SMALLINT:
-            smallint = other.smallint;
-            break;
-        case store::FieldType::INT:
-            normalint = other.normalint;
-            break;
-        case store::FieldType::BIGINT:
-            bigint = other.bigint;
-            break;
-        case store::FieldType::FLOAT:
-            floatNr = other.floatNr;
-            break;
-        case store::FieldType::DOUBLE:
-            doubleNr = other.doubleNr;
+        return *this;
+    }
+    Field& operator= (Field&& other) noexcept {
+        if (this != &other) {
+            if (mInlineSize == OUT_OF_LINE) {
+                delete[] longData();
+            }
+            memcpy(mData, other.mData, INLINE_SIZE);
+            mInlineSize = other.mInlineSize;
+            mType = other.mType;
+            other.mInlineSize = 0;
+            other.mType = uint8_t(store::FieldType::NULLTYPE);
         }
         return *this;
     }
@@ -166,50 +171,101 @@ public:
      * @brief Checks whether the field is NULL
      */
     bool null() const {
-        return mType == store::FieldType::NULLTYPE;
+        return mType == uint8_t(store::FieldType::NULLTYPE);
     }
     /**
      * @brief Get the type of this field.
      */
     store::FieldType type() const {
-        return mType;
+        return store::FieldType(mType);
+    }
+    /**
+     * @brief The bytes of a TEXT or BLOB field
+     *
+     * Does not copy the value, in contrast to value<crossbow::string>(). The pointer is valid as long as the field is
+     * not modified.
+     */
+    const char* stringData() const {
+        return (mInlineSize == OUT_OF_LINE ? longData() : mData);
+    }
+    /**
+     * @brief The length of a TEXT or BLOB field in bytes
+     */
+    size_t stringSize() const {
+        return (mInlineSize == OUT_OF_LINE ? longSize() : mInlineSize);
+    }
+    /**
+     * @brief Replaces the value of a TEXT or BLOB field, the type stays the same
+     *
+     * @throws std::invalid_argument if the field is not a TEXT or BLOB field
+     */
+    void setString(const char* data, size_t size);
+    void setString(const crossbow::string& value) {
+        setString(value.data(), value.size());
     }
     template<class T>
     typename std::enable_if<std::is_same<T, int16_t>::value, int16_t&>::type
     value() {
-        return smallint;
+        return *reinterpret_cast<int16_t*>(mData);
     }
     template<class T>
     typename std::enable_if<std::is_same<T, int32_t>::value, int32_t&>::type
     value() {
-        return normalint;
+        return *reinterpret_cast<int32_t*>(mData);
     }
     template<class T>
     typename std::enable_if<std::is_same<T, int64_t>::value, int64_t&>::type
     value() {
-        return bigint;
+        return *reinterpret_cast<int64_t*>(mData);
     }
     template<class T>
     typename std::enable_if<std::is_same<T, float>::value, float&>::type
     value() {
-        return floatNr;
+        return *reinterpret_cast<float*>(mData);
     }
     template<class T>
     typename std::enable_if<std::is_same<T, double>::value, double&>::type
     value() {
-        return doubleNr;
+        return *reinterpret_cast<double*>(mData);
     }
+    /**
+     * @brief Copies a TEXT or BLOB value into a string
+     *
+     * Strings are not stored as crossbow::string, so they are returned as a const copy and can not be modified through
+     * it - use setString() instead. Use stringData() and stringSize() to access them without a copy.
+     */
     template<class T>
-    typename std::enable_if<std::is_same<T, crossbow::string>::value, crossbow::string&>::type
-    value() {
-        return str;
+    typename std::enable_if<std::is_same<T, crossbow::string>::value, const crossbow::string>::type
+    value() const {
+        return crossbow::string(stringData(), stringSize());
     }
     template<class T>
-    const T& value() const {
+    typename std::enable_if<!std::is_same<T, crossbow::string>::value, const T&>::type
+    value() const {
         return const_cast<Field*>(this)->value<T>();
     }
+private:
+    void initString(const char* data, size_t size) {
+        if (size <= INLINE_SIZE) {
+            memcpy(mData, data, size);
+            mInlineSize = uint8_t(size);
+        } else {
+            auto longStr = new char[size];
+            memcpy(longStr, data, size);
+            new (mData) char*(longStr);
+            new (mData + sizeof(char*)) uint32_t(uint32_t(size));
+            mInlineSize = OUT_OF_LINE;
+        }
+    }
+    char* longData() const {
+        return *reinterpret_cast<char* const*>(mData);
+    }
+    uint32_t longSize() const {
+        return *reinterpret_cast<const uint32_t*>(mData + sizeof(char*));
+    }
 };
 
+static_assert(sizeof(Field) == 16, "Field is not 16 bytes");
+
 } // namespace db
 } // namespace tell
-
@@ -24,6 +24,9 @@
 #include "Types.hpp"
 #include "Field.hpp"
 
+#include <memory>
+#include <vector>
+
 namespace tell {
 namespace db {
 
@@ -42,7 +45,10 @@ enum class IteratorDirection {
  * @brief Iterator class used for range queries.
  */
 class Iterator {
+    friend class Transaction;
     std::unique_ptr<impl::IteratorImpl> mImpl;
+    // Number of entries read, shared with the trace of the transaction (nullptr if not traced)
+    std::shared_ptr<uint64_t> mTraceCount;
 public:
     Iterator(std::unique_ptr<impl::IteratorImpl> impl);
     Iterator(Iterator&&);
@@ -0,0 +1,118 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tell {
+namespace db {
+
+/**
+ * @brief Histogram of latencies in nanoseconds
+ *
+ * Buckets grow exponentially and are split into 16 linear sub-buckets, so percentiles have a relative error of less
+ * than 1/16 independent of the number of samples. Recording takes constant time and memory does not grow with the
+ * number of samples.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+
+    static size_t indexOf(uint64_t value);
+
+    /**
+     * @brief Smallest value that falls into the bucket
+     */
+    static uint64_t lowestEquivalent(size_t index);
+
+    /**
+     * @brief Largest value that falls into the bucket
+     */
+    static uint64_t highestEquivalent(size_t index);
+
+    LatencyHistogram();
+
+    void record(uint64_t value);
+
+    /**
+     * @brief Records a value and fills in the samples a closed-loop measurement would have missed
+     *
+     * If the value is larger than the expected interval between two samples, additional values decreasing by the
+     * interval are recorded (coordinated omission correction as in HdrHistogram). Not needed if the latency is already
+     * measured from the intended start time.
+     */
+    void recordCorrected(uint64_t value, uint64_t expectedInterval);
+
+    /**
+     * @brief Adds the given number of values to the bucket
+     *
+     * Used to build a histogram from separately collected buckets, the sum of the values has to be added with addSum.
+     */
+    void add(size_t index, uint64_t count);
+
+    void addSum(uint64_t sum);
+
+    void merge(const LatencyHistogram& other);
+
+    void reset();
+
+    uint64_t count() const {
+        return mCount;
+    }
+
+    /**
+     * @brief Smallest value recorded (the lower bound of its bucket if it was added with add)
+     */
+    uint64_t min() const {
+        return (mCount == 0 ? 0 : mMin);
+    }
+
+    /**
+     * @brief Largest value recorded (the upper bound of its bucket if it was added with add)
+     */
+    uint64_t max() const {
+        return mMax;
+    }
+
+    double mean() const;
+
+    /**
+     * @brief Value at the given percentile (between 0 and 100)
+     */
+    uint64_t percentile(double p) const;
+
+private:
+    std::vector<uint64_t> mBuckets;
+    uint64_t mCount;
+    uint64_t mSum;
+    uint64_t mMin;
+    uint64_t mMax;
+};
+
+} // namespace db
+} // namespace tell
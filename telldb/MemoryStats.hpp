@@ -0,0 +1,104 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "LatencyHistogram.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tell {
+namespace db {
+
+/**
+ * @brief Parts of a transaction's memory
+ */
+enum class MemoryCategory : uint8_t {
+    /// Tuples read from the storage and cached by the transaction
+    TupleCache = 0,
+    /// Tuples inserted, updated or deleted by the transaction
+    WriteSet,
+    /// Index entries inserted or erased by the transaction
+    IndexCache,
+    /// Serialized undo log written by the commit
+    UndoLog,
+};
+
+constexpr size_t gMemoryCategoryCount = static_cast<size_t>(MemoryCategory::UndoLog) + 1;
+
+const char* memoryCategoryName(MemoryCategory category);
+
+/**
+ * @brief Estimated memory of a transaction in bytes
+ *
+ * The estimate includes the objects, map entries and variable sized field values. The memory pool of a transaction
+ * only frees its memory when the transaction is destroyed, so the memory at the end of a transaction is its peak.
+ */
+struct TransactionMemory {
+    size_t operator[](MemoryCategory category) const {
+        return bytes[static_cast<size_t>(category)];
+    }
+
+    size_t total() const;
+
+    std::array<size_t, gMemoryCategoryCount> bytes{};
+};
+
+/**
+ * @brief Memory of a single thread
+ */
+struct ThreadMemory {
+    /// Estimated memory of the thread's context (opened tables and counters)
+    uint64_t contextBytes = 0;
+
+    uint64_t transactions = 0;
+
+    /// Peak memory of the largest transaction
+    uint64_t largestTransaction = 0;
+};
+
+/**
+ * @brief Memory of all transactions finished while the accounting was enabled
+ */
+struct MemoryStats {
+    /**
+     * @brief Sum of the memory of all thread contexts
+     */
+    uint64_t contextBytes() const;
+
+    /// Peak memory of every transaction
+    LatencyHistogram peak;
+
+    /// Memory by category summed over all transactions
+    std::array<uint64_t, gMemoryCategoryCount> totals{};
+
+    /// Transactions that used more memory than the warning threshold
+    uint64_t warnings = 0;
+
+    /// Threads that ran at least one transaction
+    std::vector<ThreadMemory> threads;
+};
+
+} // namespace db
+} // namespace tell
@@ -0,0 +1,103 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/string.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace tell {
+namespace db {
+
+/**
+ * @brief Counters maintained by TellDB
+ */
+enum class Metric : uint8_t {
+    /// Tuples returned by Transaction::get from the transaction's cache
+    TableCacheHits = 0,
+    /// Tuples Transaction::get had to request from the storage
+    RemoteGets,
+    /// Lookups of the first element of an index range
+    IndexLookups,
+    /// Index entries inserted into or erased from a Bd-Tree
+    IndexModifications,
+    /// Entries read from the pointer tables of the Bd-Trees
+    IndexPointerReads,
+    /// Pages read from the node tables of the Bd-Trees
+    IndexNodeReads,
+    /// Batches of keys reserved by a remote counter
+    CounterRefills,
+    /// Times a remote counter ran out of keys and had to wait for a batch
+    CounterStalls,
+    /// Batch reservations a remote counter retried because another client reserved a batch concurrently
+    CounterRetries,
+    UndoLogBytes,
+    UndoLogChunks,
+    /// Write backs of a single row in a table without indexes that skipped the undo log (see enableUndoLogSkipping)
+    UndoLogsSkipped,
+    /// Messages sent to the commit manager, a snapshot shared by read-only transactions is requested and released once
+    CommitManagerRequests,
+    /// Conflicting writes on all tables (see MetricsSnapshot::conflicts for the breakdown)
+    Conflicts,
+    Scans,
+    /// Size of the selection and query sent to the storage by all scans
+    ScanRequestBytes,
+};
+
+constexpr size_t gMetricCount = static_cast<size_t>(Metric::ScanRequestBytes) + 1;
+
+const char* metricName(Metric metric);
+
+/**
+ * @brief Counters of all threads of a ClientManager at one point in time
+ */
+struct MetricsSnapshot {
+    uint64_t operator[](Metric metric) const {
+        return values[static_cast<size_t>(metric)];
+    }
+
+    /**
+     * @brief Average number of Bd-Tree reads (pointers and nodes) per lookup or modification
+     */
+    double indexReadsPerTraversal() const;
+
+    void merge(const MetricsSnapshot& other);
+
+    /**
+     * @brief Text export with one "telldb_<name> <value>" line per counter
+     *
+     * Conflicts are additionally exported per table as telldb_conflicts{table="<name>"}.
+     */
+    crossbow::string toString() const;
+
+    std::array<uint64_t, gMetricCount> values{};
+
+    /// Conflicting writes by table name (including conflicts on the table's indexes)
+    std::map<crossbow::string, uint64_t> conflicts;
+};
+
+} // namespace db
+} // namespace tell
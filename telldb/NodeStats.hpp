@@ -0,0 +1,118 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "LatencyHistogram.hpp"
+
+#include <crossbow/string.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tell {
+namespace db {
+
+/**
+ * @brief Requests TellDB sends to the storage nodes
+ */
+enum class NodeOperation : uint8_t {
+    /// Tuples read by Transaction::get and the Bd-Tree nodes and pointers read by the indexes
+    Get = 0,
+    Insert,
+    Update,
+    Remove,
+    /// Writes reverted when a transaction rolls back
+    Revert,
+    /// Scans are sent to every storage node
+    Scan,
+};
+
+constexpr size_t gNodeOperationCount = static_cast<size_t>(NodeOperation::Scan) + 1;
+
+const char* nodeOperationName(NodeOperation op);
+
+/**
+ * @brief Requests of a single operation on a single storage node
+ */
+struct NodeOperationStats {
+    void merge(const NodeOperationStats& other);
+
+    uint64_t requests = 0;
+
+    /// Size of the tuples, selections and queries sent and received
+    uint64_t bytes = 0;
+
+    /// Time from issuing the request until the response was consumed in nanoseconds
+    LatencyHistogram latency;
+};
+
+/**
+ * @brief Requests sent to a single storage node
+ */
+struct StorageNodeStats {
+    const NodeOperationStats& operator[](NodeOperation op) const {
+        return operations[static_cast<size_t>(op)];
+    }
+
+    uint64_t requests() const;
+
+    uint64_t bytes() const;
+
+    /**
+     * @brief Latency of all operations
+     */
+    LatencyHistogram latency() const;
+
+    std::array<NodeOperationStats, gNodeOperationCount> operations;
+};
+
+/**
+ * @brief Requests of all threads of a ClientManager by storage node
+ *
+ * The node of a request is derived from its key the same way the storage client partitions the keys, so hot
+ * partitions show up as nodes with more requests than the others and degraded nodes as nodes with higher latencies.
+ */
+struct NodeStats {
+    /**
+     * @brief Requests of the busiest node relative to the mean of all nodes (1 if the load is balanced)
+     */
+    double loadSkew() const;
+
+    /**
+     * @brief Latency of the slowest node relative to the median of all nodes (1 if all nodes are equally fast)
+     *
+     * @param percentile The percentile of the latencies compared (between 0 and 100)
+     */
+    double latencySkew(double percentile = 99.0) const;
+
+    /**
+     * @brief Text report with the load and latency of every node, hot and slow nodes are marked
+     */
+    crossbow::string toString() const;
+
+    std::vector<StorageNodeStats> nodes;
+};
+
+} // namespace db
+} // namespace tell
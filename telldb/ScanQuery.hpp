@@ -25,6 +25,9 @@
 
 namespace tell {
 namespace db {
+namespace bench {
+class ScanQueryBenchmark;
+} // namespace bench
 
 using AggregationType = store::AggregationType;
 
@@ -62,6 +65,7 @@ public:
 
 class ScanQuery {
     friend class Transaction;
+    friend class bench::ScanQueryBenchmark;
 private: // members
     table_t mTable;
     bool mDoPartition = false;
@@ -21,8 +21,14 @@
  *     Lucas Braun <braunl@inf.ethz.ch>
  */
 #pragma once
+#include <algorithm>
 #include <type_traits>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <crossbow/singleton.hpp>
 #include <tellstore/ClientConfig.hpp>
@@ -30,6 +36,13 @@
 #include <tellstore/TransactionRunner.hpp>
 
 #include "Transaction.hpp"
+#include "CommitStats.hpp"
+#include "Metrics.hpp"
+#include "TransactionStats.hpp"
+#include "ConflictReport.hpp"
+#include "MemoryStats.hpp"
+#include "WaitStats.hpp"
+#include "NodeStats.hpp"
 
 namespace tell {
 namespace db {
@@ -43,15 +56,191 @@ class CounterImpl;
 
 namespace impl {
 
+class TraceWriter;
+class TimelineWriter;
+class CommitStatsRecorder;
+class Metrics;
+class TransactionStatsRecorder;
+class ConflictProfiler;
+class MemoryRecorder;
+class WaitRecorder;
+class NodeStatsRecorder;
+class CommitBatcher;
+
+/**
+ * @brief The recorders of one kind of all threads of a client
+ *
+ * Every thread creates its own recorders when it starts. They stay registered for the lifetime of the registry, so
+ * snapshots include everything recorded by all threads ever started.
+ */
+template<class Recorder>
+class RecorderRegistry {
+public:
+    std::shared_ptr<Recorder> create() {
+        auto recorder = std::make_shared<Recorder>();
+        std::lock_guard<std::mutex> _(mMutex);
+        mRecorders.push_back(recorder);
+        return recorder;
+    }
+
+    /**
+     * @brief Merges the current state of all recorders into the given statistics
+     *
+     * The arguments are passed to the snapshot function of every recorder in front of the statistics.
+     */
+    template<class Stats, class... Args>
+    void snapshot(Stats& stats, const Args&... args) const {
+        std::lock_guard<std::mutex> _(mMutex);
+        for (auto& recorder : mRecorders) {
+            recorder->snapshot(args..., stats);
+        }
+    }
+
+    template<class Fun>
+    void forEach(Fun fun) const {
+        std::lock_guard<std::mutex> _(mMutex);
+        for (auto& recorder : mRecorders) {
+            fun(*recorder);
+        }
+    }
+
+    std::vector<std::shared_ptr<Recorder>> recorders() const {
+        std::lock_guard<std::mutex> _(mMutex);
+        return mRecorders;
+    }
+
+private:
+    mutable std::mutex mMutex;
+    std::vector<std::shared_ptr<Recorder>> mRecorders;
+};
+
 class ClientTable {
     template<class T> friend class ::tell::db::ClientManager;
     ClientTable() {}
     void init(store::ClientHandle& handle);
     void destroy(store::ClientHandle& handle);
+    void startTrace(const crossbow::string& path);
+    void stopTrace();
+    void startTimeline(const crossbow::string& path, uint64_t sampleInterval);
+    void stopTimeline();
+    void setCommitStatsEnabled(bool enabled) {
+        mCommitStatsEnabled.store(enabled);
+    }
+    CommitStats commitStats();
+    MetricsSnapshot metrics();
+    /**
+     * @brief Index of the given transaction name in the transaction statistics
+     *
+     * Known names are looked up without locking.
+     */
+    uint32_t transactionType(const crossbow::string& name);
+    TransactionStats transactionStats();
+    ConflictReport conflictReport(size_t top);
+    void setMemoryAccounting(bool enabled, size_t warningThreshold) {
+        mMemoryWarningThreshold.store(warningThreshold);
+        mMemoryAccountingEnabled.store(enabled);
+    }
+    MemoryStats memoryStats();
+    void setWaitProfilingEnabled(bool enabled) {
+        mWaitProfilingEnabled.store(enabled);
+    }
+    WaitStats waitStats();
+    void setStorageNodes(size_t nodes) {
+        mStorageNodes = std::max<size_t>(nodes, 1);
+    }
+    void setNodeStatsEnabled(bool enabled);
+    NodeStats nodeStats();
+    void setCounterBatchSize(uint64_t batchSize) {
+        mCounterBatchSize.store(batchSize);
+    }
+    void setCommitBatchingEnabled(bool enabled) {
+        mCommitBatchingEnabled.store(enabled);
+    }
+    void setUndoLogSkippingEnabled(bool enabled) {
+        mUndoLogSkippingEnabled.store(enabled);
+    }
     uint64_t mClientId = 0;
     std::unique_ptr<store::Table> mClientsTable = nullptr;
     std::unique_ptr<store::Table> mTransactionsTable = nullptr;
+    std::shared_ptr<TraceWriter> mTracer;
+    std::shared_ptr<TimelineWriter> mTimeline;
+    std::atomic<bool> mCommitStatsEnabled{false};
+    std::mutex mStatsMutex;
+    RecorderRegistry<CommitStatsRecorder> mCommitStatsRecorders;
+    RecorderRegistry<Metrics> mMetrics;
+    RecorderRegistry<TransactionStatsRecorder> mTransactionStatsRecorders;
+    RecorderRegistry<ConflictProfiler> mConflictProfilers;
+    std::atomic<bool> mMemoryAccountingEnabled{false};
+    std::atomic<size_t> mMemoryWarningThreshold{0};
+    RecorderRegistry<MemoryRecorder> mMemoryRecorders;
+    std::atomic<bool> mWaitProfilingEnabled{false};
+    RecorderRegistry<WaitRecorder> mWaitRecorders;
+    // only accessed while holding mStatsMutex (except when set before any transaction runs)
+    size_t mStorageNodes = 1;
+    bool mNodeStatsEnabled = false;
+    RecorderRegistry<NodeStatsRecorder> mNodeStatsRecorders;
+    std::atomic<uint64_t> mCounterBatchSize{0};
+    std::atomic<bool> mCommitBatchingEnabled{false};
+    std::atomic<bool> mUndoLogSkippingEnabled{false};
+    // copied on every new name, the names are only accessed while holding mStatsMutex
+    std::shared_ptr<const std::unordered_map<crossbow::string, uint32_t>> mTransactionTypes;
+    std::vector<crossbow::string> mTransactionTypeNames;
+    std::chrono::steady_clock::time_point mCreated = std::chrono::steady_clock::now();
 public:
+    /**
+     * @brief The trace new transactions are recorded in (nullptr if tracing is disabled)
+     */
+    std::shared_ptr<TraceWriter> tracer() const {
+        return std::atomic_load(&mTracer);
+    }
+
+    /**
+     * @brief The timeline sampled transactions are recorded in (nullptr if disabled)
+     */
+    std::shared_ptr<TimelineWriter> timeline() const {
+        return std::atomic_load(&mTimeline);
+    }
+
+    bool commitStatsEnabled() const {
+        return mCommitStatsEnabled.load(std::memory_order_relaxed);
+    }
+
+    bool memoryAccountingEnabled() const {
+        return mMemoryAccountingEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Transactions using more memory are logged as warnings (0 if disabled)
+     */
+    size_t memoryWarningThreshold() const {
+        return mMemoryWarningThreshold.load(std::memory_order_relaxed);
+    }
+
+    bool waitProfilingEnabled() const {
+        return mWaitProfilingEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of values counters reserve at once (0 for the default)
+     */
+    uint64_t counterBatchSize() const {
+        return mCounterBatchSize.load(std::memory_order_relaxed);
+    }
+
+    bool commitBatchingEnabled() const {
+        return mCommitBatchingEnabled.load(std::memory_order_relaxed);
+    }
+
+    bool undoLogSkippingEnabled() const {
+        return mUndoLogSkippingEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Creates the recorder of the given kind for a new thread, see RecorderRegistry
+     */
+    template<class Recorder>
+    std::shared_ptr<Recorder> registerRecorder();
+
     /**
      * @brief Table where clients register themselves
      */
@@ -65,7 +254,13 @@ public:
 };
 
 class Indexes;
-Indexes* createIndexes(store::ClientHandle& handle);
+struct TellDBContext;
+Indexes* createIndexes(store::ClientHandle& handle, TellDBContext& context);
+/**
+ * @brief Requests the snapshot of a new transaction, batched with the other fibers of the thread if enabled
+ */
+std::unique_ptr<commitmanager::SnapshotDescriptor> startSnapshot(store::ClientHandle& handle, TellDBContext& context,
+        store::TransactionType type);
 struct TellDBContext {
     TellDBContext(ClientTable* table);
     ~TellDBContext();
@@ -75,6 +270,14 @@ struct TellDBContext {
     std::unordered_map<crossbow::string, table_t> tableNames;
     std::unique_ptr<Indexes> indexes;
     ClientTable* clientTable;
+    std::shared_ptr<CommitStatsRecorder> commitStats;
+    std::shared_ptr<Metrics> metrics;
+    std::shared_ptr<TransactionStatsRecorder> transactionStats;
+    std::shared_ptr<ConflictProfiler> conflictProfiler;
+    std::shared_ptr<MemoryRecorder> memory;
+    std::shared_ptr<WaitRecorder> waits;
+    std::shared_ptr<NodeStatsRecorder> nodes;
+    std::unique_ptr<CommitBatcher> commitBatcher;
 };
 
 template<class Context>
@@ -132,10 +335,10 @@ private: // private access
         if (cpu < 0)
             mTxRunner->execute([type, fun](tell::store::ClientHandle& handle, telldb_context& context) {
                 if (context.mContext.indexes == nullptr) {
-                    context.mContext.setIndexes(impl::createIndexes(handle));
+                    context.mContext.setIndexes(impl::createIndexes(handle, context.mContext));
                 }
                 try {
-                    auto snapshot = handle.startTransaction(type);
+                    auto snapshot = impl::startSnapshot(handle, context.mContext, type);
                     Transaction transaction(handle, context.mContext, std::move(snapshot), type);
                     context.executeHandler(fun, transaction);
                 } catch (std::exception& e) {
@@ -148,10 +351,10 @@ private: // private access
         else 
             mTxRunner->execute(cpu, [type, fun](tell::store::ClientHandle& handle, telldb_context& context) {
                 if (context.mContext.indexes == nullptr) {
-                    context.mContext.setIndexes(impl::createIndexes(handle));
+                    context.mContext.setIndexes(impl::createIndexes(handle, context.mContext));
                 }
                 try {
-                    auto snapshot = handle.startTransaction(type);
+                    auto snapshot = impl::startSnapshot(handle, context.mContext, type);
                     Transaction transaction(handle, context.mContext, std::move(snapshot), type);
                     context.executeHandler(fun, transaction);
                 } catch (std::exception& e) {
@@ -162,6 +365,30 @@ private: // private access
                 }
             });
     }
+    template<class Fun>
+    void execNamed(Fun fun, int cpu, uint32_t typeId, uint32_t maxRetries) {
+        auto type = mTxType;
+        auto run = [type, fun, typeId, maxRetries](tell::store::ClientHandle& handle, telldb_context& context) {
+            if (context.mContext.indexes == nullptr) {
+                context.mContext.setIndexes(impl::createIndexes(handle, context.mContext));
+            }
+            try {
+                impl::runNamedTransaction(handle, context.mContext, type, typeId, maxRetries,
+                        [&context, &fun](Transaction& transaction) {
+                    context.executeHandler(fun, transaction);
+                });
+            } catch (std::exception& e) {
+                std::cerr << "Exception: " << e.what() << std::endl;
+            } catch (...) {
+                // This should never happen
+                std::cerr << "Got an unknown error" << std::endl;
+            }
+        };
+        if (cpu < 0)
+            mTxRunner->execute(run);
+        else
+            mTxRunner->execute(cpu, run);
+    }
 public: // construction
     TransactionFiber(const TransactionFiber&) = delete;
     TransactionFiber(TransactionFiber&& other)
@@ -216,8 +443,9 @@ public:
 template<class Context>
 class ClientManager {
 private:
-    tell::store::ClientManager<impl::FiberContext<Context>> mClientManager;
+    // The client table has to be constructed first as the contexts of all processors register with it
     impl::ClientTable mClientTable;
+    tell::store::ClientManager<impl::FiberContext<Context>> mClientManager;
     std::unique_ptr<store::ScanMemoryManager> mScanMemoryManager;
 public:
     /**
@@ -240,6 +468,11 @@ public:
     ClientManager(tell::store::ClientConfig& clientConfig, Args... args)
         : mClientManager(clientConfig, &mClientTable, args...)
     {
+#ifdef TELLDB_LOCAL_STORE
+        mClientTable.setStorageNodes(mClientManager.storage().numNodes());
+#else
+        mClientTable.setStorageNodes(clientConfig.tellStore.size());
+#endif
         store::TransactionRunner::executeBlocking(mClientManager,
                 [this](store::ClientHandle &handle, impl::FiberContext<Context>&){
             mClientTable.init(handle);
@@ -284,6 +517,30 @@ public:
         return fiber;
     }
 
+    /**
+     * @brief starts a new transaction whose statistics are recorded under the given name
+     *
+     * Behaves like the unnamed startTransaction but records the latency, execution time, commit time and number of
+     * retries of the transaction in the statistics of its name (see transactionStats()). If a conflict (Conflict,
+     * Conflicts or IndexConflict) escapes from fun, the transaction is rolled back and fun is run again in a new
+     * transaction up to maxRetries times.
+     *
+     * @param[in] name The name of the transaction type, names should come from a small fixed set
+     * @param[in] maxRetries Number of times the transaction is restarted after a conflict
+     */
+    template<class Fun>
+    TransactionFiber<Context> startTransaction(
+            const crossbow::string& name,
+            Fun&& fun,
+            tell::store::TransactionType type = tell::store::TransactionType::READ_WRITE,
+            int cpu = -1,
+            uint32_t maxRetries = 0)
+    {
+        TransactionFiber<Context> fiber(mClientManager, type);
+        fiber.execNamed(std::forward<Fun>(fun), cpu, mClientTable.transactionType(name), maxRetries);
+        return fiber;
+    }
+
     /**
      * @brief allocates scan memomry. Be cautious with this call as it is extremely expensive!
      *
@@ -316,7 +573,193 @@ public:
         return mScanMemoryManager.get();
     }
 
+    /**
+     * @brief Records all transactions started from now on in the given file
+     *
+     * Every transaction is written with its operations (tables, keys, written tuples, index ranges) and their timing
+     * when it finishes. The trace can be read with TraceReader. Starting a new trace stops the previous one, running
+     * transactions keep writing to the trace they were started with.
+     *
+     * @throws std::runtime_error If the file can not be opened
+     */
+    void startTrace(const crossbow::string& path) {
+        mClientTable.startTrace(path);
+    }
+
+    /**
+     * @brief Stops recording new transactions
+     */
+    void stopTrace() {
+        mClientTable.stopTrace();
+    }
+
+    /**
+     * @brief Records the timeline of every n-th transaction started from now on in the given file
+     *
+     * The timeline shows every request a sampled transaction sends to the storage and the commit manager (from issuing
+     * it until its result is used) and the times its fiber was blocked. The file is written in the Chrome trace event
+     * format and can be opened in chrome://tracing or Perfetto. Starting a new timeline stops the previous one.
+     *
+     * @throws std::runtime_error If the file can not be opened
+     */
+    void startTimeline(const crossbow::string& path, uint64_t sampleInterval = 1) {
+        mClientTable.startTimeline(path, sampleInterval);
+    }
+
+    /**
+     * @brief Stops sampling new transactions, the file is complete once all sampled transactions finished
+     */
+    void stopTimeline() {
+        mClientTable.stopTimeline();
+    }
 
+    /**
+     * @brief Enables or disables recording the latency of every commit phase
+     *
+     * Recording is disabled by default. Every thread records into its own histograms, so enabling the statistics
+     * does not add any synchronization to the commit path.
+     */
+    void enableCommitStats(bool enabled = true) {
+        mClientTable.setCommitStatsEnabled(enabled);
+    }
+
+    /**
+     * @brief Snapshot of the commit latencies of all threads
+     *
+     * The histograms are cumulative over all commits recorded since the client manager was created. The snapshot can
+     * be taken at any time without stopping running transactions.
+     */
+    CommitStats commitStats() {
+        return mClientTable.commitStats();
+    }
+
+    /**
+     * @brief Snapshot of the internal counters of all threads
+     *
+     * The counters are always maintained and cumulative since the client manager was created. Use
+     * MetricsSnapshot::toString to export them in text form.
+     */
+    MetricsSnapshot metrics() {
+        return mClientTable.metrics();
+    }
+
+    /**
+     * @brief Snapshot of the statistics of all transactions started with a name
+     *
+     * The statistics are always recorded for named transactions and cumulative since the client manager was created.
+     * Only the first 63 names are recorded individually, all further names are combined under "<other>".
+     */
+    TransactionStats transactionStats() {
+        return mClientTable.transactionStats();
+    }
+
+    /**
+     * @brief Report of the keys that caused the most conflicts on all threads
+     *
+     * Conflicts are always profiled: conflicting tuples (Conflict and Conflicts) and index entries (IndexConflict) are
+     * counted per table and key since the client manager was created.
+     *
+     * @param top Number of keys in the report
+     */
+    ConflictReport conflictReport(size_t top = 20) {
+        return mClientTable.conflictReport(top);
+    }
+
+    /**
+     * @brief Enables or disables accounting the memory of every transaction
+     *
+     * Accounting is disabled by default. When enabled, every transaction estimates the memory of its caches and undo
+     * log when it commits or rolls back (see Transaction::memoryUsage). Named transactions additionally record their
+     * memory in their transaction statistics.
+     *
+     * @param warningThreshold Transactions using more bytes are logged as warnings (0 disables the warnings)
+     */
+    void enableMemoryAccounting(bool enabled = true, size_t warningThreshold = 0) {
+        mClientTable.setMemoryAccounting(enabled, warningThreshold);
+    }
+
+    /**
+     * @brief Snapshot of the memory of all transactions accounted since the client manager was created
+     */
+    MemoryStats memoryStats() {
+        return mClientTable.memoryStats();
+    }
+
+    /**
+     * @brief Enables or disables profiling the times transactions are blocked
+     *
+     * Profiling is disabled by default. When enabled, every transaction measures how long its fiber waits for the
+     * storage, the commit manager and the counters at every blocking site (see WaitSite) and how long it was runnable.
+     */
+    void enableWaitProfiling(bool enabled = true) {
+        mClientTable.setWaitProfilingEnabled(enabled);
+    }
+
+    /**
+     * @brief Snapshot of the waits of all transactions profiled since the client manager was created
+     */
+    WaitStats waitStats() {
+        return mClientTable.waitStats();
+    }
+
+    /**
+     * @brief Enables or disables the statistics of the requests sent to every storage node
+     *
+     * The statistics are disabled by default. When enabled, the tuple reads and writes of the transactions, the
+     * requests of the Bd-Tree indexes and the scans are counted and timed by the storage node responsible for them.
+     */
+    void enableNodeStats(bool enabled = true) {
+        mClientTable.setNodeStatsEnabled(enabled);
+    }
+
+    /**
+     * @brief Snapshot of the requests sent to every storage node since the client manager was created
+     *
+     * NodeStats::toString reports the skew between the nodes.
+     */
+    NodeStats nodeStats() {
+        return mClientTable.nodeStats();
+    }
+
+    /**
+     * @brief Sets the number of values a counter reserves from the storage at once
+     *
+     * Every thread reserves batches of values from the shared counter row and requests the next batch when a tenth of
+     * its batch is left. Larger batches cause fewer conflicting reservations between the threads but leave larger gaps
+     * in the sequence. Only counters first used by a thread afterwards are affected.
+     *
+     * @param batchSize Number of values per batch (0 for the default of 1000)
+     */
+    void setCounterBatchSize(uint64_t batchSize) {
+        mClientTable.setCounterBatchSize(batchSize);
+    }
+
+    /**
+     * @brief Enables or disables sharing the snapshots of read-only transactions started together on a thread
+     *
+     * Batching is disabled by default. When enabled, read-only transactions whose fibers run on the same thread and
+     * start at the same time (or while the snapshot request of another one is in flight) share a single snapshot, which
+     * is requested once and released with a single commit once all of them finished. The load of the commit manager
+     * from read-only transactions then grows with the number of threads instead of the number of transactions (see
+     * Metric::CommitManagerRequests). Every transaction still reads a snapshot taken after it started. Read-write
+     * transactions always send their own requests. Transactions sharing a snapshot also share its version, e.g. in the
+     * timeline.
+     */
+    void enableCommitBatching(bool enabled = true) {
+        mClientTable.setCommitBatchingEnabled(enabled);
+    }
+
+    /**
+     * @brief Enables or disables committing single row writes without an undo log
+     *
+     * Disabled by default. When enabled, transactions writing exactly one row in a table without indexes skip writing
+     * and removing the undo log, which saves two round trips (see Metric::UndoLogsSkipped). The undo log is the only
+     * record recovery uses to revert the writes of a crashed client: if a client crashes before committing such a
+     * transaction, its write is never reverted and every later write to the same key conflicts with it permanently.
+     */
+    void enableUndoLogSkipping(bool enabled = true) {
+        mClientTable.setUndoLogSkippingEnabled(enabled);
+    }
 
     /**
      * @brief Shutdown everything
@@ -0,0 +1,117 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "Field.hpp"
+
+#include <tellstore/TransactionType.hpp>
+#include <crossbow/string.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+namespace tell {
+namespace db {
+
+/**
+ * @brief Operations recorded in a transaction trace
+ */
+enum class TraceOperation : uint8_t {
+    Get,
+    Insert,
+    Update,
+    Remove,
+    LowerBound,
+    ReverseLowerBound,
+    Scan,
+};
+
+enum class TraceOutcome : uint8_t {
+    Committed,
+    /// The transaction was rolled back by the application
+    RolledBack,
+    /// The commit failed and the transaction was rolled back
+    Aborted,
+};
+
+/**
+ * @brief A single operation of a traced transaction
+ */
+struct TraceEntry {
+    TraceOperation operation;
+    /// Time of the operation in nanoseconds since the start of the transaction
+    uint64_t time;
+    /// Index into the table names of the transaction
+    uint32_t table;
+    /// Key of the tuple
+    uint64_t key;
+    /// Number of times the iterator of a range query was advanced
+    uint64_t advanced;
+    /// Name of the index for range queries
+    crossbow::string index;
+    /// Fields of the written tuple or the index key for range queries
+    std::vector<Field> values;
+};
+
+/**
+ * @brief A transaction as recorded in a trace
+ */
+struct TraceTransaction {
+    /// Start of the transaction in nanoseconds since the start of the trace
+    uint64_t start;
+    /// Duration of the transaction in nanoseconds
+    uint64_t duration;
+    store::TransactionType type;
+    TraceOutcome outcome;
+    /// Names of all tables accessed by the transaction
+    std::vector<crossbow::string> tables;
+    std::vector<TraceEntry> entries;
+};
+
+/**
+ * @brief Reads the transactions of a trace written by ClientManager::startTrace
+ *
+ * Transactions are stored in the order they finished.
+ */
+class TraceReader {
+public:
+    /**
+     * @throws std::runtime_error If the file can not be opened or is not a trace
+     */
+    TraceReader(const crossbow::string& path);
+
+    /**
+     * @brief Reads the next transaction
+     *
+     * @return False if the end of the trace was reached
+     * @throws std::runtime_error If the trace is truncated
+     */
+    bool next(TraceTransaction& transaction);
+
+private:
+    std::ifstream mIn;
+    std::vector<char> mBuffer;
+};
+
+} // namespace db
+} // namespace tell
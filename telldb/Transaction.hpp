@@ -24,10 +24,16 @@
 #include "Tuple.hpp"
 #include "Types.hpp"
 #include "Iterator.hpp"
+#include "Trace.hpp"
+#include "MemoryStats.hpp"
+#include "WaitStats.hpp"
 
 #include <tellstore/TransactionType.hpp>
 #include <tellstore/ClientSocket.hpp>
 #include <crossbow/ChunkAllocator.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <tuple>
 
 /**
@@ -55,8 +61,16 @@ class GetResponse;
 
 namespace db {
 
+class Transaction;
+
 namespace impl {
 struct TellDBContext;
+class TransactionTrace;
+class TransactionTimeline;
+class TransactionStatsRecorder;
+
+void runNamedTransaction(store::ClientHandle& handle, TellDBContext& context, store::TransactionType type,
+        uint32_t typeId, uint32_t maxRetries, const std::function<void(Transaction&)>& fun);
 } // namespace impl
 class TransactionCache;
 
@@ -142,8 +156,13 @@ class Future<Tuple> {
     const Tuple* result;
     TableCache* cache;
     std::shared_ptr<tell::store::GetResponse> response;
+    // timeline span of the request (0 if the transaction is not sampled)
+    uint32_t span = 0;
+    // start of the request for the storage node statistics (0 if disabled)
+    uint64_t requestBegin = 0;
     Future(key_t key, const Tuple* result);
-    Future(key_t key, TableCache* cache, std::shared_ptr<tell::store::GetResponse>&& response);
+    Future(key_t key, TableCache* cache, std::shared_ptr<tell::store::GetResponse>&& response, uint32_t span,
+            uint64_t requestBegin);
 public:
     bool done() const;
     bool wait() const;
@@ -160,7 +179,8 @@ class Counter {
     friend class Transaction;
     CounterImpl* impl;
     store::ClientHandle& mHandle;
-    Counter(CounterImpl* impl, store::ClientHandle& handle);
+    std::shared_ptr<impl::TransactionTimeline> mTimeline;
+    Counter(CounterImpl* impl, store::ClientHandle& handle, std::shared_ptr<impl::TransactionTimeline> timeline);
 public:
     uint64_t next();
     Counter(Counter&&);
@@ -169,7 +189,36 @@ public:
 
 class ScanQuery;
 
+/**
+ * @brief Time spent in the phases of a commit and the size of the undo log written
+ *
+ * All values are zero if the transaction did not write anything.
+ */
+struct CommitProfile {
+    using Duration = std::chrono::nanoseconds;
+
+    /// Serializing the undo log from the transaction cache
+    Duration undoLog = Duration::zero();
+    /// Writing the undo log to the storage
+    Duration writeUndoLog = Duration::zero();
+    /// Writing the modified tuples back to the storage
+    Duration writeBack = Duration::zero();
+    /// Writing the index modifications back to the Bd-Trees
+    Duration writeIndexes = Duration::zero();
+    /// Removing the undo log from the storage
+    Duration removeUndoLog = Duration::zero();
+    /// Committing the snapshot at the commit manager
+    Duration commit = Duration::zero();
+    /// Size of the undo log in bytes
+    size_t undoLogSize = 0;
+    /// Number of tuples the undo log was split into
+    size_t undoLogChunks = 0;
+};
+
 class Transaction {
+    friend void impl::runNamedTransaction(store::ClientHandle& handle, impl::TellDBContext& context,
+            store::TransactionType type, uint32_t typeId, uint32_t maxRetries,
+            const std::function<void(Transaction&)>& fun);
 public: // Types
     /**
      *  A string which has a life time equal to the lifetime of the transaction
@@ -180,11 +229,25 @@ private:
     impl::TellDBContext& mContext;
     crossbow::ChunkMemoryPool mPool;
     std::unique_ptr<commitmanager::SnapshotDescriptor> mSnapshot;
+    // only set if the transaction was sampled for the timeline
+    std::shared_ptr<impl::TransactionTimeline> mTimeline;
     std::unique_ptr<TransactionCache> mCache;
     // will be set to true if there is any data
     // written to the storage
     store::TransactionType mType;
     bool mCommitted = false;
+    // start of the transaction in ticks of the cycle clock
+    uint64_t mBeginTicks;
+    // start of the first call to commit (0 if the transaction did not try to commit)
+    uint64_t mCommitTicks = 0;
+    // only set for named transactions, records the attempt under mStatsType
+    impl::TransactionStatsRecorder* mStats = nullptr;
+    uint32_t mStatsType = 0;
+    CommitProfile mProfile;
+    // size of the undo log written by a write back that failed, the rollback removes it
+    size_t mUndoLogSize = 0;
+    // only set while the client manager records a trace
+    std::unique_ptr<impl::TransactionTrace> mTrace;
 public:
     Transaction(tell::store::ClientHandle& handle,
             impl::TellDBContext& context,
@@ -266,6 +329,7 @@ public: // read-write operations
      * @param key   The key of the tuple
      * @param tuple The tuple to insert
      * @throws TupleExistsException If the key is already in the local cache.
+     * @throws std::logic_error If the transaction is read only.
      */
     void insert(table_t table, key_t key, const Tuple& tuple);
     /**
@@ -281,6 +345,7 @@ public: // read-write operations
      * @throws TupleExistsException If the key is already in the local cache.
      * @throws FieldDoesNotExist If a field does not exist in the schema.
      * @throws FieldNotSet If a required field is not set in the tuple.
+     * @throws std::logic_error If the transaction is read only.
      */
     void insert(table_t table, key_t key, const std::unordered_map<crossbow::string, Field>& values);
     /**
@@ -301,6 +366,7 @@ public: // read-write operations
      * @param from  The current version of the tuple
      * @param to    The new version of the tuple
      * @throws Conflict If a conflict is detected.
+     * @throws std::logic_error If the transaction is read only.
      */
     void update(table_t table, key_t key, const Tuple& from, const Tuple& to);
     /**
@@ -320,6 +386,7 @@ public: // read-write operations
      * @param key   The key of the tuple
      * @param tuple The tuple to delete
      * @throws Conflict If a conflict is detected.
+     * @throws std::logic_error If the transaction is read only.
      */
     void remove(table_t table, key_t key, const Tuple& tuple);
     /**
@@ -350,9 +417,19 @@ public: // finish
     void commit();
 private:
     void writeBack(bool withIndexes = true);
+    /**
+     * @brief The caches of the transaction, created on first use
+     */
+    TransactionCache& cache();
+    void checkWritable() const;
     void writeUndoLog(std::pair<size_t, uint8_t*> log);
     void removeUndoLog(std::pair<size_t, uint8_t*> log);
+    void accountMemory();
+    void finishTimeline(const char* outcome);
     const store::Record& getRecord(table_t tableId) const;
+    const crossbow::string& tableName(table_t table) const;
+    Iterator traceRange(Iterator iter, TraceOperation operation, table_t tableId, const crossbow::string& idxName,
+            const KeyType& key);
 public: // non-commands
     /**
      * @brief Gets the memory pool of this transaction
@@ -379,6 +456,27 @@ public: // non-commands
     tell::store::ClientHandle& getHandle() {
         return mHandle;
     }
+    /**
+     * @brief Gets the phase breakdown of the commit
+     *
+     * Only valid after the transaction committed successfully.
+     */
+    const CommitProfile& commitProfile() const {
+        return mProfile;
+    }
+    /**
+     * @brief Estimates the memory used by the transaction's caches and undo log
+     *
+     * Iterates over all cached tuples and changes, so it should not be called in a tight loop.
+     */
+    TransactionMemory memoryUsage() const;
+    /**
+     * @brief Times the transaction was blocked so far
+     *
+     * Only recorded while wait profiling is enabled (see ClientManager::enableWaitProfiling) or the transaction is
+     * sampled for the timeline.
+     */
+    TransactionWaits waits() const;
 };
 
 template<id_t id, class... T>
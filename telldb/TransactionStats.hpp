@@ -0,0 +1,84 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "LatencyHistogram.hpp"
+
+#include <crossbow/string.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+
+namespace tell {
+namespace db {
+
+/**
+ * @brief Statistics of all transactions started with the same name
+ *
+ * A transaction consists of one or more attempts: an attempt that fails with a conflict is retried if the transaction
+ * was started with retries. Latency and retries are recorded once per transaction, execution and commit time once per
+ * attempt. All times are in nanoseconds.
+ */
+struct TransactionTypeStats {
+    void merge(const TransactionTypeStats& other);
+
+    /// From starting the first attempt until the last attempt finished
+    LatencyHistogram latency;
+
+    /// Running the transaction's function without its commit or rollback
+    LatencyHistogram execution;
+
+    /// Committing or rolling back the attempt
+    LatencyHistogram commit;
+
+    /// Number of retries until the transaction finished
+    LatencyHistogram retries;
+
+    /// Peak memory of every attempt in bytes (only recorded while memory accounting is enabled)
+    LatencyHistogram memory;
+
+    /// Attempts that committed
+    uint64_t committed = 0;
+
+    /// Attempts that were rolled back or failed with an exception
+    uint64_t aborted = 0;
+};
+
+/**
+ * @brief Statistics of the named transactions of all threads of a ClientManager
+ */
+struct TransactionStats {
+    /**
+     * @brief Committed transactions of the given type per second since the client manager was created
+     */
+    double throughput(const crossbow::string& name) const;
+
+    /// Statistics by transaction name
+    std::map<crossbow::string, TransactionTypeStats> types;
+
+    /// Time since the client manager was created
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds::zero();
+};
+
+} // namespace db
+} // namespace tell
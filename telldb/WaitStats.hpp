@@ -0,0 +1,124 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "LatencyHistogram.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace tell {
+namespace db {
+
+/**
+ * @brief Places where the fiber of a transaction blocks
+ */
+enum class WaitSite : uint8_t {
+    /// Future<Tuple>::get waiting for a tuple from the storage
+    Get = 0,
+    /// A remote counter ran out of keys and waits for the next batch
+    Counter,
+    /// Reading and updating the counter table for the next batch of keys
+    CounterRefill,
+    /// Reading pointers and nodes of a Bd-Tree
+    IndexRead,
+    /// Inserting, updating and removing pointers and nodes of a Bd-Tree
+    IndexWrite,
+    /// Writing the changes to the storage on commit
+    WriteBack,
+    /// Reverting the changes on rollback
+    Revert,
+    /// Writing and removing the undo log
+    UndoLog,
+    /// Committing the snapshot at the commit manager
+    Commit,
+    /// Starting a scan
+    Scan,
+};
+
+constexpr size_t gWaitSiteCount = static_cast<size_t>(WaitSite::Scan) + 1;
+
+const char* waitSiteName(WaitSite site);
+
+/**
+ * @brief Times a single transaction was blocked
+ */
+struct TransactionWaits {
+    using Duration = std::chrono::nanoseconds;
+
+    struct Site {
+        uint64_t waits = 0;
+        Duration total = Duration::zero();
+        Duration longest = Duration::zero();
+    };
+
+    const Site& operator[](WaitSite site) const {
+        return sites[static_cast<size_t>(site)];
+    }
+
+    uint64_t waits() const;
+
+    /**
+     * @brief Total time the transaction was blocked
+     */
+    Duration total() const;
+
+    Duration longest() const;
+
+    std::array<Site, gWaitSiteCount> sites;
+};
+
+/**
+ * @brief Times the transactions of all threads of a ClientManager were blocked
+ *
+ * All times are in nanoseconds.
+ */
+struct WaitStats {
+    /**
+     * @brief Duration of every wait at the given site
+     */
+    const LatencyHistogram& site(WaitSite site) const {
+        return sites[static_cast<size_t>(site)];
+    }
+
+    std::array<LatencyHistogram, gWaitSiteCount> sites;
+
+    /// Longest wait by site
+    std::array<uint64_t, gWaitSiteCount> longest{};
+
+    /// Time every transaction was blocked
+    LatencyHistogram blocked;
+
+    /// Time every transaction was runnable (from its start until it finished minus the time it was blocked)
+    LatencyHistogram runnable;
+
+    /// Number of waits of every transaction
+    LatencyHistogram waits;
+
+    /// Longest wait of every transaction
+    LatencyHistogram longestWait;
+};
+
+} // namespace db
+} // namespace tell
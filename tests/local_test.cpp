@@ -0,0 +1,576 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+
+#undef NDEBUG
+
+#include <telldb/TellDB.hpp>
+#include <telldb/Transaction.hpp>
+#include <telldb/Exceptions.hpp>
+#include <telldb/Trace.hpp>
+#include <telldb/CommitStats.hpp>
+#include <telldb/LatencyHistogram.hpp>
+#include <telldb/Metrics.hpp>
+
+#include <crossbow/allocator.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace crossbow::program_options;
+
+namespace {
+
+std::atomic<int> gErrors(0);
+
+void check(bool condition, const char* msg) {
+    if (!condition) {
+        std::cerr << "ERROR: " << msg << std::endl;
+        ++gErrors;
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    bool help = false;
+    uint64_t latency = 0;
+    auto opts = create_options("local_test",
+            value<'h'>("help", &help, tag::description{"print help"}),
+            value<'l'>("latency", &latency, tag::description{"Simulated round trip time in microseconds"})
+            );
+    try {
+        parse(opts, argc, argv);
+    } catch (argument_not_found& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+
+    crossbow::allocator::init();
+
+    tell::store::ClientConfig config;
+    config.local.setLatency(std::chrono::microseconds(latency));
+    tell::db::ClientManager<void> clientManager(config);
+
+    // Populate a table and read it back
+    {
+        auto transaction = [](tell::db::Transaction& tx) {
+            tell::store::Schema schema(tell::store::TableType::TRANSACTIONAL);
+            schema.addField(tell::store::FieldType::INT, "foo", true);
+            schema.addField(tell::store::FieldType::TEXT, "bar", false);
+            auto tid = tx.createTable("foo", schema);
+            for (int32_t i = 0; i < 100; ++i) {
+                tx.insert(tid, tell::db::key_t{uint64_t(i)},
+                        {{
+                        {"foo", i},
+                        {"bar", i % 5 == 0 ? tell::db::Field(nullptr) : tell::db::Field("foobar")}
+                        }});
+            }
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+    }
+    {
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            for (int i = 0; i < 100; ++i) {
+                auto tuple = tx.get(tid, tell::db::key_t{uint64_t(i)}).get();
+                check(tuple.at("foo").value<int32_t>() == i, "wrong value for foo");
+                check(tuple.at("bar").null() == (i % 5 == 0), "wrong value for bar");
+            }
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction, tell::store::TransactionType::READ_ONLY);
+        fiber.wait();
+    }
+    // Two concurrent writers on the same key - exactly one of them has to fail
+    {
+        std::atomic<int> conflicts(0);
+        auto transaction = [&conflicts](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            auto& tuple = tx.get(tid, tell::db::key_t{1}).get();
+            auto next = tuple;
+            next.at("foo") = next.at("foo").value<int32_t>() + 1;
+            tx.update(tid, tell::db::key_t{1}, tuple, next);
+            try {
+                tx.commit();
+            } catch (tell::db::Conflicts&) {
+                ++conflicts;
+                tx.rollback();
+            }
+        };
+        auto first = clientManager.startTransaction(transaction);
+        auto second = clientManager.startTransaction(transaction);
+        first.wait();
+        second.wait();
+        check(conflicts <= 1, "both writers failed");
+    }
+    // Range queries on an index
+    {
+        auto transaction = [](tell::db::Transaction& tx) {
+            tell::store::Schema schema(tell::store::TableType::TRANSACTIONAL);
+            schema.addField(tell::store::FieldType::INT, "field", true);
+            schema.addIndex("idx", std::make_pair(true, std::vector<tell::store::Schema::id_t>{schema.idOf("field")}));
+            auto tid = tx.createTable("idx_table", schema);
+            for (int32_t i = 0; i < 1000; ++i) {
+                tx.insert(tid, tell::db::key_t{uint64_t(i)}, {{ {"field", i} }});
+            }
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+    }
+    {
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("idx_table").get();
+            int32_t currKey = 132;
+            auto iter = tx.lower_bound(tid, "idx", {tell::db::Field(currKey)});
+            for (int i = 0; i < 200; ++i) {
+                check(!iter.done(), "Should not be out of range");
+                check(iter.key()[0].value<int32_t>() == currKey, "range broken");
+                check(iter.value().value == uint64_t(currKey), "Index does not point to correct value");
+                iter.next();
+                ++currKey;
+            }
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+    }
+    // Read only transactions can use the indexes but reject writes
+    {
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("idx_table").get();
+            auto iter = tx.lower_bound(tid, "idx", {tell::db::Field(int32_t(132))});
+            check(!iter.done() && iter.value().value == 132u, "index not readable in read only transaction");
+            auto& tuple = tx.get(tid, tell::db::key_t{132}).get();
+            try {
+                tx.remove(tid, tell::db::key_t{132}, tuple);
+                check(false, "read only transaction accepted a write");
+            } catch (std::logic_error&) {
+            }
+            tx.commit();
+            try {
+                tx.commit();
+                check(false, "read only transaction committed twice");
+            } catch (std::logic_error&) {
+            }
+        };
+        auto fiber = clientManager.startTransaction(transaction, tell::store::TransactionType::READ_ONLY);
+        fiber.wait();
+    }
+    // Traced transactions can be read back with their operations
+    {
+        auto tracePath = "local_test.trace";
+        clientManager.startTrace(tracePath);
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("idx_table").get();
+            tx.get(tid, tell::db::key_t{5}).get();
+            auto iter = tx.lower_bound(tid, "idx", {tell::db::Field(int32_t(10))});
+            for (int i = 0; i < 3; ++i) {
+                iter.next();
+            }
+            tx.insert(tid, tell::db::key_t{1000}, {{ {"field", int32_t(1000)} }});
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+        clientManager.stopTrace();
+
+        tell::db::TraceReader reader(tracePath);
+        tell::db::TraceTransaction traced;
+        check(reader.next(traced), "trace is empty");
+        check(traced.outcome == tell::db::TraceOutcome::Committed, "wrong outcome in trace");
+        check(traced.tables.size() == 1 && traced.tables[0] == "idx_table", "wrong tables in trace");
+        check(traced.entries.size() == 3, "wrong number of traced operations");
+        if (traced.entries.size() == 3) {
+            check(traced.entries[0].operation == tell::db::TraceOperation::Get && traced.entries[0].key == 5,
+                    "wrong traced get");
+            check(traced.entries[1].operation == tell::db::TraceOperation::LowerBound
+                    && traced.entries[1].advanced == 3 && traced.entries[1].index == "idx", "wrong traced range");
+            check(traced.entries[2].operation == tell::db::TraceOperation::Insert
+                    && traced.entries[2].values.size() == 1, "wrong traced insert");
+        }
+        check(!reader.next(traced), "unexpected transaction in trace");
+        std::remove(tracePath);
+    }
+    // Commit statistics only count writing transactions committed while they are enabled
+    {
+        clientManager.enableCommitStats();
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            tx.insert(tid, tell::db::key_t{200}, {{ {"foo", int32_t(200)}, {"bar", tell::db::Field("stats")} }});
+            tx.insert(tid, tell::db::key_t{201}, {{ {"foo", int32_t(201)}, {"bar", tell::db::Field("stats")} }});
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+        auto readOnly = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            tx.get(tid, tell::db::key_t{200}).get();
+            tx.commit();
+        };
+        auto readFiber = clientManager.startTransaction(readOnly);
+        readFiber.wait();
+        clientManager.enableCommitStats(false);
+
+        auto stats = clientManager.commitStats();
+        check(stats.phase(tell::db::CommitPhase::Total).count() == 1, "wrong number of recorded commits");
+        check(stats.phase(tell::db::CommitPhase::WriteBack).count() == 1, "write back phase not recorded");
+        check(stats.undoLogChunks == 1, "wrong number of undo log chunks");
+    }
+    // Repeated reads of a tuple are served from the transaction's cache
+    {
+        auto before = clientManager.metrics();
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            tx.get(tid, tell::db::key_t{7}).get();
+            tx.get(tid, tell::db::key_t{7}).get();
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+        auto after = clientManager.metrics();
+        check(after[tell::db::Metric::RemoteGets] - before[tell::db::Metric::RemoteGets] == 1, "wrong remote gets");
+        check(after[tell::db::Metric::TableCacheHits] - before[tell::db::Metric::TableCacheHits] == 1,
+                "wrong cache hits");
+        check(!after.toString().empty(), "empty metrics export");
+    }
+    // Sampled transactions write their requests to the timeline
+    {
+        auto timelinePath = "local_test.timeline.json";
+        clientManager.startTimeline(timelinePath);
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            tx.get(tid, tell::db::key_t{8}).get();
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+        clientManager.stopTimeline();
+
+        std::ifstream in(timelinePath);
+        std::string timeline((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        check(timeline.find("\"name\":\"get\"") != std::string::npos, "get missing in timeline");
+        check(timeline.find("\"name\":\"commit\"") != std::string::npos, "commit missing in timeline");
+        check(timeline.size() > 2 && timeline.compare(timeline.size() - 2, 2, "]\n") == 0, "timeline not closed");
+        std::remove(timelinePath);
+    }
+    // Named transactions are recorded per name, conflicts escaping the transaction are retried
+    {
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            tx.get(tid, tell::db::key_t{9}).get();
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction("read", transaction);
+        fiber.wait();
+        int attempts = 0;
+        auto failing = [&attempts](tell::db::Transaction& tx) {
+            if (++attempts < 3) {
+                throw tell::db::Conflict(tell::db::key_t{9});
+            }
+            tx.commit();
+        };
+        auto retried = clientManager.startTransaction("retried", failing, tell::store::TransactionType::READ_WRITE, -1,
+                5);
+        retried.wait();
+
+        auto stats = clientManager.transactionStats();
+        check(stats.types.size() == 2, "wrong number of transaction types");
+        auto& read = stats.types["read"];
+        check(read.committed == 1 && read.aborted == 0, "wrong outcome of named transaction");
+        check(read.latency.count() == 1 && read.execution.count() == 1, "named transaction not recorded");
+        auto& retry = stats.types["retried"];
+        check(retry.committed == 1 && retry.aborted == 2, "wrong number of aborted attempts");
+        check(retry.retries.count() == 1 && retry.retries.percentile(100) == 2, "wrong number of retries");
+        check(stats.throughput("read") > 0.0, "no throughput");
+    }
+    // Entries violating a unique index show up in the conflict report
+    {
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("idx_table").get();
+            tx.insert(tid, tell::db::key_t{2000}, {{ {"field", int32_t(5)} }});
+            try {
+                tx.commit();
+            } catch (tell::db::IndexConflict&) {
+                tx.rollback();
+            }
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+
+        auto report = clientManager.conflictReport();
+        check(report.tables["idx_table"].conflicts == 1, "index conflict not counted");
+        check(report.tables["idx_table"].writes > 0, "writes not counted");
+        auto found = std::find_if(report.keys.begin(), report.keys.end(), [](const tell::db::ContendedKey& key) {
+            return key.table == "idx_table" && key.index == "idx" && key.key == "(5)";
+        });
+        check(found != report.keys.end(), "contended index entry missing");
+    }
+    // Aborted transactions undo the index entries they already wrote
+    {
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("idx_table").get();
+            tx.insert(tid, tell::db::key_t{2001}, {{ {"field", int32_t(-1)} }});
+            tx.insert(tid, tell::db::key_t{2002}, {{ {"field", int32_t(5)} }});
+            try {
+                tx.commit();
+            } catch (tell::db::IndexConflict&) {
+                tx.rollback();
+            }
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+        auto verify = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("idx_table").get();
+            auto iter = tx.lower_bound(tid, "idx", {tell::db::Field(int32_t(-1))});
+            check(!iter.done() && iter.key()[0].value<int32_t>() == 0, "index entry of aborted insert not undone");
+            tx.commit();
+        };
+        auto verifyFiber = clientManager.startTransaction(verify, tell::store::TransactionType::READ_ONLY);
+        verifyFiber.wait();
+    }
+    // Accounted transactions record the memory of their caches
+    {
+        clientManager.enableMemoryAccounting();
+        size_t used = 0;
+        auto transaction = [&used](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            tx.get(tid, tell::db::key_t{10}).get();
+            tx.insert(tid, tell::db::key_t{300}, {{ {"foo", int32_t(300)}, {"bar", tell::db::Field("memory")} }});
+            tx.insert(tid, tell::db::key_t{301}, {{ {"foo", int32_t(301)}, {"bar", tell::db::Field("memory")} }});
+            used = tx.memoryUsage().total();
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction("memory", transaction);
+        fiber.wait();
+        clientManager.enableMemoryAccounting(false);
+
+        auto stats = clientManager.memoryStats();
+        check(used > 0, "no memory used by the transaction");
+        check(stats.peak.count() == 1, "wrong number of accounted transactions");
+        check(stats.totals[static_cast<size_t>(tell::db::MemoryCategory::TupleCache)] > 0, "tuple cache not accounted");
+        check(stats.totals[static_cast<size_t>(tell::db::MemoryCategory::WriteSet)] > 0, "write set not accounted");
+        check(stats.totals[static_cast<size_t>(tell::db::MemoryCategory::UndoLog)] > 0, "undo log not accounted");
+        check(stats.threads.size() == 1 && stats.contextBytes() > 0, "context not accounted");
+        check(clientManager.transactionStats().types["memory"].memory.count() == 1, "memory of type not recorded");
+    }
+    // Profiled transactions record where their fiber blocked
+    {
+        clientManager.enableWaitProfiling();
+        tell::db::TransactionWaits waits;
+        auto transaction = [&waits](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            tx.get(tid, tell::db::key_t{10}).get();
+            tx.commit();
+            waits = tx.waits();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+        clientManager.enableWaitProfiling(false);
+
+        auto stats = clientManager.waitStats();
+        check(waits[tell::db::WaitSite::Get].waits > 0, "get wait not recorded");
+        check(waits[tell::db::WaitSite::Commit].waits == 1, "commit wait not recorded");
+        check(stats.site(tell::db::WaitSite::Get).count() > 0, "get wait not profiled");
+        check(stats.blocked.count() == 1 && stats.runnable.count() == 1, "wrong number of profiled transactions");
+    }
+    // Requests are counted by the storage node responsible for them
+    {
+        clientManager.enableNodeStats();
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            tx.get(tid, tell::db::key_t{10}).get();
+            tx.insert(tid, tell::db::key_t{400}, {{ {"foo", int32_t(400)}, {"bar", tell::db::Field("node")} }});
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+        clientManager.enableNodeStats(false);
+
+        auto stats = clientManager.nodeStats();
+        check(stats.nodes.size() == 1, "wrong number of storage nodes");
+        check(stats.nodes[0][tell::db::NodeOperation::Get].requests == 1, "get not counted");
+        check(stats.nodes[0][tell::db::NodeOperation::Insert].requests == 1, "insert not counted");
+        check(stats.nodes[0].bytes() > 0, "bytes not counted");
+        check(stats.loadSkew() == 1.0, "single node is skewed");
+    }
+    // Single row writes in tables without indexes skip the undo log once enabled
+    {
+        clientManager.enableUndoLogSkipping();
+        auto before = clientManager.metrics();
+        auto transaction = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            auto& tuple = tx.get(tid, tell::db::key_t{20}).get();
+            auto next = tuple;
+            next.at("foo") = int32_t(120);
+            tx.update(tid, tell::db::key_t{20}, tuple, next);
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+        clientManager.enableUndoLogSkipping(false);
+        auto after = clientManager.metrics();
+        check(after[tell::db::Metric::UndoLogsSkipped] - before[tell::db::Metric::UndoLogsSkipped] == 1,
+                "undo log not skipped");
+        check(after[tell::db::Metric::UndoLogChunks] == before[tell::db::Metric::UndoLogChunks],
+                "undo log written for a single row");
+        auto verify = [](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("foo").get();
+            check(tx.get(tid, tell::db::key_t{20}).get().at("foo").value<int32_t>() == 120, "single row not written");
+            tx.commit();
+        };
+        auto verifyFiber = clientManager.startTransaction(verify, tell::store::TransactionType::READ_ONLY);
+        verifyFiber.wait();
+    }
+    // Read-only transactions started together on a thread share their snapshot and the commit manager requests
+    {
+        auto commitManagerRequests = [&clientManager](bool batching) {
+            clientManager.enableCommitBatching(batching);
+            auto before = clientManager.metrics()[tell::db::Metric::CommitManagerRequests];
+            // Keeps the thread busy without yielding until all transactions are queued, so they start together
+            std::atomic<bool> queued(false);
+            std::vector<tell::db::TransactionFiber<void>> fibers;
+            fibers.emplace_back(clientManager.startTransaction([&queued](tell::db::Transaction& tx) {
+                while (!queued.load()) {
+                }
+                tx.commit();
+            }, tell::store::TransactionType::READ_WRITE, 0));
+            for (int32_t i = 0; i < 8; ++i) {
+                fibers.emplace_back(clientManager.startTransaction([](tell::db::Transaction& tx) {
+                    auto tid = tx.openTable("foo").get();
+                    for (int32_t j = 1; j < 5; ++j) {
+                        check(tx.get(tid, tell::db::key_t{uint64_t(j)}).get().at("bar").value<crossbow::string>()
+                                == "foobar", "wrong value read from a shared snapshot");
+                    }
+                    tx.commit();
+                }, tell::store::TransactionType::READ_ONLY, 0));
+            }
+            queued.store(true);
+            for (auto& fiber : fibers) {
+                fiber.wait();
+            }
+            clientManager.enableCommitBatching(false);
+            return clientManager.metrics()[tell::db::Metric::CommitManagerRequests] - before;
+        };
+        auto unbatched = commitManagerRequests(false);
+        auto batched = commitManagerRequests(true);
+        // 8 read-only transactions and the one keeping the thread busy
+        check(unbatched == 18, "every transaction should send its own requests");
+        check(batched > 0 && batched < unbatched, "snapshots of read-only transactions not shared");
+    }
+    // Short strings are stored inline, long ones out of line, both survive copies and the round trip to the storage
+    {
+        crossbow::string shortText("tell");
+        crossbow::string longText("a string too long to be stored within the field");
+        tell::db::Field concat(shortText);
+        concat += tell::db::Field(longText);
+        check(concat.value<crossbow::string>() == shortText + longText, "wrong concatenation");
+        auto copy = concat;
+        check(copy == concat && tell::db::Field(shortText) < concat, "wrong string comparison");
+        copy.setString(shortText);
+        check(copy.value<crossbow::string>() == shortText && copy.type() == tell::store::FieldType::TEXT,
+                "wrong string set");
+
+        auto transaction = [&shortText, &longText](tell::db::Transaction& tx) {
+            tell::store::Schema schema(tell::store::TableType::TRANSACTIONAL);
+            schema.addField(tell::store::FieldType::TEXT, "short", true);
+            schema.addField(tell::store::FieldType::TEXT, "long", true);
+            auto tid = tx.createTable("texts", schema);
+            tx.insert(tid, tell::db::key_t{1}, {{ {"short", shortText}, {"long", longText} }});
+            tx.commit();
+        };
+        auto fiber = clientManager.startTransaction(transaction);
+        fiber.wait();
+        auto verify = [&shortText, &longText](tell::db::Transaction& tx) {
+            auto tid = tx.openTable("texts").get();
+            auto& tuple = tx.get(tid, tell::db::key_t{1}).get();
+            check(tuple.at("short").value<crossbow::string>() == shortText, "wrong inline string");
+            check(tuple.at("long").value<crossbow::string>() == longText, "wrong out of line string");
+            tx.commit();
+        };
+        auto verifyFiber = clientManager.startTransaction(verify, tell::store::TransactionType::READ_ONLY);
+        verifyFiber.wait();
+    }
+    // Counters with a small batch size refill often but never hand out a key twice
+    {
+        clientManager.setCounterBatchSize(10);
+        {
+            auto fiber = clientManager.startTransaction([](tell::db::Transaction& tx) {
+                tx.createCounter("batch").next();
+                tx.commit();
+            });
+            fiber.wait();
+        }
+        auto refills = clientManager.metrics()[tell::db::Metric::CounterRefills];
+        std::vector<uint64_t> keys[2];
+        std::vector<tell::db::TransactionFiber<void>> fibers;
+        for (auto& fiberKeys : keys) {
+            fibers.emplace_back(clientManager.startTransaction([&fiberKeys](tell::db::Transaction& tx) {
+                auto counter = tx.getCounter("batch");
+                for (int i = 0; i < 50; ++i) {
+                    fiberKeys.emplace_back(counter.next());
+                }
+                tx.commit();
+            }));
+        }
+        for (auto& fiber : fibers) {
+            fiber.wait();
+        }
+        clientManager.setCounterBatchSize(0);
+
+        std::set<uint64_t> unique(keys[0].begin(), keys[0].end());
+        unique.insert(keys[1].begin(), keys[1].end());
+        check(unique.size() == 100, "counter handed out a key twice");
+        check(clientManager.metrics()[tell::db::Metric::CounterRefills] - refills >= 5, "batch size not applied");
+    }
+    // Latency histograms bound their relative error and fill in the samples an overloaded closed loop would miss
+    {
+        tell::db::LatencyHistogram histogram;
+        histogram.recordCorrected(1000, 100);
+        check(histogram.count() == 10 && histogram.min() == 100 && histogram.max() == 1000, "wrong corrected samples");
+        auto median = histogram.percentile(50);
+        check(median >= 500 && median < 500 + 500 / 16, "median outside of the error bound");
+    }
+
+    if (gErrors != 0) {
+        std::cerr << gErrors << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}